@@ -29,6 +29,9 @@ logdir="logs/logs_${logext}_${n}_${m}_$(date +%s)"
 
 mkdir -p $logdir
 
+# phase timings are written as Chrome traces and CSV next to the logs.
+export FRN_TRACE="${logdir}/trace"
+
 echo -n "starting "
 for i in $(seq 0 $(($n - 1))); do
     echo -n "$i "
@@ -8,6 +8,7 @@
 #include "frn/mult.h"
 #include "frn/network.h"
 #include "frn/shr.h"
+#include "frn/simulator.h"
 #include "frn/tcp_network.h"
 #include "frn/util.h"
 
@@ -0,0 +1,503 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "frn.h"
+#include "frn/generated.h"
+#include "frn/lib/cpu.h"
+#include "frn/lib/math/mat.h"
+#include "frn/lib/math/vec.h"
+#include "frn/lib/primitives/hash.h"
+
+// Each repetition runs a benchmark for at least this long.
+#define MIN_REPETITION_TIME 10ms
+
+#define DEFAULT_REPETITIONS 7
+#define DEFAULT_MIN_N 4
+#define DEFAULT_MAX_N 16
+
+// Number of elements processed by one call of a field benchmark.
+#define FIELD_BATCH_SIZE 1024
+
+// Number of shares processed by one call of a share benchmark.
+#define SHARE_BATCH_SIZE 64
+
+using namespace std::chrono_literals;
+
+using Mp31Element = frn::lib::math::FpElement<frn::lib::math::Mp31>;
+using Mp61Element = frn::lib::math::FpElement<frn::lib::math::Mp61>;
+using Mp127Element = frn::lib::math::FpElement<frn::lib::math::Mp127>;
+
+namespace {
+
+struct Options {
+  std::size_t repetitions = DEFAULT_REPETITIONS;
+  std::size_t min_n = DEFAULT_MIN_N;
+  std::size_t max_n = DEFAULT_MAX_N;
+  std::string filter;
+  std::string format = "table";
+  // instruction set for dispatched kernels, or empty for the default.
+  std::string cpu;
+};
+
+struct Result {
+  std::string name;
+  // number of parties, or 0 if the benchmark does not depend on it.
+  std::size_t n;
+  // operations per call and bytes processed per call.
+  std::size_t ops;
+  std::size_t bytes;
+  std::size_t iterations;
+  // time and cycles per operation, one entry per repetition.
+  std::vector<double> ns;
+  std::vector<double> cycles;
+
+  double Median(std::vector<double> values) const {
+    std::sort(values.begin(), values.end());
+    auto m = values.size() / 2;
+    return values.size() % 2 ? values[m] : (values[m - 1] + values[m]) / 2;
+  }
+
+  double NsPerOp() const { return Median(ns); }
+  double MinNsPerOp() const { return *std::min_element(ns.begin(), ns.end()); }
+  double CyclesPerOp() const { return Median(cycles); }
+
+  // bytes are per call, so divide by the time of a call.
+  double GBPerSecond() const {
+    return bytes ? bytes / (NsPerOp() * ops) : 0;
+  }
+};
+
+// Prevent the compiler from optimizing away a computed value.
+template <typename T>
+inline void Keep(const T &value) {
+  asm volatile("" : : "r"(&value) : "memory");
+}
+
+template <typename T>
+std::vector<T> RandomElements(std::size_t n, frn::lib::primitives::PRG &prg) {
+  std::vector<T> elements;
+  elements.reserve(n);
+  unsigned char buffer[sizeof(typename T::ValueType)];
+  while (elements.size() < n) {
+    prg.Next(buffer, sizeof(buffer));
+    // the constructor reduces the value, so the result is a valid element.
+    T e(*(typename T::ValueType *)buffer);
+    if (e != T::kZero) elements.emplace_back(e);
+  }
+  return elements;
+}
+
+class Runner {
+ public:
+  Runner(const Options &options) : mOptions(options){};
+
+  /**
+   * Benchmark fn, which performs ops operations on bytes bytes per call.
+   */
+  void Run(const std::string &name, std::size_t n, std::size_t ops,
+           std::size_t bytes, const std::function<void()> &fn) {
+    if (name.find(mOptions.filter) == std::string::npos) return;
+
+    // warm up, and find how many calls make up one repetition.
+    std::size_t iterations = 1;
+    while (true) {
+      auto start = std::chrono::steady_clock::now();
+      for (std::size_t i = 0; i < iterations; ++i) fn();
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      if (elapsed >= MIN_REPETITION_TIME) break;
+      iterations *= 2;
+    }
+
+    Result result{name, n, ops, bytes, iterations, {}, {}};
+    for (std::size_t r = 0; r < mOptions.repetitions; ++r) {
+      auto start = std::chrono::steady_clock::now();
+      auto start_ticks = frn::lib::tracing::Ticks();
+      for (std::size_t i = 0; i < iterations; ++i) fn();
+      auto ticks = frn::lib::tracing::Ticks() - start_ticks;
+      std::chrono::duration<double, std::nano> elapsed =
+          std::chrono::steady_clock::now() - start;
+      result.ns.emplace_back(elapsed.count() / (iterations * ops));
+      result.cycles.emplace_back((double)ticks / (iterations * ops));
+    }
+
+    if (mOptions.format == "table") PrintRow(result);
+    mResults.emplace_back(result);
+  };
+
+  bool Enabled(const std::string &group) const {
+    // a filter like "Mp61" should enable field benchmarks, and so on, so
+    // groups match in both directions.
+    return group.find(mOptions.filter) != std::string::npos ||
+           mOptions.filter.find(group) != std::string::npos ||
+           mOptions.filter.empty();
+  };
+
+  void PrintHeader() const {
+    if (mOptions.format != "table") return;
+    std::cout << std::left << std::setw(40) << "benchmark" << std::right
+              << std::setw(4) << "n" << std::setw(18) << "ns/op"
+              << std::setw(18) << "min ns/op" << std::setw(18) << "cycles/op"
+              << std::setw(12) << "GB/s"
+              << "\n";
+  };
+
+  void PrintReport() const {
+    if (mOptions.format == "csv") PrintCsv();
+    if (mOptions.format == "json") PrintJson();
+  };
+
+ private:
+  void PrintRow(const Result &r) const {
+    std::cout << std::left << std::setw(40) << r.name << std::right
+              << std::setw(4) << r.n << std::fixed << std::setprecision(2)
+              << std::setw(18) << r.NsPerOp() << std::setw(18)
+              << r.MinNsPerOp() << std::setw(18) << r.CyclesPerOp()
+              << std::setw(12) << r.GBPerSecond() << std::endl;
+  };
+
+  void PrintCsv() const {
+    std::cout << "name,n,ops,bytes,iterations,repetitions,ns_per_op,"
+                 "min_ns_per_op,cycles_per_op,gb_per_s\n";
+    for (const auto &r : mResults) {
+      std::cout << r.name << "," << r.n << "," << r.ops << "," << r.bytes
+                << "," << r.iterations << "," << r.ns.size() << ","
+                << r.NsPerOp() << "," << r.MinNsPerOp() << ","
+                << r.CyclesPerOp() << "," << r.GBPerSecond() << "\n";
+    }
+  };
+
+  void PrintJson() const {
+    std::cout << "{\"repetitions\": " << mOptions.repetitions
+              << ", \"benchmarks\": [";
+    for (std::size_t i = 0; i < mResults.size(); ++i) {
+      const auto &r = mResults[i];
+      std::cout << (i ? ",\n  " : "\n  ") << "{\"name\": \"" << r.name
+                << "\", \"n\": " << r.n << ", \"ops\": " << r.ops
+                << ", \"bytes\": " << r.bytes
+                << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << r.NsPerOp()
+                << ", \"min_ns_per_op\": " << r.MinNsPerOp()
+                << ", \"cycles_per_op\": " << r.CyclesPerOp()
+                << ", \"gb_per_s\": " << r.GBPerSecond() << ", \"samples\": [";
+      for (std::size_t j = 0; j < r.ns.size(); ++j)
+        std::cout << (j ? ", " : "") << r.ns[j];
+      std::cout << "]}";
+    }
+    std::cout << "\n]}\n";
+  };
+
+  Options mOptions;
+  std::vector<Result> mResults;
+};
+
+template <typename T>
+void BenchmarkField(Runner &runner, const std::string &prefix) {
+  if (!runner.Enabled(prefix)) return;
+
+  frn::lib::primitives::PRG prg;
+  const auto xs = RandomElements<T>(FIELD_BATCH_SIZE, prg);
+  const auto ys = RandomElements<T>(FIELD_BATCH_SIZE, prg);
+  const std::size_t bytes = FIELD_BATCH_SIZE * T::ByteSize();
+
+  runner.Run(prefix + "::Add", 0, FIELD_BATCH_SIZE, bytes, [&]() {
+    T acc = T::kZero;
+    for (const auto &x : xs) acc += x;
+    Keep(acc);
+  });
+
+  runner.Run(prefix + "::Multiply", 0, FIELD_BATCH_SIZE, bytes, [&]() {
+    T acc = T::kOne;
+    for (const auto &x : xs) acc *= x;
+    Keep(acc);
+  });
+
+  runner.Run(prefix + "::Inverse", 0, FIELD_BATCH_SIZE, bytes, [&]() {
+    for (const auto &x : xs) Keep(x.Inverse());
+  });
+
+  runner.Run(prefix + "::InverseConstantTime", 0, FIELD_BATCH_SIZE, bytes,
+             [&]() {
+               for (const auto &x : xs) Keep(x.InverseConstantTime());
+             });
+
+  runner.Run(prefix + "::BatchInvert", 0, FIELD_BATCH_SIZE, bytes, [&]() {
+    Keep(frn::lib::math::vector::BatchInvert(xs));
+  });
+
+  runner.Run(prefix + "::Sum", 0, FIELD_BATCH_SIZE, bytes, [&]() {
+    Keep(frn::lib::math::vector::Sum(xs));
+  });
+
+  runner.Run(prefix + "::Dot", 0, FIELD_BATCH_SIZE, 2 * bytes, [&]() {
+    Keep(frn::lib::math::vector::Dot(xs, ys));
+  });
+
+  auto zs = xs;
+  runner.Run(prefix + "::MultiplyInto", 0, FIELD_BATCH_SIZE, 2 * bytes, [&]() {
+    frn::lib::math::vector::MultiplyInto(zs, ys);
+    Keep(zs);
+  });
+
+  std::vector<unsigned char> packed(
+      frn::lib::math::vector::PackedByteSize<T>(FIELD_BATCH_SIZE));
+  runner.Run(prefix + "::ToPackedBytes", 0, FIELD_BATCH_SIZE, bytes, [&]() {
+    frn::lib::math::vector::ToPackedBytes(packed.data(), xs);
+    Keep(packed);
+  });
+
+  runner.Run(prefix + "::FromPackedBytes", 0, FIELD_BATCH_SIZE, bytes, [&]() {
+    Keep(frn::lib::math::vector::FromPackedBytes<T>(packed.data(),
+                                                     FIELD_BATCH_SIZE));
+  });
+
+  // one operation is a multiplication of the product.
+  const std::size_t dim = 128;
+  frn::lib::math::Matrix<T> a(dim, dim), b(dim, dim);
+  for (std::size_t i = 0; i < dim * dim; i++) {
+    a(i / dim, i % dim) = xs[i % FIELD_BATCH_SIZE];
+    b(i / dim, i % dim) = ys[(7 * i) % FIELD_BATCH_SIZE];
+  }
+  runner.Run(prefix + "::MatMul/" + std::to_string(dim), 0, dim * dim * dim,
+             3 * dim * dim * T::ByteSize(), [&]() { Keep(a.MatMul(b)); });
+}
+
+void BenchmarkPRG(Runner &runner) {
+  if (!runner.Enabled("PRG")) return;
+
+  frn::lib::primitives::PRG prg;
+  for (std::size_t size : {16, 256, 4096, 65536, 1 << 20}) {
+    std::vector<unsigned char> buffer(size);
+    runner.Run("PRG::Next/" + std::to_string(size), 0, 1, size, [&]() {
+      prg.Next(buffer);
+      Keep(buffer);
+    });
+  }
+  for (std::size_t n : {1, 256, 65536}) {
+    std::vector<frn::Field> elements(n);
+    runner.Run("PRG::NextFields/" + std::to_string(n), 0, n,
+               n * frn::Field::ByteSize(), [&]() {
+                 prg.NextFields(elements);
+                 Keep(elements);
+               });
+  }
+}
+
+void BenchmarkHash(Runner &runner) {
+  if (!runner.Enabled("SHA3_256")) return;
+
+  for (std::size_t size : {32, 1024, 65536, 1 << 20}) {
+    std::vector<unsigned char> buffer(size, 0x5a);
+    runner.Run("SHA3_256/" + std::to_string(size), 0, 1, size, [&]() {
+      frn::lib::primitives::Hash<frn::lib::primitives::SHA3_256> hash;
+      hash.Update(buffer);
+      Keep(hash.Finalize());
+    });
+  }
+}
+
+template <std::size_t N>
+void BenchmarkFixed(Runner &runner, const std::vector<frn::Shr> &as,
+                    const std::vector<frn::Shr> &bs, std::size_t share_bytes) {
+  using Protocol = frn::FixedProtocol<N, (N - 1) / 3, 0>;
+  std::vector<typename Protocol::Share> fixed_as, fixed_bs;
+  for (std::size_t i = 0; i < SHARE_BATCH_SIZE; ++i) {
+    fixed_as.emplace_back(Protocol::FromShr(as[i]));
+    fixed_bs.emplace_back(Protocol::FromShr(bs[i]));
+  }
+  runner.Run("FixedProtocol::MultiplyToDoubleDegree", N, SHARE_BATCH_SIZE,
+             2 * SHARE_BATCH_SIZE * share_bytes, [&]() {
+               for (std::size_t i = 0; i < SHARE_BATCH_SIZE; ++i)
+                 Keep(Protocol::MultiplyToDoubleDegree(fixed_as[i],
+                                                       fixed_bs[i]));
+             });
+}
+
+void BenchmarkShares(Runner &runner, std::size_t n) {
+  const std::size_t t = (n - 1) / 3;
+  auto replicator = frn::CreateReplicator(n);
+  frn::lib::primitives::PRG prg;
+  const auto secrets = RandomElements<frn::Field>(SHARE_BATCH_SIZE, prg);
+  const std::size_t share_bytes = replicator.ShareSizeBytes();
+
+  if (runner.Enabled("Replicator")) {
+    runner.Run("Replicator::Share", n, SHARE_BATCH_SIZE,
+               SHARE_BATCH_SIZE * n * share_bytes, [&]() {
+                 for (const auto &secret : secrets)
+                   Keep(replicator.Share(secret, prg));
+               });
+
+    const auto shares = replicator.Share(secrets[0], prg);
+    runner.Run("Replicator::Reconstruct", n, 1, n * share_bytes,
+               [&]() { Keep(replicator.Reconstruct(shares)); });
+  }
+
+  if (runner.Enabled("ShrManipulator")) {
+    // Init is called by the constructor.
+    runner.Run("ShrManipulator::Init", n, 1, 0, [&]() {
+      frn::ShrManipulator manipulator(0, t, n);
+      Keep(manipulator);
+    });
+
+    frn::ShrManipulator manipulator(0, t, n);
+    std::vector<frn::Shr> as, bs;
+    for (const auto &secret : secrets) {
+      as.emplace_back(replicator.Share(secret, prg)[0]);
+      bs.emplace_back(replicator.Share(secret, prg)[0]);
+    }
+    runner.Run("ShrManipulator::MultiplyToDoubleDegree", n, SHARE_BATCH_SIZE,
+               2 * SHARE_BATCH_SIZE * share_bytes, [&]() {
+                 for (std::size_t i = 0; i < SHARE_BATCH_SIZE; ++i)
+                   Keep(manipulator.MultiplyToDoubleDegree(as[i], bs[i]));
+               });
+
+    const frn::ShareBatch batch_a(manipulator.ShareSize(), as);
+    const frn::ShareBatch batch_b(manipulator.ShareSize(), bs);
+    runner.Run("ShrManipulator::MultiplyToDoubleDegree/batch", n,
+               SHARE_BATCH_SIZE, 2 * SHARE_BATCH_SIZE * share_bytes, [&]() {
+                 Keep(manipulator.MultiplyToDoubleDegree(batch_a, batch_b));
+               });
+    runner.Run("ShrManipulator::Square", n, SHARE_BATCH_SIZE,
+               SHARE_BATCH_SIZE * share_bytes, [&]() {
+                 for (std::size_t i = 0; i < SHARE_BATCH_SIZE; ++i)
+                   Keep(manipulator.Square(as[i]));
+               });
+    runner.Run("ShrManipulator::MultiplyToMsgs/batch", n, SHARE_BATCH_SIZE,
+               2 * SHARE_BATCH_SIZE * share_bytes, [&]() {
+                 Keep(manipulator.MultiplyToMsgs(batch_a, batch_b));
+               });
+    runner.Run("ShrManipulator::SquareToMsgs/batch", n, SHARE_BATCH_SIZE,
+               SHARE_BATCH_SIZE * share_bytes,
+               [&]() { Keep(manipulator.SquareToMsgs(batch_a)); });
+    runner.Run("ShrManipulator::DotProductToMsgs/batch", n, SHARE_BATCH_SIZE,
+               2 * SHARE_BATCH_SIZE * share_bytes, [&]() {
+                 Keep(manipulator.DotProductToMsgs(batch_a, batch_b));
+               });
+    std::vector<frn::Shr> long_as, long_bs;
+    for (std::size_t i = 0; i < 1024; i++) {
+      long_as.emplace_back(as[i % SHARE_BATCH_SIZE]);
+      long_bs.emplace_back(bs[i % SHARE_BATCH_SIZE]);
+    }
+    const frn::ShareBatch long_a(manipulator.ShareSize(), long_as);
+    const frn::ShareBatch long_b(manipulator.ShareSize(), long_bs);
+    runner.Run("ShrManipulator::DotProductToMsgs/1024", n, 1024,
+               2 * 1024 * share_bytes, [&]() {
+                 Keep(manipulator.DotProductToMsgs(long_a, long_b));
+               });
+    // products of 32 x 32 matrices, against 32^3 products of shares.
+    runner.Run("ShrManipulator::MatMulToMsgs/32", n, 32 * 32 * 32,
+               2 * 32 * 32 * share_bytes, [&]() {
+                 Keep(manipulator.MatMulToMsgs(long_a, long_b, 32, 32, 32));
+               });
+  }
+
+  if (runner.Enabled("FixedProtocol")) {
+    std::vector<frn::Shr> as, bs;
+    for (const auto &secret : secrets) {
+      as.emplace_back(replicator.Share(secret, prg)[0]);
+      bs.emplace_back(replicator.Share(secret, prg)[0]);
+    }
+    // instances only exist for some n.
+    if (n == 4) BenchmarkFixed<4>(runner, as, bs, share_bytes);
+    if (n == 7) BenchmarkFixed<7>(runner, as, bs, share_bytes);
+    if (n == 10) BenchmarkFixed<10>(runner, as, bs, share_bytes);
+  }
+
+  if (runner.Enabled("MultiplyKernel")) {
+    const auto a = replicator.Share(secrets[0], prg)[0];
+    const auto b = replicator.Share(secrets[1], prg)[0];
+    std::vector<frn::Shr> msgs(
+        2 * t + 1, frn::Shr(frn::lib::secret_sharing::Binom(n - 1, 2 * t)));
+    frn::Field add_share;
+    for (const auto &[name, kernel] :
+         {std::make_pair("generated", frn::FindGeneratedMultiplyKernel(n, t, 0)),
+          std::make_pair("fixed", frn::FindFixedMultiplyKernel(n, t, 0))}) {
+      if (!kernel) continue;
+      runner.Run(std::string("MultiplyKernel/") + name, n, 1, 2 * share_bytes,
+                 [&]() {
+                   kernel(a, b, add_share, msgs);
+                   Keep(add_share);
+                 });
+    }
+  }
+
+  if (runner.Enabled("Correlator")) {
+    frn::Correlator correlator(0, replicator);
+    runner.Run("Correlator::GenRandomShare", n, 1, 0,
+               [&]() { Keep(correlator.GenRandomShare()); });
+    runner.Run("Correlator::GenRandomShares/256", n, 256, 0,
+               [&]() { Keep(correlator.GenRandomShares(256)); });
+  }
+}
+
+void Usage(const char *name) {
+  std::cout << "usage: " << name
+            << " [--reps R] [--min-n N] [--max-n N] [--filter STRING]"
+               " [--format table|csv|json]"
+               " [--cpu generic|sse4.2|avx2|avx512]\n";
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (i + 1 == argc || arg.rfind("--", 0) != 0) {
+      Usage(argv[0]);
+      return 1;
+    }
+    std::string value = argv[++i];
+    if (arg == "--reps")
+      options.repetitions = std::stoul(value);
+    else if (arg == "--min-n")
+      options.min_n = std::stoul(value);
+    else if (arg == "--max-n")
+      options.max_n = std::stoul(value);
+    else if (arg == "--filter")
+      options.filter = value;
+    else if (arg == "--format")
+      options.format = value;
+    else if (arg == "--cpu")
+      options.cpu = value;
+    else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (options.repetitions == 0 || options.min_n < 4 ||
+      options.max_n < options.min_n ||
+      (options.format != "table" && options.format != "csv" &&
+       options.format != "json")) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  if (!options.cpu.empty()) {
+    const auto requested = frn::lib::cpu::ParseLevel(options.cpu);
+    if (frn::lib::cpu::Override(requested) != requested)
+      std::cerr << "warning: " << options.cpu
+                << " is not supported by this CPU\n";
+  }
+  std::cerr << "cpu: " << frn::lib::cpu::ToString(frn::lib::cpu::Current())
+            << "\n";
+
+  Runner runner(options);
+  runner.PrintHeader();
+
+  BenchmarkField<Mp31Element>(runner, "Mp31");
+  BenchmarkField<Mp61Element>(runner, "Mp61");
+  BenchmarkField<Mp127Element>(runner, "Mp127");
+  BenchmarkPRG(runner);
+  BenchmarkHash(runner);
+  for (std::size_t n = options.min_n; n <= options.max_n; ++n)
+    BenchmarkShares(runner, n);
+
+  runner.PrintReport();
+}
@@ -1,9 +1,12 @@
 #ifndef CHECK_H
 #define CHECK_H
 
+#include <array>
 #include <memory>
+#include <type_traits>
 
 #include "frn/corr.h"
+#include "frn/lib/math/kernels.h"
 #include "frn/lib/primitives/hash.h"
 #include "frn/lib/primitives/prg.h"
 #include "frn/mult.h"
@@ -12,38 +15,106 @@
 
 namespace frn {
 
-struct CompressedCheckData {
+namespace details {
+
+/**
+ * @brief Whether E is T, or an extension of T which the check can draw its
+ * coefficients from.
+ */
+template <typename E, typename T, typename = void>
+struct IsExtensionOf : std::is_same<E, T> {};
+
+template <typename E, typename T>
+struct IsExtensionOf<E, T, std::void_t<typename E::BaseType>>
+    : std::bool_constant<std::is_same_v<E, T> ||
+                         std::is_same_v<typename E::BaseType, T>> {};
+
+/**
+ * @brief \f$c \cdot x\f$ for a coefficient \f$c \in E\f$ and
+ * \f$x \in T\f$.
+ *
+ * An element of T is a constant of E, so the product is computed coefficient
+ * by coefficient with <code>E::Degree()</code> multiplications in T, rather
+ * than as a product in E.
+ */
+template <typename E, typename T>
+E Scale(const E& c, const T& x) {
+  if constexpr (std::is_same_v<E, T>) {
+    return c * x;
+  } else {
+    std::array<T, E::Degree()> r;
+    for (std::size_t i = 0; i < E::Degree(); i++) r[i] = c[i] * x;
+    return E(r);
+  }
+}
+
+/**
+ * @brief \f$\sum_{i < n} x_i \cdot y_i\f$.
+ */
+template <typename T>
+T Dot(const T* x, const T* y, std::size_t n) {
+  if constexpr (kUsesKernels<T>) {
+    return T(frn::lib::math::vector::details::Kernels<T>().dot(
+        Values(x), Values(y), n));
+  } else {
+    T r;
+    for (std::size_t i = 0; i < n; i++) r += x[i] * y[i];
+    return r;
+  }
+}
+
+}  // namespace details
+
+template <typename E>
+struct BasicCompressedCheckData {
   // The shares the given party sent to P1 across the
   // multiplications
-  Field shares_sent_to_p1;
+  E shares_sent_to_p1;
   // For each party, the shares P1 received across all
   // multiplications
-  std::vector<Field> shares_recv_by_p1;
+  std::vector<E> shares_recv_by_p1;
   // Reconstructions received from P1
-  Field values_recv_from_p1;
+  E values_recv_from_p1;
   // For each party, rep share of msg^i
-  std::vector<Shr> msgs;
+  std::vector<std::vector<E>> msgs;
 
-  CompressedCheckData(ShrManipulator m)
-      : shares_sent_to_p1(0), values_recv_from_p1(0) {
+  template <typename T>
+  BasicCompressedCheckData(const BasicShrManipulator<T>& m) {
     shares_recv_by_p1.resize(2 * m.GetReplicator().Threshold() + 1);
     // Initialize msgs to zero shares so that we can use them as accumulators
     msgs.resize(2 * m.GetReplicator().Threshold() + 1,
-                Shr(m.GetDoubleReplicator().ShareSize(), Field(0)));
+                std::vector<E>(m.GetDoubleReplicator().ShareSize()));
   }
 };
 
+using CompressedCheckData = BasicCompressedCheckData<Field>;
+
 /**
  * @brief The inteface of the Check protocol.
+ *
+ * The multiplications are compressed by a random linear combination whose
+ * coefficients are drawn from E. Over a small ring, E should be an
+ * extension of T, e.g., a GaloisRingElement over Z2kElement, so that a
+ * combination of wrong products is zero only with small probability.
+ *
+ * @tparam T the ring of the shares.
+ * @tparam E the ring of the coefficients, which is T or an extension of T.
  */
-class Check {
+template <typename T, typename E = T>
+class BasicCheck {
+  static_assert(details::IsExtensionOf<E, T>::value,
+                "the coefficients must be in T or an extension of T.");
+
  public:
+  using CheckData = BasicCheckData<T>;
+  using CompressedCheckData = BasicCompressedCheckData<E>;
+
   /**
    * @brief Create a new mult protocol instance.
    */
-  Check(std::shared_ptr<Network> network,
-        const frn::lib::secret_sharing::Replicator<Field>& replicator,
-        const ShrManipulator& manipulator, CheckData& cd)
+  BasicCheck(std::shared_ptr<Network> network,
+             const frn::lib::secret_sharing::Replicator<T>& replicator,
+             const BasicShrManipulator<T>& manipulator, CheckData& cd)
       : mNetwork(network),
         mReplicator(replicator),
         mId(network->Id()),
@@ -62,59 +133,85 @@ class Check {
   void SetupPRG();
 
   void ComputeRandomCoefficients() {
-    START_TIMER(RandCoeff);
-    Field coeff;
-    unsigned char buf[Field::ByteSize()];
-
-    for (unsigned mult_idx = 0; mult_idx < mCheckData.counter; mult_idx++) {
-      mPRG.Next(buf, Field::ByteSize());
-      coeff = Field::FromBytes(buf);
-      mRandomCoefficients.emplace_back(coeff);
-    }
-    STOP_TIMER(RandCoeff);
+    TRACE_SPAN("Check::ComputeRandomCoefficients");
+    TRACE_COUNT(eElements, mCheckData.counter);
+    const auto offset = mRandomCoefficients.size();
+    mRandomCoefficients.resize(offset + mCheckData.counter);
+    mPRG.NextUniform(mRandomCoefficients.data() + offset, mCheckData.counter);
   };
 
   // At the end of this call: Pi for 0<i<2d+1 populate the
   // compressed shares_sent_to_p1 and values_recv_from_p1, while P0
   // populates the compressed shares_recv_by_p1
   void PrepareLinearCombinations() {
-    START_TIMER(LinearComb);
+    TRACE_SPAN("Check::PrepareLinearCombinations");
 
     // this assumes 2d+1 = n-d <> n=3d+1 (so U=T)
     if ((0 < mId) && (mId < 2 * mThreshold - 1)) {
       for (unsigned mult_idx = 0; mult_idx < mCheckData.counter; mult_idx++) {
 
         mCompressedCD.shares_sent_to_p1 +=
-            mRandomCoefficients[mult_idx] * mCheckData.shares_sent_to_p1[mult_idx];
+            details::Scale(mRandomCoefficients[mult_idx],
+                           mCheckData.shares_sent_to_p1[mult_idx]);
         mCompressedCD.values_recv_from_p1 +=
-            mRandomCoefficients[mult_idx] * mCheckData.values_recv_from_p1[mult_idx];
+            details::Scale(mRandomCoefficients[mult_idx],
+                           mCheckData.values_recv_from_p1[mult_idx]);
       }
     }
     else if (mId == 0) {
       for (unsigned mult_idx = 0; mult_idx < mCheckData.counter; mult_idx++) {
         for (unsigned party_idx = 0; party_idx < 2 * mThreshold + 1;
              party_idx++) {
-          mCompressedCD.shares_recv_by_p1[party_idx] +=
-              mRandomCoefficients[mult_idx] * mCheckData.shares_recv_by_p1[party_idx][mult_idx];
+          mCompressedCD.shares_recv_by_p1[party_idx] += details::Scale(
+              mRandomCoefficients[mult_idx],
+              mCheckData.shares_recv_by_p1[party_idx][mult_idx]);
         }
       }
     }
-    STOP_TIMER(LinearComb);
   };
 
   // Omitted for now
   void AgreeOnTranscript();
 
   void PrepareMsgs() {
-    START_TIMER(PrepareMsgs);
+    TRACE_SPAN("Check::PrepareMsgs");
     // Compress msgs
     for (unsigned mult_idx = 0; mult_idx < mCheckData.counter; mult_idx++) {
+      // the messages of matrix products are compressed below.
+      if (mCheckData.msgs[mult_idx].empty()) continue;
       for (unsigned party_idx = 0; party_idx < 2 * mThreshold + 1;
            party_idx++) {
-        Shr shr = mManipulator.MultiplyConstant(mRandomCoefficients[mult_idx],
-                                          mCheckData.msgs[mult_idx][party_idx]);
-        mCompressedCD.msgs[party_idx] =
-            mManipulator.Add(mCompressedCD.msgs[party_idx], shr);
+        const auto& msg = mCheckData.msgs[mult_idx][party_idx];
+        for (std::size_t c = 0; c < msg.size(); c++)
+          mCompressedCD.msgs[party_idx][c] +=
+              details::Scale(mRandomCoefficients[mult_idx], msg[c]);
+      }
+    }
+
+    // Each message of a batch is combined with the coefficients of its
+    // mults by an inner product, or, for coefficients in an extension, by
+    // one inner product per coefficient of the extension.
+    const auto double_size = mManipulator.GetDoubleReplicator().ShareSize();
+    for (const auto& batch : mCheckData.msg_batches) {
+      const auto n = batch.msgs.Size();
+      const auto* coefficients = mRandomCoefficients.data() + batch.offset;
+      if constexpr (std::is_same_v<E, T>) {
+        for (std::size_t m = 0; m < (2 * mThreshold + 1) * double_size; m++)
+          mCompressedCD.msgs[m / double_size][m % double_size] +=
+              details::Dot(coefficients, batch.msgs.Column(m), n);
+      } else {
+        constexpr auto kDegree = E::Degree();
+        std::vector<T> columns(kDegree * n);
+        for (std::size_t k = 0; k < n; k++)
+          for (std::size_t i = 0; i < kDegree; i++)
+            columns[i * n + k] = coefficients[k][i];
+        for (std::size_t m = 0; m < (2 * mThreshold + 1) * double_size; m++) {
+          std::array<T, kDegree> r;
+          for (std::size_t i = 0; i < kDegree; i++)
+            r[i] = details::Dot(columns.data() + i * n, batch.msgs.Column(m),
+                                n);
+          mCompressedCD.msgs[m / double_size][m % double_size] += E(r);
+        }
       }
     }
 
@@ -126,7 +223,7 @@ class Check {
       // VALUES to send
       if (TableRec[shr_id].value_or_hash == VALUE) {
         for (unsigned recv_idx : TableRec[shr_id].party_set) {
-          std::vector<Field> batched_add_share;
+          std::vector<E> batched_add_share;
           for (unsigned i = 0; i < 2 * mThreshold + 1; i++) {
             batched_add_share.emplace_back(mCompressedCD.msgs[i][shr_id]);
           }
@@ -141,22 +238,21 @@ class Check {
       // elements
       else if (TableRec[shr_id].value_or_hash == HASH) {
         for (unsigned recv_idx : TableRec[shr_id].party_set) {
-          std::vector<Field> batched_add_share;
-          Field hash;
+          std::vector<E> batched_add_share;
+          E hash;
           for (unsigned i = 0; i < 2 * mThreshold + 1; i++) {
             batched_add_share.emplace_back(mCompressedCD.msgs[i][shr_id]);
           }
           // Here: compute hash of batched_add_share
-          hash = Field(0);
+          hash = E();
           mDigestsToSend[recv_idx].emplace_back(hash);
         }
       }
     }
-    STOP_TIMER(PrepareMsgs);
   };
 
   void ReconstructMsgs() {
-    START_TIMER(ReconstructMsgs);
+    TRACE_SPAN("Check::ReconstructMsgs");
     std::vector<unsigned char> buffer(4);
     for (std::size_t recv_id = 0; recv_id < mSize; ++recv_id) {
       // Send length
@@ -165,7 +261,7 @@ class Check {
       mNetwork->SendBytes(recv_id, buffer);
 
       // Send values
-      mNetwork->Send(recv_id, mValuesToSend[recv_id]);
+      mNetwork->SendValues(recv_id, mValuesToSend[recv_id]);
 
       // Send length
       size = mDigestsToSend[recv_id].size();
@@ -173,7 +269,7 @@ class Check {
       mNetwork->SendBytes(recv_id, buffer);
 
       // Send hashes
-      mNetwork->Send(recv_id, mDigestsToSend[recv_id]);
+      mNetwork->SendValues(recv_id, mDigestsToSend[recv_id]);
     }
 
     for (std::size_t sender_id = 0; sender_id < mSize; ++sender_id) {
@@ -181,38 +277,56 @@ class Check {
       std::uint32_t size;
       size = *(std::uint32_t*)mNetwork->RecvBytes(sender_id, 4).data();
       // Receive values
-      mNetwork->Recv(sender_id, size);
+      mValuesReceived[sender_id] = mNetwork->RecvValues<E>(sender_id, size);
 
       // Receive length
       size = *(std::uint32_t*)mNetwork->RecvBytes(sender_id, 4).data();
       // Receive hashes
-      mNetwork->Recv(sender_id, size);
+      mDigestsReceived[sender_id] = mNetwork->RecvValues<E>(sender_id, size);
     }
-    STOP_TIMER(ReconstructMsgs);
+  };
+
+  /**
+   * @brief The coefficients of the random linear combination.
+   */
+  const std::vector<E>& GetRandomCoefficients() const {
+    return mRandomCoefficients;
+  };
+
+  /**
+   * @brief The multiplications compressed by the random linear combination.
+   */
+  const CompressedCheckData& GetCompressedCheckData() const {
+    return mCompressedCD;
   };
 
  private:
   std::shared_ptr<Network> mNetwork;
-  frn::lib::secret_sharing::Replicator<Field> mReplicator;
+  frn::lib::secret_sharing::Replicator<T> mReplicator;
   unsigned mId;
   std::size_t mThreshold;
   std::size_t mSize;
-  ShrManipulator mManipulator;
+  BasicShrManipulator<T> mManipulator;
 
   std::size_t mCount;
   CheckData mCheckData;
   // Used for sampling random values for the check
   // TODO protocol for obtaining it
   frn::lib::primitives::PRG mPRG;
-  std::vector<Field> mRandomCoefficients;
+  std::vector<E> mRandomCoefficients;
   CompressedCheckData mCompressedCD;
 
-  std::vector<std::vector<Field>> mValuesToSend;
-  std::vector<std::vector<Field>> mDigestsToSend;
-  std::vector<std::vector<Field>> mValuesReceived;
-  std::vector<std::vector<Field>> mDigestsReceived;
+  std::vector<std::vector<E>> mValuesToSend;
+  std::vector<std::vector<E>> mDigestsToSend;
+  std::vector<std::vector<E>> mValuesReceived;
+  std::vector<std::vector<E>> mDigestsReceived;
 };
 
+/**
+ * @brief The Check protocol over Field.
+ */
+using Check = BasicCheck<Field>;
+
 }  // namespace frn
 
 #endif  // CHECK_H
@@ -0,0 +1,106 @@
+#include "frn/codegen.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "frn/shr.h"
+
+// Most b's summed before a multiplication, such that the sum of reduced values
+// fits in 64 bits.
+#define MAX_FACTOR_TERMS 7
+
+namespace {
+
+// b indices multiplied with each a index, for one element of a message.
+using Group = std::map<unsigned, std::vector<unsigned>>;
+
+void write_sum(std::ostream& os, const std::vector<unsigned>& bs,
+               std::size_t begin, std::size_t end) {
+  for (auto k = begin; k < end; k++) {
+    if (k > begin) os << " + ";
+    os << "b" << bs[k];
+  }
+}
+
+}  // namespace
+
+void frn::WriteMultiplyKernel(std::ostream& os, std::size_t n, std::size_t id) {
+  const std::size_t t = (n - 1) / 3;
+  const std::size_t senders = 2 * t + 1;
+  ShrManipulator manipulator(id, t, n);
+  const auto double_share_size =
+      manipulator.GetDoubleReplicator().ShareSize();
+
+  // groups[first_party][dest]
+  std::vector<std::vector<Group>> groups(senders,
+                                         std::vector<Group>(double_share_size));
+  std::set<unsigned> used_a, used_b;
+  for (const auto& entry : manipulator.GetTableMult()) {
+    groups[entry.first_party][entry.dest_c][entry.src_a].emplace_back(
+        entry.src_b);
+    used_a.insert(entry.src_a);
+    used_b.insert(entry.src_b);
+  }
+
+  os << "// n = " << n << ", t = " << t << ", party " << id << ".\n";
+  os << "static void mult_" << n << "_" << id
+     << "(const frn::Shr& a, const frn::Shr& b, frn::Field& add_share,\n"
+     << "    std::vector<frn::Shr>& msgs) {\n";
+  os << "  using namespace frn::generated;\n";
+  for (auto i : used_a)
+    os << "  const u64 a" << i << " = a[" << i << "].Value();\n";
+  for (auto j : used_b)
+    os << "  const u64 b" << j << " = b[" << j << "].Value();\n";
+  os << "  u128 acc;\n";
+
+  for (std::size_t party = 0; party < senders; party++) {
+    for (std::size_t dest = 0; dest < double_share_size; dest++) {
+      const auto& group = groups[party][dest];
+      const std::string msg =
+          "msgs[" + std::to_string(party) + "][" + std::to_string(dest) + "]";
+      if (group.empty()) {
+        os << "  " << msg << " = frn::Field();\n";
+        continue;
+      }
+      bool first = true;
+      for (const auto& [i, bs] : group) {
+        for (std::size_t k = 0; k < bs.size(); k += MAX_FACTOR_TERMS) {
+          os << (first ? "  acc = " : "  acc += ") << "MulFold(a" << i << ", ";
+          write_sum(os, bs, k, std::min(bs.size(), k + MAX_FACTOR_TERMS));
+          os << ");\n";
+          first = false;
+        }
+      }
+      os << "  " << msg << " = Reduce(acc);\n";
+    }
+  }
+
+  os << "  add_share = frn::Field();\n";
+  if (id < senders)
+    os << "  for (const auto& v : msgs[" << id << "]) add_share += v;\n";
+  os << "}\n\n";
+}
+
+void frn::WriteMultiplyKernels(std::ostream& os,
+                               const std::vector<std::size_t>& parties) {
+  os << "// Generated by gen.x. Do not edit.\n\n"
+     << "#include \"frn/generated.h\"\n\n";
+  for (auto n : parties)
+    for (std::size_t id = 0; id < n; id++) WriteMultiplyKernel(os, n, id);
+
+  for (auto n : parties) {
+    os << "static const frn::FixedMultiplyKernel kernels_" << n << "[] = {";
+    for (std::size_t id = 0; id < n; id++)
+      os << (id ? ", " : "") << "mult_" << n << "_" << id;
+    os << "};\n\n";
+  }
+
+  os << "frn::FixedMultiplyKernel frn::FindGeneratedMultiplyKernel(\n"
+     << "    std::size_t n, std::size_t t, std::size_t id) {\n"
+     << "  if (t != (n - 1) / 3 || id >= n) return nullptr;\n";
+  for (auto n : parties)
+    os << "  if (n == " << n << ") return kernels_" << n << "[id];\n";
+  os << "  return nullptr;\n"
+     << "}\n";
+}
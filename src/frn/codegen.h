@@ -0,0 +1,40 @@
+#ifndef _FRN_CODEGEN_H
+#define _FRN_CODEGEN_H
+
+#include <ostream>
+#include <vector>
+
+namespace frn {
+
+/**
+ * @brief Write straight-line C++ for the local multiplication of one party.
+ *
+ * The kernel computes the same additive share and messages as
+ * Mult::Prepare, but with the multiplication table of ShrManipulator unrolled
+ * into code. Each element of the shares is loaded once, and products in the
+ * same message element which share a factor \f$a_i\f$ are computed as
+ * \f$a_i \cdot (b_{j_1} + b_{j_2} + \dots)\f$.
+ *
+ * The kernel is a static function named <code>mult_N_ID</code> with the
+ * FixedMultiplyKernel signature.
+ *
+ * @param os where to write the code
+ * @param n the number of parties
+ * @param id the ID of the party
+ */
+void WriteMultiplyKernel(std::ostream& os, std::size_t n, std::size_t id);
+
+/**
+ * @brief Write a translation unit with kernels for every party of some
+ * configurations, and a definition of FindGeneratedMultiplyKernel.
+ *
+ * @param os where to write the code
+ * @param parties the numbers of parties to generate kernels for. The
+ * threshold is (n - 1) / 3.
+ */
+void WriteMultiplyKernels(std::ostream& os,
+                          const std::vector<std::size_t>& parties);
+
+}  // namespace frn
+
+#endif  // _FRN_CODEGEN_H
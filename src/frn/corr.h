@@ -7,34 +7,47 @@
 
 namespace frn {
 
-struct ZeroShare {
+template <typename T>
+struct BasicZeroShare {
   // Additive share. Parties above P_2d+1 get zero
-  Field add_share;
+  T add_share;
   // Replicated shares of each additive share
-  std::vector<Shr> rep_add_shares;
+  std::vector<std::vector<T>> rep_add_shares;
 };
 
-struct RandomShare {
+template <typename T>
+struct BasicRandomShare {
   // Replicated share in [r]_d
-  Shr rep_share;
+  std::vector<T> rep_share;
   // Additive share in <r>_2d. Parties above P_2d+1 get zero
-  Field add_share;
+  T add_share;
   // Replicated shares of each additive share
-  std::vector<Shr> rep_add_shares;
+  std::vector<std::vector<T>> rep_add_shares;
 };
 
+using ZeroShare = BasicZeroShare<Field>;
+using RandomShare = BasicRandomShare<Field>;
+
 /**
  * @brief A class to produce and store correlated randomness
+ *
+ * @tparam T the ring of the shares.
  */
-class Correlator {
+template <typename T>
+class BasicCorrelator {
  public:
+  //! Type of a replicated share.
+  using ShareType = std::vector<T>;
+  using ZeroShare = BasicZeroShare<T>;
+  using RandomShare = BasicRandomShare<T>;
+
   /**
    * @brief Create a new Correlator instance
    * @param id the ID of this party
    * @param replicator the "global" replicator to use
    */
-  Correlator(unsigned id,
-             frn::lib::secret_sharing::Replicator<Field> const& replicator)
+  BasicCorrelator(unsigned id,
+                  frn::lib::secret_sharing::Replicator<T> const& replicator)
       : mReplicator(replicator),
         mId(id),
         mThreshold(replicator.Threshold()),
@@ -61,6 +74,13 @@ class Correlator {
    */
   RandomShare GenRandomShare();
 
+  /**
+   * As above but for count random values at once. Each PRG generates the
+   * elements of all the values in one call, which takes fewer AES blocks
+   * than generating them one at a time.
+   */
+  std::vector<RandomShare> GenRandomShares(std::size_t count);
+
   /**
    * As above but all shares set to zero
    */
@@ -76,7 +96,7 @@ class Correlator {
  private:
   void Init();
 
-  frn::lib::secret_sharing::Replicator<Field> mReplicator;
+  frn::lib::secret_sharing::Replicator<T> mReplicator;
   unsigned mId;
   std::size_t mThreshold;
   std::size_t mSize;
@@ -93,6 +113,104 @@ class Correlator {
   std::vector<frn::lib::primitives::PRG> mZeroPRGs;
 };
 
+/**
+ * @brief A Correlator for shares over Field.
+ */
+using Correlator = BasicCorrelator<Field>;
+
+extern template class BasicCorrelator<Field>;
+
+template <typename T>
+auto BasicCorrelator<T>::GenZeroShareDummy() -> ZeroShare {
+  ZeroShare output;
+
+  // Set the additive share to 0
+  output.add_share = T();
+
+  // Replicated share with zeros
+  ShareType ZeroRepShare(mReplicator.ShareSize());
+
+  // Fill in the vector of replicated shares with zero rep shares
+  for (std::size_t i = 0; i < 2 * mThreshold + 1; i++) {
+    output.rep_add_shares.emplace_back(ZeroRepShare);
+  }
+
+  return output;
+}
+
+template <typename T>
+auto BasicCorrelator<T>::GenRandomShareDummy() -> RandomShare {
+  RandomShare output;
+
+  // Set the additive share to 0
+  output.add_share = T();
+
+  // Replicated share with zeros
+  ShareType ZeroRepShare(mReplicator.ShareSize());
+
+  // Set the replicated share to 0
+  output.rep_share = ZeroRepShare;
+
+  // Fill in the vector of replicated shares with zero rep shares
+  for (std::size_t i = 0; i < 2 * mThreshold + 1; i++) {
+    output.rep_add_shares.emplace_back(ZeroRepShare);
+  }
+  return output;
+}
+
+template <typename T>
+auto BasicCorrelator<T>::GenRandomShare() -> RandomShare {
+  return GenRandomShares(1)[0];
+}
+
+template <typename T>
+auto BasicCorrelator<T>::GenRandomShares(std::size_t count)
+    -> std::vector<RandomShare> {
+  const auto share_size = mReplicator.ShareSize();
+  std::vector<RandomShare> output(count);
+  for (auto& random : output) {
+    random.add_share = T();
+    random.rep_share = ShareType(share_size);
+    random.rep_add_shares =
+        std::vector<ShareType>(2 * mThreshold + 1, ShareType(share_size));
+  }
+  std::vector<T> buf(count);
+
+  // Only parties in U have additive shares
+  if (mId < 2*mThreshold+1) {
+    // Get the additive share by adding the PRGs obtained when Pi
+    // shared its own key
+    for (unsigned i=0; i < mReplicator.AdditiveShareSize(); i++){
+      mOwnPRGs[i].NextUniform(buf);
+      for (std::size_t j = 0; j < count; j++) output[j].add_share += buf[j];
+    };
+  };
+
+  // Set the replicated share of each additive share
+  // and of the secret
+  for (unsigned shr_idx = 0; shr_idx < share_size; shr_idx++) {
+    for (unsigned idx_in_U = 0; idx_in_U < 2*mThreshold+1; idx_in_U++) {
+      mRandPRGs[idx_in_U][shr_idx].NextUniform(buf);
+      for (std::size_t j = 0; j < count; j++) {
+        output[j].rep_add_shares[idx_in_U][shr_idx] = buf[j];
+        output[j].rep_share[shr_idx] += buf[j];
+      }
+    }
+  }
+
+  return output;
+}
+
+template <typename T>
+void BasicCorrelator<T>::Init() {
+  // Initializes the internal PRGs to default
+  std::vector<frn::lib::primitives::PRG> PRGs(mReplicator.ShareSize());
+  for (unsigned j=0; j < 2*mThreshold+1; j++) {
+      SetRandPRGs(PRGs, j);
+  };
+
+}
+
 }  // namespace frn
 
 #endif  // CORR_H
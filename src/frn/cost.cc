@@ -0,0 +1,140 @@
+#include "frn/cost.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "frn/input_corr.h"
+
+// Check sends the number of values and digests as a 4 byte integer.
+#define CHECK_LENGTH_SIZE 4
+
+std::size_t frn::Cost::BytesSent() const {
+  return std::accumulate(sent.begin(), sent.end(), std::size_t(0));
+}
+
+std::size_t frn::Cost::BytesReceived() const {
+  return std::accumulate(received.begin(), received.end(), std::size_t(0));
+}
+
+frn::Cost& frn::Cost::operator+=(const Cost& other) {
+  for (std::size_t i = 0; i < sent.size(); i++) {
+    sent[i] += other.sent[i];
+    received[i] += other.received[i];
+  }
+  rounds += other.rounds;
+  return *this;
+}
+
+frn::CostModel::CostModel(std::size_t n, bool packed)
+    : mSize(n),
+      mThreshold((n - 1) / 3),
+      mPacked(packed),
+      mReplicator(n, mThreshold),
+      mDoubleReplicator(n, 2 * mThreshold) {}
+
+std::size_t frn::CostModel::ElementBytes(std::size_t elements) const {
+  return mPacked ? frn::lib::math::vector::PackedByteSize<Field>(elements)
+                 : elements * Field::ByteSize();
+}
+
+frn::Cost frn::CostModel::InputSetup(unsigned id) const {
+  // the dealer of each set sends its key to the other members, with all keys
+  // for the same party in one message.
+  std::vector<std::size_t> sent(mSize), received(mSize);
+  for (auto idx : mReplicator.IndexSetFor(id)) {
+    const auto dealer = frn::InputSetup::KeyDealer(mReplicator, idx);
+    if (dealer != id) {
+      received[dealer]++;
+      continue;
+    }
+    for (auto party : mReplicator.Combination(idx))
+      if ((unsigned)party != id) sent[party]++;
+  }
+
+  Cost cost(mSize);
+  for (std::size_t p = 0; p < mSize; p++) {
+    cost.sent[p] = ElementBytes(sent[p]);
+    cost.received[p] = ElementBytes(received[p]);
+  }
+  cost.rounds = 1;
+  return cost;
+}
+
+frn::Cost frn::CostModel::Input(unsigned id, unsigned inputter,
+                                std::size_t size) const {
+  // the inputter sends every masked input to everyone.
+  Cost cost(mSize);
+  const auto bytes = ElementBytes(size);
+  if (id == inputter) std::fill(cost.sent.begin(), cost.sent.end(), bytes);
+  cost.received[inputter] = bytes;
+  cost.rounds = 1;
+  return cost;
+}
+
+frn::Cost frn::CostModel::Mult(unsigned id, std::size_t size) const {
+  Cost cost(mSize);
+  const auto bytes = ElementBytes(size);
+  const auto senders = 2 * mThreshold + 1;
+  const auto receivers = mSize - mThreshold;
+
+  // the first 2t + 1 parties send an additive share of each product to P0.
+  if (id < senders) cost.sent[0] += bytes;
+  if (id == 0)
+    for (std::size_t i = 0; i < senders; i++) cost.received[i] += bytes;
+
+  // P0 sends the reconstructed values to the first n - t parties.
+  if (id == 0)
+    for (std::size_t i = 0; i < receivers; i++) cost.sent[i] += bytes;
+  if (id < receivers) cost.received[0] += bytes;
+
+  cost.rounds = 2;
+  return cost;
+}
+
+void frn::CostModel::CheckMessages(unsigned from,
+                                   std::vector<std::size_t>& values,
+                                   std::vector<std::size_t>& digests) const {
+  // mirrors how ShrManipulator builds its reconstruction table: every
+  // additive share of degree 2t held by a party goes to the parties which do
+  // not hold it, in full from its first holder and as a digest from the rest.
+  const auto batch = 2 * mThreshold + 1;
+  for (auto shr_id : mDoubleReplicator.IndexSetFor(from)) {
+    const auto set = mDoubleReplicator.Combination(shr_id);
+    const bool value = (unsigned)set[0] == from;
+    for (std::size_t p = 0; p < mSize; p++) {
+      if (std::find(set.begin(), set.end(), (int)p) != set.end()) continue;
+      if (value)
+        values[p] += batch;
+      else
+        digests[p] += 1;
+    }
+  }
+}
+
+frn::Cost frn::CostModel::Check(unsigned id) const {
+  Cost cost(mSize);
+
+  auto bytes = [this](std::size_t values, std::size_t digests) {
+    return 2 * CHECK_LENGTH_SIZE + ElementBytes(values) +
+           ElementBytes(digests);
+  };
+
+  std::vector<std::size_t> values(mSize), digests(mSize);
+  CheckMessages(id, values, digests);
+  for (std::size_t p = 0; p < mSize; p++)
+    cost.sent[p] = bytes(values[p], digests[p]);
+
+  for (std::size_t p = 0; p < mSize; p++) {
+    if (p == id) {
+      cost.received[p] = cost.sent[p];
+      continue;
+    }
+    std::fill(values.begin(), values.end(), 0);
+    std::fill(digests.begin(), digests.end(), 0);
+    CheckMessages(p, values, digests);
+    cost.received[p] = bytes(values[id], digests[id]);
+  }
+
+  cost.rounds = 1;
+  return cost;
+}
@@ -0,0 +1,123 @@
+#ifndef _FRN_COST_H
+#define _FRN_COST_H
+
+#include <vector>
+
+#include "frn/shr.h"
+
+namespace frn {
+
+/**
+ * @brief Communication of one party during (part of) a protocol.
+ *
+ * Byte counts include messages a party sends to itself, since TcpNetwork
+ * counts those as well.
+ */
+struct Cost {
+  //! Bytes sent to each party.
+  std::vector<std::size_t> sent;
+  //! Bytes received from each party.
+  std::vector<std::size_t> received;
+  //! Number of communication rounds.
+  std::size_t rounds = 0;
+
+  /**
+   * @brief No communication between n parties.
+   */
+  explicit Cost(std::size_t n) : sent(n, 0), received(n, 0){};
+
+  /**
+   * @brief Total number of bytes sent.
+   */
+  std::size_t BytesSent() const;
+
+  /**
+   * @brief Total number of bytes received.
+   */
+  std::size_t BytesReceived() const;
+
+  /**
+   * @brief Add the cost of a protocol which runs after this one.
+   */
+  Cost& operator+=(const Cost& other);
+};
+
+/**
+ * @brief Predicts the communication of the protocols without running them.
+ *
+ * The predictions are exact: they give the number of bytes a party sends to
+ * and receives from every other party, as counted by TcpNetwork, and the
+ * number of rounds of the protocol. Rounds are counted for the protocol as a
+ * whole, so a party which only sends, or only receives, in some round still
+ * takes part in that many rounds.
+ */
+class CostModel {
+ public:
+  /**
+   * @brief Create a cost model for n parties with threshold (n - 1) / 3.
+   * @param n the number of parties
+   * @param packed whether field elements are sent packed, see
+   * TcpNetwork::SetPacked
+   */
+  explicit CostModel(std::size_t n, bool packed = false);
+
+  /**
+   * @brief Cost of InputSetup.
+   * @param id the party
+   */
+  Cost InputSetup(unsigned id) const;
+
+  /**
+   * @brief Cost of Input where a single party provides all inputs.
+   * @param id the party
+   * @param inputter the party providing inputs
+   * @param size the number of inputs
+   */
+  Cost Input(unsigned id, unsigned inputter, std::size_t size) const;
+
+  /**
+   * @brief Cost of a batch of multiplications.
+   * @param id the party
+   * @param size the number of multiplications
+   */
+  Cost Mult(unsigned id, std::size_t size) const;
+
+  /**
+   * @brief Cost of checking any number of multiplications.
+   *
+   * The check compresses all multiplications into one before communicating,
+   * so its cost does not depend on how many multiplications are checked.
+   *
+   * @param id the party
+   */
+  Cost Check(unsigned id) const;
+
+  /**
+   * @brief The number of parties.
+   */
+  std::size_t Size() const { return mSize; };
+
+  /**
+   * @brief The threshold.
+   */
+  std::size_t Threshold() const { return mThreshold; };
+
+ private:
+  // Field elements party from sends to party to in Check, as values and as
+  // digests, respectively.
+  void CheckMessages(unsigned from, std::vector<std::size_t>& values,
+                     std::vector<std::size_t>& digests) const;
+
+  // Bytes of a message with this many field elements.
+  std::size_t ElementBytes(std::size_t elements) const;
+
+  std::size_t mSize;
+  std::size_t mThreshold;
+  bool mPacked;
+  frn::lib::secret_sharing::Replicator<Field> mReplicator;
+  frn::lib::secret_sharing::Replicator<Field> mDoubleReplicator;
+};
+
+}  // namespace frn
+
+#endif  // _FRN_COST_H
@@ -0,0 +1,372 @@
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frn.h"
+#include "frn/experiment.h"
+
+#define BASE_PORT 6677
+
+namespace {
+
+struct Options {
+  std::vector<frn::ExperimentType> experiments = {frn::ExperimentType::eMult};
+  std::vector<std::size_t> parties = {4};
+  std::vector<std::size_t> sizes = {1000};
+  std::size_t repetitions = 5;
+  std::size_t warmup = 1;
+  std::string transport = "tcp";
+  unsigned port = BASE_PORT;
+  std::string format = "csv";
+  std::string output;
+  bool predict_only = false;
+};
+
+// Summary statistics of one metric over all repetitions of a configuration.
+struct Row {
+  frn::ExperimentType experiment;
+  std::size_t n;
+  std::size_t size;
+  std::string metric;
+  std::string unit;
+  std::vector<double> samples;
+};
+
+// measurements[size][repetition][party]
+using Measurements =
+    std::vector<std::vector<std::vector<frn::Measurement>>>;
+
+std::vector<std::string> Split(const std::string& list) {
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) items.emplace_back(item);
+  return items;
+}
+
+std::vector<std::size_t> ParseNumbers(const std::string& list) {
+  std::vector<std::size_t> numbers;
+  for (const auto& item : Split(list)) numbers.emplace_back(std::stoul(item));
+  return numbers;
+}
+
+// Percentile by linear interpolation between the closest ranks.
+double Percentile(std::vector<double> values, double p) {
+  std::sort(values.begin(), values.end());
+  double rank = p / 100 * (values.size() - 1);
+  std::size_t lo = rank;
+  std::size_t hi = std::min(lo + 1, values.size() - 1);
+  return values[lo] + (rank - lo) * (values[hi] - values[lo]);
+}
+
+double Mean(const std::vector<double>& values) {
+  return std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+}
+
+// Run all parties of one configuration as threads and collect what each of
+// them measured.
+Measurements RunParties(const Options& options, frn::ExperimentType type,
+                        std::size_t n) {
+  Measurements measurements(options.sizes.size());
+  for (auto& m : measurements)
+    m.assign(options.repetitions, std::vector<frn::Measurement>(n));
+
+  auto party = [&](std::shared_ptr<frn::TcpNetwork> network) {
+    frn::Experiment experiment(type, network);
+    for (std::size_t s = 0; s < options.sizes.size(); s++) {
+      for (std::size_t w = 0; w < options.warmup; w++)
+        experiment.Run(options.sizes[s]);
+      for (std::size_t r = 0; r < options.repetitions; r++)
+        measurements[s][r][network->Id()] = experiment.Run(options.sizes[s]);
+    }
+  };
+
+  if (options.transport == "memory") {
+    frn::Simulator simulator(n);
+    simulator.Run(party);
+    return measurements;
+  }
+
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  std::vector<std::thread> threads;
+  for (std::size_t id = 0; id < n; id++) {
+    threads.emplace_back([&, id]() {
+      try {
+        auto network = frn::TcpNetwork::CreateWithLocalParties(
+            id, n, options.port, false);
+        network->Connect();
+        party(network);
+        network->Close();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  if (error) std::rethrow_exception(error);
+  return measurements;
+}
+
+// A phase is done when the slowest party is done, so phase times are the
+// maximum over all parties. Communication is reported both for the party
+// which sends the most and in total.
+std::vector<Row> Aggregate(const Options& options, frn::ExperimentType type,
+                           std::size_t n, const Measurements& measurements) {
+  std::vector<Row> rows;
+  for (std::size_t s = 0; s < options.sizes.size(); s++) {
+    std::map<std::string, Row> phases;
+    std::vector<std::string> phase_order;
+    Row total{type, n, options.sizes[s], "total", "ms", {}};
+    Row sent{type, n, options.sizes[s], "bytes_sent_max", "bytes", {}};
+    Row sent_total{type, n, options.sizes[s], "bytes_sent_total", "bytes", {}};
+    Row received{type, n, options.sizes[s], "bytes_received_max", "bytes", {}};
+    Row rounds{type, n, options.sizes[s], "rounds", "rounds", {}};
+
+    for (const auto& repetition : measurements[s]) {
+      std::map<std::string, double> phase_max;
+      double total_max = 0, sent_max = 0, sent_sum = 0, received_max = 0,
+             rounds_max = 0;
+      for (const auto& m : repetition) {
+        double party_total = 0;
+        for (const auto& phase : m.phases) {
+          if (std::find(phase_order.begin(), phase_order.end(),
+                        phase.first) == phase_order.end())
+            phase_order.emplace_back(phase.first);
+          phase_max[phase.first] =
+              std::max(phase_max[phase.first], phase.second);
+          party_total += phase.second;
+        }
+        total_max = std::max(total_max, party_total);
+        sent_max = std::max(sent_max, (double)m.bytes_sent);
+        sent_sum += m.bytes_sent;
+        received_max = std::max(received_max, (double)m.bytes_received);
+        rounds_max = std::max(rounds_max, (double)m.rounds);
+      }
+      for (const auto& phase : phase_max) {
+        auto it = phases.find(phase.first);
+        if (it == phases.end())
+          it = phases
+                   .emplace(phase.first, Row{type, n, options.sizes[s],
+                                             phase.first, "ms", {}})
+                   .first;
+        it->second.samples.emplace_back(phase.second);
+      }
+      total.samples.emplace_back(total_max);
+      sent.samples.emplace_back(sent_max);
+      sent_total.samples.emplace_back(sent_sum);
+      received.samples.emplace_back(received_max);
+      rounds.samples.emplace_back(rounds_max);
+    }
+
+    for (const auto& name : phase_order) rows.emplace_back(phases.at(name));
+    for (const auto& row : {total, sent, sent_total, received, rounds})
+      rows.emplace_back(row);
+  }
+  return rows;
+}
+
+// Rows with the communication predicted by the cost model, in the same format
+// as the measured ones.
+std::vector<Row> Predict(const Options& options, frn::ExperimentType type,
+                         std::size_t n) {
+  frn::CostModel model(n, frn::TcpNetwork::PackedFromEnvironment());
+  std::vector<Row> rows;
+  for (auto size : options.sizes) {
+    double sent_max = 0, sent_total = 0, received_max = 0, rounds = 0;
+    for (unsigned id = 0; id < n; id++) {
+      auto cost = frn::PredictCost(type, model, id, size);
+      sent_max = std::max(sent_max, (double)cost.BytesSent());
+      sent_total += cost.BytesSent();
+      received_max = std::max(received_max, (double)cost.BytesReceived());
+      rounds = cost.rounds;
+    }
+    rows.emplace_back(Row{type, n, size, "predicted_bytes_sent_max", "bytes",
+                          {sent_max}});
+    rows.emplace_back(Row{type, n, size, "predicted_bytes_sent_total",
+                          "bytes", {sent_total}});
+    rows.emplace_back(Row{type, n, size, "predicted_bytes_received_max",
+                          "bytes", {received_max}});
+    rows.emplace_back(
+        Row{type, n, size, "predicted_rounds", "rounds", {rounds}});
+  }
+  return rows;
+}
+
+// Compare what every party measured with the prediction of the cost model,
+// and report any difference. Returns a row per size counting the differences.
+std::vector<Row> Verify(const Options& options, frn::ExperimentType type,
+                        std::size_t n, const Measurements& measurements) {
+  frn::CostModel model(n, frn::TcpNetwork::PackedFromEnvironment());
+  std::vector<Row> rows;
+  for (std::size_t s = 0; s < options.sizes.size(); s++) {
+    const auto size = options.sizes[s];
+    std::vector<frn::Cost> costs;
+    for (unsigned id = 0; id < n; id++)
+      costs.emplace_back(frn::PredictCost(type, model, id, size));
+
+    double mismatches = 0;
+    for (std::size_t r = 0; r < measurements[s].size(); r++) {
+      std::size_t rounds = 0;
+      for (unsigned id = 0; id < n; id++) {
+        const auto& m = measurements[s][r][id];
+        rounds = std::max(rounds, m.rounds);
+        for (unsigned peer = 0; peer < n; peer++) {
+          if (m.sent[peer] == costs[id].sent[peer] &&
+              m.received[peer] == costs[id].received[peer])
+            continue;
+          mismatches++;
+          std::cerr << "warning: " << frn::ToString(type) << " with N " << n
+                    << " and size " << size << ": party " << id
+                    << " sent/received " << m.sent[peer] << "/"
+                    << m.received[peer] << " bytes to/from " << peer
+                    << ", expected " << costs[id].sent[peer] << "/"
+                    << costs[id].received[peer] << "\n";
+        }
+      }
+      if (rounds != costs[0].rounds) {
+        mismatches++;
+        std::cerr << "warning: " << frn::ToString(type) << " with N " << n
+                  << " and size " << size << " took " << rounds
+                  << " rounds, expected " << costs[0].rounds << "\n";
+      }
+    }
+    rows.emplace_back(
+        Row{type, n, size, "cost_mismatches", "count", {mismatches}});
+  }
+  return rows;
+}
+
+void WriteCsv(std::ostream& os, const Options& options,
+              const std::vector<Row>& rows) {
+  os << "experiment,transport,n,size,metric,unit,repetitions,mean,min,p10,"
+        "median,p90,p99,max\n";
+  for (const auto& row : rows) {
+    os << frn::ToString(row.experiment) << "," << options.transport << ","
+       << row.n << "," << row.size << "," << row.metric << "," << row.unit
+       << "," << row.samples.size() << "," << Mean(row.samples) << ","
+       << Percentile(row.samples, 0) << "," << Percentile(row.samples, 10)
+       << "," << Percentile(row.samples, 50) << ","
+       << Percentile(row.samples, 90) << "," << Percentile(row.samples, 99)
+       << "," << Percentile(row.samples, 100) << "\n";
+  }
+}
+
+void WriteJson(std::ostream& os, const Options& options,
+               const std::vector<Row>& rows) {
+  os << "{\"transport\": \"" << options.transport
+     << "\", \"repetitions\": " << options.repetitions
+     << ", \"warmup\": " << options.warmup << ", \"results\": [";
+  for (std::size_t i = 0; i < rows.size(); i++) {
+    const auto& row = rows[i];
+    os << (i ? ",\n  " : "\n  ") << "{\"experiment\": \""
+       << frn::ToString(row.experiment) << "\", \"n\": " << row.n
+       << ", \"size\": " << row.size << ", \"metric\": \"" << row.metric
+       << "\", \"unit\": \"" << row.unit
+       << "\", \"mean\": " << Mean(row.samples)
+       << ", \"min\": " << Percentile(row.samples, 0)
+       << ", \"p10\": " << Percentile(row.samples, 10)
+       << ", \"median\": " << Percentile(row.samples, 50)
+       << ", \"p90\": " << Percentile(row.samples, 90)
+       << ", \"p99\": " << Percentile(row.samples, 99)
+       << ", \"max\": " << Percentile(row.samples, 100) << ", \"samples\": [";
+    for (std::size_t j = 0; j < row.samples.size(); j++)
+      os << (j ? ", " : "") << row.samples[j];
+    os << "]}";
+  }
+  os << "\n]}\n";
+}
+
+void Usage(const char* name) {
+  std::cout
+      << "usage: " << name
+      << " [--experiment input,mult,check] [--parties N,...] [--sizes M,...]"
+         " [--reps R] [--warmup W] [--transport tcp|memory] [--port P]"
+         " [--format csv|json] [--output FILE] [--predict only]\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (i + 1 == argc) throw std::invalid_argument("missing value");
+      std::string value = argv[++i];
+      if (arg == "--experiment") {
+        options.experiments.clear();
+        for (const auto& name : Split(value))
+          options.experiments.emplace_back(frn::ParseExperimentType(name));
+      } else if (arg == "--parties") {
+        options.parties = ParseNumbers(value);
+      } else if (arg == "--sizes") {
+        options.sizes = ParseNumbers(value);
+      } else if (arg == "--reps") {
+        options.repetitions = std::stoul(value);
+      } else if (arg == "--warmup") {
+        options.warmup = std::stoul(value);
+      } else if (arg == "--transport") {
+        options.transport = value;
+      } else if (arg == "--port") {
+        options.port = std::stoul(value);
+      } else if (arg == "--format") {
+        options.format = value;
+      } else if (arg == "--output") {
+        options.output = value;
+      } else if (arg == "--predict") {
+        options.predict_only = value == "only";
+      } else {
+        throw std::invalid_argument("unknown option " + arg);
+      }
+    }
+    if (options.repetitions == 0)
+      throw std::invalid_argument("need at least one repetition");
+    if (options.transport != "tcp" && options.transport != "memory")
+      throw std::invalid_argument("unknown transport " + options.transport);
+    if (options.format != "csv" && options.format != "json")
+      throw std::invalid_argument("unknown format " + options.format);
+    for (auto n : options.parties)
+      if (n < 4) throw std::invalid_argument("need at least 4 parties");
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    Usage(argv[0]);
+    return 1;
+  }
+
+  std::vector<Row> rows;
+  for (auto type : options.experiments) {
+    for (auto n : options.parties) {
+      auto predicted = Predict(options, type, n);
+      rows.insert(rows.end(), predicted.begin(), predicted.end());
+      if (options.predict_only) continue;
+
+      std::cerr << "running " << frn::ToString(type) << " with N " << n
+                << " ...\n";
+      auto measurements = RunParties(options, type, n);
+      auto aggregated = Aggregate(options, type, n, measurements);
+      rows.insert(rows.end(), aggregated.begin(), aggregated.end());
+      auto verified = Verify(options, type, n, measurements);
+      rows.insert(rows.end(), verified.begin(), verified.end());
+    }
+  }
+
+  std::ofstream file;
+  if (!options.output.empty()) file.open(options.output);
+  std::ostream& os = options.output.empty() ? std::cout : file;
+  // byte counts should not be printed in scientific notation.
+  os.precision(12);
+  if (options.format == "csv")
+    WriteCsv(os, options, rows);
+  else
+    WriteJson(os, options, rows);
+}
@@ -0,0 +1,161 @@
+#include "frn/experiment.h"
+
+#include <chrono>
+#include <stdexcept>
+
+#include "frn/check.h"
+#include "frn/input.h"
+#include "frn/input_corr.h"
+#include "frn/mult.h"
+
+// ID of the party giving inputs in the input experiment.
+#define INPUTTER 0
+
+namespace {
+
+// Measures the time between construction and a call to Stop.
+class Stopwatch {
+ public:
+  Stopwatch() : mStart(std::chrono::steady_clock::now()){};
+
+  double Stop() const {
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - mStart;
+    return elapsed.count();
+  };
+
+ private:
+  std::chrono::steady_clock::time_point mStart;
+};
+
+// Secret shares of 1, 2, ..., n. All parties use the same PRG, so the shares
+// are consistent.
+std::vector<frn::Shr> fake_inputs(
+    std::size_t n, std::size_t offset, unsigned id,
+    const frn::lib::secret_sharing::Replicator<frn::Field>& replicator) {
+  std::vector<frn::Shr> shares;
+  shares.reserve(n);
+  frn::lib::primitives::PRG prg;
+  for (std::size_t i = 0; i < n; i++)
+    shares.emplace_back(replicator.Share(frn::Field(i + offset), prg)[id]);
+  return shares;
+}
+
+}  // namespace
+
+frn::ExperimentType frn::ParseExperimentType(const std::string& name) {
+  if (name == "input") return ExperimentType::eInput;
+  if (name == "mult") return ExperimentType::eMult;
+  if (name == "check") return ExperimentType::eCheck;
+  throw std::invalid_argument("unknown experiment: " + name);
+}
+
+std::string frn::ToString(ExperimentType type) {
+  switch (type) {
+    case ExperimentType::eInput:
+      return "input";
+    case ExperimentType::eMult:
+      return "mult";
+    case ExperimentType::eCheck:
+      return "check";
+  }
+  return "unknown";
+}
+
+frn::Cost frn::PredictCost(ExperimentType type, const CostModel& model,
+                           unsigned id, std::size_t size) {
+  if (type == ExperimentType::eInput) {
+    auto cost = model.InputSetup(id);
+    cost += model.Input(id, INPUTTER, size);
+    return cost;
+  }
+  auto cost = model.Mult(id, size);
+  if (type == ExperimentType::eCheck) cost += model.Check(id);
+  return cost;
+}
+
+frn::Experiment::Experiment(ExperimentType type,
+                            std::shared_ptr<TcpNetwork> network)
+    : mType(type),
+      mNetwork(network),
+      mReplicator(CreateReplicator(network->Size())),
+      mManipulator(network->Id(), mReplicator.Threshold(), network->Size()),
+      mCorrelator(network->Id(), mReplicator) {}
+
+frn::Measurement frn::Experiment::Run(std::size_t size) {
+  Synchronize();
+  mNetwork->ResetCommunicationSummary();
+
+  Measurement measurement;
+  if (mType == ExperimentType::eInput)
+    RunInput(size, measurement);
+  else
+    RunMult(size, mType == ExperimentType::eCheck, measurement);
+
+  mNetwork->Flush();
+  measurement.bytes_sent = mNetwork->BytesSent();
+  measurement.bytes_received = mNetwork->BytesReceived();
+  measurement.rounds = mNetwork->Rounds();
+  for (std::size_t i = 0; i < mNetwork->Size(); i++) {
+    measurement.sent.emplace_back(mNetwork->BytesSentTo(i));
+    measurement.received.emplace_back(mNetwork->BytesReceivedFrom(i));
+  }
+  return measurement;
+}
+
+void frn::Experiment::Synchronize() {
+  const auto id = mNetwork->Id();
+  for (std::size_t i = 0; i < mNetwork->Size(); i++)
+    if (i != id) mNetwork->SendBytes(i, {0});
+  for (std::size_t i = 0; i < mNetwork->Size(); i++)
+    if (i != id) mNetwork->RecvBytes(i, 1);
+}
+
+void frn::Experiment::RunInput(std::size_t size, Measurement& measurement) {
+  Stopwatch setup_time;
+  frn::lib::primitives::PRG prg;
+  InputSetup setup(mNetwork, mReplicator, prg);
+  auto correlator = setup.Run();
+  measurement.phases.emplace_back("setup", setup_time.Stop());
+
+  Stopwatch input_time;
+  Input input(mNetwork, mManipulator, correlator);
+  if (mNetwork->Id() == INPUTTER) {
+    std::vector<Field> inputs;
+    inputs.reserve(size);
+    for (std::size_t i = 0; i < size; i++) inputs.emplace_back(Field(i));
+    input.Prepare(inputs);
+  } else {
+    input.PrepareToReceive(INPUTTER, size);
+  }
+  input.Run();
+  measurement.phases.emplace_back("input", input_time.Stop());
+}
+
+void frn::Experiment::RunMult(std::size_t size, bool check,
+                              Measurement& measurement) {
+  const auto id = mNetwork->Id();
+  auto xs = fake_inputs(size, 1, id, mReplicator);
+  auto ys = fake_inputs(size, 2, id, mReplicator);
+
+  auto check_data = CheckData(mReplicator.Threshold());
+  Mult mult(mNetwork, mReplicator, mManipulator, mCorrelator, check_data);
+
+  Stopwatch prepare_time;
+  mult.Prepare(xs, ys);
+  measurement.phases.emplace_back("prepare", prepare_time.Stop());
+
+  Stopwatch mult_time;
+  mult.Run();
+  measurement.phases.emplace_back("mult", mult_time.Stop());
+
+  if (!check) return;
+
+  Stopwatch check_time;
+  Check check_protocol(mNetwork, mReplicator, mManipulator, check_data);
+  check_protocol.ComputeRandomCoefficients();
+  check_protocol.PrepareLinearCombinations();
+  check_protocol.PrepareMsgs();
+  check_protocol.ReconstructMsgs();
+  measurement.phases.emplace_back("check", check_time.Stop());
+}
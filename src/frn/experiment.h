@@ -0,0 +1,118 @@
+#ifndef _FRN_EXPERIMENT_H
+#define _FRN_EXPERIMENT_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "frn/corr.h"
+#include "frn/cost.h"
+#include "frn/shr.h"
+#include "frn/tcp_network.h"
+
+namespace frn {
+
+/**
+ * @brief The protocols which can be benchmarked.
+ */
+enum class ExperimentType {
+  //! Party 0 inputs some values.
+  eInput,
+  //! A batch of multiplications.
+  eMult,
+  //! A batch of multiplications followed by a check.
+  eCheck
+};
+
+/**
+ * @brief Parse the name of an experiment, i.e., "input", "mult" or "check".
+ * @throws std::invalid_argument if the name is unknown.
+ */
+ExperimentType ParseExperimentType(const std::string& name);
+
+/**
+ * @brief Name of an experiment, as accepted by ParseExperimentType.
+ */
+std::string ToString(ExperimentType type);
+
+/**
+ * @brief What one party observed during one run of an experiment.
+ */
+struct Measurement {
+  //! Name and duration in milliseconds of each phase, in the order they ran.
+  std::vector<std::pair<std::string, double>> phases;
+  //! Bytes sent to other parties.
+  std::size_t bytes_sent = 0;
+  //! Bytes received from other parties.
+  std::size_t bytes_received = 0;
+  //! Bytes sent to each party.
+  std::vector<std::size_t> sent;
+  //! Bytes received from each party.
+  std::vector<std::size_t> received;
+  //! Communication rounds.
+  std::size_t rounds = 0;
+};
+
+/**
+ * @brief Predict the communication of one party in one run of an experiment.
+ * @param type the experiment
+ * @param model a cost model for the number of parties
+ * @param id the party
+ * @param size the number of inputs, multiplications or checks
+ */
+Cost PredictCost(ExperimentType type, const CostModel& model, unsigned id,
+                 std::size_t size);
+
+/**
+ * @brief Runs one of the protocols for a single party and measures it.
+ *
+ * State which only depends on the number of parties, such as the share
+ * manipulator, is created once in the constructor, so an experiment can be
+ * repeated cheaply. All parties must call Run with the same size, the same
+ * number of times.
+ */
+class Experiment {
+ public:
+  /**
+   * @brief Create a new experiment.
+   * @param type the protocol to run
+   * @param network a connected network
+   */
+  Experiment(ExperimentType type, std::shared_ptr<TcpNetwork> network);
+
+  /**
+   * @brief Run the experiment once.
+   *
+   * Parties synchronize before the first phase starts, so the time of a phase
+   * does not include waiting for slower parties to arrive. Communication used
+   * for synchronizing is not included in the measurement.
+   *
+   * @param size the number of inputs, multiplications or checks
+   * @return timings and communication of this party.
+   */
+  Measurement Run(std::size_t size);
+
+  /**
+   * @brief The protocol this experiment runs.
+   */
+  ExperimentType Type() const { return mType; };
+
+ private:
+  // Exchange a byte with every other party.
+  void Synchronize();
+
+  void RunInput(std::size_t size, Measurement& measurement);
+
+  void RunMult(std::size_t size, bool check, Measurement& measurement);
+
+  ExperimentType mType;
+  std::shared_ptr<TcpNetwork> mNetwork;
+  frn::lib::secret_sharing::Replicator<Field> mReplicator;
+  ShrManipulator mManipulator;
+  Correlator mCorrelator;
+};
+
+}  // namespace frn
+
+#endif  // _FRN_EXPERIMENT_H
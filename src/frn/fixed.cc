@@ -0,0 +1,54 @@
+#include "frn/fixed.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "frn/generated.h"
+
+namespace {
+
+template <std::size_t N, std::size_t T, std::size_t Id>
+void multiply_kernel(const frn::Shr& a, const frn::Shr& b,
+                     frn::Field& add_share, std::vector<frn::Shr>& msgs) {
+  using Protocol = frn::FixedProtocol<N, T, Id>;
+  typename Protocol::Msgs m;
+  Protocol::MultiplyToAddAndMsgs(Protocol::FromShr(a), Protocol::FromShr(b),
+                                 add_share, m);
+  for (std::size_t p = 0; p < Protocol::kSenders; p++)
+    std::copy(m[p].begin(), m[p].end(), msgs[p].begin());
+}
+
+template <std::size_t N, std::size_t T, std::size_t... Ids>
+constexpr std::array<frn::FixedMultiplyKernel, N> kernels_for(
+    std::index_sequence<Ids...>) {
+  return {multiply_kernel<N, T, Ids>...};
+}
+
+// kernels for the configurations we deploy, indexed by party ID.
+template <std::size_t N>
+constexpr auto kKernels = kernels_for<N, (N - 1) / 3>(
+    std::make_index_sequence<N>{});
+
+}  // namespace
+
+frn::FixedMultiplyKernel frn::FindFixedMultiplyKernel(std::size_t n,
+                                                      std::size_t t,
+                                                      std::size_t id) {
+  if (t != (n - 1) / 3 || id >= n) return nullptr;
+  switch (n) {
+    case 4:
+      return kKernels<4>[id];
+    case 7:
+      return kKernels<7>[id];
+    case 10:
+      return kKernels<10>[id];
+    default:
+      return nullptr;
+  }
+}
+
+frn::FixedMultiplyKernel frn::FindMultiplyKernel(std::size_t n, std::size_t t,
+                                                 std::size_t id) {
+  auto kernel = FindGeneratedMultiplyKernel(n, t, id);
+  return kernel ? kernel : FindFixedMultiplyKernel(n, t, id);
+}
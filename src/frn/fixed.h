@@ -0,0 +1,400 @@
+#ifndef _FRN_FIXED_H
+#define _FRN_FIXED_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "frn/shr.h"
+
+namespace frn {
+namespace details {
+
+// A sorted set of parties.
+template <std::size_t K>
+using Set = std::array<int, K>;
+
+// Pair of indices into the shares being multiplied.
+struct Term {
+  unsigned src_a;
+  unsigned src_b;
+};
+
+// Terms ordered by a group index, such that terms[offsets[g]] to
+// terms[offsets[g + 1]] are the terms of group g.
+template <std::size_t G, std::size_t S>
+struct Groups {
+  std::array<std::size_t, G + 1> offsets;
+  std::array<Term, S> terms;
+};
+
+// Index of a combination (i.e., a sorted K-subset of the N parties) in the
+// lexicographic order used by Replicator.
+template <std::size_t N, std::size_t K>
+constexpr std::size_t Rank(const Set<K>& c) {
+  std::size_t rank = 0;
+  std::size_t next = 0;
+  for (std::size_t i = 0; i < K; i++) {
+    for (std::size_t j = next; j < (std::size_t)c[i]; j++)
+      rank += frn::lib::secret_sharing::Binom(N - 1 - j, K - 1 - i);
+    next = c[i] + 1;
+  }
+  return rank;
+}
+
+// The sets of parties holding each element of the share of party Id, i.e.,
+// Replicator::Combination(Replicator::IndexSetFor(Id)[i]).
+template <std::size_t N, std::size_t T, std::size_t Id, std::size_t S>
+constexpr std::array<Set<N - T>, S> ShareSets() {
+  std::array<Set<N - T>, S> sets{};
+  Set<N - T> c{};
+  for (std::size_t i = 0; i < N - T; i++) c[i] = i;
+  std::size_t idx = 0;
+  do {
+    for (auto p : c)
+      if ((std::size_t)p == Id) sets[idx++] = c;
+  } while (frn::lib::secret_sharing::NextCombination(c, N, N - T));
+  return sets;
+}
+
+// For each set of N - 2T parties, its index in the double degree share of
+// party Id, or -1 if the party does not hold it.
+template <std::size_t N, std::size_t T, std::size_t Id>
+constexpr std::array<int, frn::lib::secret_sharing::Binom(N, 2 * T)>
+DoubleIndices() {
+  std::array<int, frn::lib::secret_sharing::Binom(N, 2 * T)> indices{};
+  Set<N - 2 * T> c{};
+  for (std::size_t i = 0; i < N - 2 * T; i++) c[i] = i;
+  std::size_t rank = 0;
+  int idx = 0;
+  do {
+    indices[rank] = -1;
+    for (auto p : c)
+      if ((std::size_t)p == Id) indices[rank] = idx++;
+    rank++;
+  } while (frn::lib::secret_sharing::NextCombination(c, N, N - 2 * T));
+  return indices;
+}
+
+// An entry of the multiplication table (see MultEntry).
+struct Entry {
+  unsigned src_a;
+  unsigned src_b;
+  unsigned dest;
+  unsigned first_party;
+};
+
+// The multiplication table of party Id, in the order ShrManipulator::Init
+// produces it. Only the first size entries are used.
+template <std::size_t S>
+struct Table {
+  std::array<Entry, S * S> entries;
+  std::size_t size;
+};
+
+template <std::size_t N, std::size_t T, std::size_t Id, std::size_t S>
+constexpr Table<S> MultTable() {
+  constexpr auto sets = ShareSets<N, T, Id, S>();
+  constexpr auto indices = DoubleIndices<N, T, Id>();
+  Table<S> table{};
+  for (std::size_t a = 0; a < S; a++) {
+    for (std::size_t b = 0; b < S; b++) {
+      // the first N - 2T parties in the intersection of the (sorted) sets.
+      Set<N - 2 * T> first{};
+      std::size_t i = 0, j = 0, k = 0;
+      while (k < N - 2 * T) {
+        if (sets[a][i] < sets[b][j]) {
+          i++;
+        } else if (sets[b][j] < sets[a][i]) {
+          j++;
+        } else {
+          first[k++] = sets[a][i];
+          i++;
+          j++;
+        }
+      }
+      const int dest = indices[Rank<N>(first)];
+      if (dest >= 0)
+        table.entries[table.size++] = Entry{(unsigned)a, (unsigned)b,
+                                            (unsigned)dest, (unsigned)first[0]};
+    }
+  }
+  return table;
+}
+
+// Group the entries of a table with a key function (a counting sort).
+template <std::size_t G, std::size_t Size, std::size_t S, typename K>
+constexpr Groups<G, Size> Group(const Table<S>& table, K key) {
+  Groups<G, Size> groups{};
+  for (std::size_t i = 0; i < Size; i++)
+    groups.offsets[key(table.entries[i]) + 1]++;
+  for (std::size_t g = 0; g < G; g++)
+    groups.offsets[g + 1] += groups.offsets[g];
+  std::array<std::size_t, G> next{};
+  for (std::size_t g = 0; g < G; g++) next[g] = groups.offsets[g];
+  for (std::size_t i = 0; i < Size; i++) {
+    const auto& e = table.entries[i];
+    groups.terms[next[key(e)]++] = Term{e.src_a, e.src_b};
+  }
+  return groups;
+}
+
+// Index of the element of the share of party Id which holds the additive
+// share with index 0, or -1 (see ShrManipulator::IndexForConstantOperations).
+template <std::size_t N, std::size_t T, std::size_t Id, std::size_t S>
+constexpr int ConstantIndex() {
+  constexpr auto sets = ShareSets<N, T, Id, S>();
+  for (std::size_t i = 0; i < S; i++)
+    if (Rank<N>(sets[i]) == 0) return i;
+  return -1;
+}
+
+}  // namespace details
+
+/**
+ * @brief Share manipulations specialized for a fixed number of parties.
+ *
+ * ShrManipulator learns n, t and the party's ID at runtime, so share sizes and
+ * the multiplication table are data. FixedProtocol computes the same tables
+ * at compile time, grouped by the element they are added to, and works on
+ * <code>std::array</code> shares. All loop bounds are constants, and products
+ * are summed without reducing until the end of each group.
+ *
+ * Results are identical to those of ShrManipulator and Mult for the same
+ * (N, T, Id).
+ *
+ * @tparam N the number of parties
+ * @tparam T the threshold
+ * @tparam Id the ID of this party
+ */
+template <std::size_t N, std::size_t T, std::size_t Id>
+class FixedProtocol {
+  static_assert(0 < T && 2 * T < N, "threshold must satisfy 0 < 2T < N");
+  static_assert(Id < N, "party ID must be less than N");
+
+ public:
+  //! Number of elements in a replicated share.
+  static constexpr std::size_t kShareSize =
+      frn::lib::secret_sharing::Binom(N - 1, T);
+
+  //! Number of elements in a replicated share of double degree.
+  static constexpr std::size_t kDoubleShareSize =
+      frn::lib::secret_sharing::Binom(N - 1, 2 * T);
+
+  //! Number of parties which receive additive shares during multiplication.
+  static constexpr std::size_t kSenders = 2 * T + 1;
+
+  //! A replicated share.
+  using Share = std::array<Field, kShareSize>;
+
+  //! A replicated share of double degree.
+  using DoubleShare = std::array<Field, kDoubleShareSize>;
+
+  //! Messages of MultiplyToAddAndMsgs, indexed by the first party of a set.
+  using Msgs = std::array<DoubleShare, kSenders>;
+
+  /**
+   * @brief Add two shares.
+   */
+  static Share Add(const Share& a, const Share& b) {
+    Share c;
+    for (std::size_t i = 0; i < kShareSize; i++) c[i] = a[i] + b[i];
+    return c;
+  };
+
+  /**
+   * @brief Subtract two shares.
+   */
+  static Share Subtract(const Share& a, const Share& b) {
+    Share c;
+    for (std::size_t i = 0; i < kShareSize; i++) c[i] = a[i] - b[i];
+    return c;
+  };
+
+  /**
+   * @brief Add a constant to a share.
+   */
+  static Share AddConstant(const Share& a, const Field& c) {
+    Share r(a);
+    if constexpr (kConstantIndex >= 0) r[kConstantIndex] += c;
+    return r;
+  };
+
+  /**
+   * @brief Multiply a constant unto a share.
+   */
+  static Share MultiplyConstant(const Share& a, const Field& c) {
+    Share r;
+    for (std::size_t i = 0; i < kShareSize; i++) r[i] = a[i] * c;
+    return r;
+  };
+
+  /**
+   * @brief Locally multiply two degree T shares and output a degree 2T share.
+   * @see ShrManipulator::MultiplyToDoubleDegree.
+   */
+  static DoubleShare MultiplyToDoubleDegree(const Share& a, const Share& b) {
+    DoubleShare c;
+    for (std::size_t dest = 0; dest < kDoubleShareSize; dest++)
+      c[dest] = SumOfProducts(a, b, kByDest.offsets[dest],
+                              kByDest.offsets[dest + 1], kByDest.terms);
+    return c;
+  };
+
+  /**
+   * @brief Locally multiply two degree T shares to obtain an additive share.
+   * @see ShrManipulator::MultiplyToAdditive.
+   */
+  static Field MultiplyToAdditive(const Share& a, const Share& b) {
+    Field c;
+    if constexpr (Id < kSenders) {
+      const auto begin = Id * kDoubleShareSize;
+      c = SumOfProducts(a, b, kByParty.offsets[begin],
+                        kByParty.offsets[begin + kDoubleShareSize],
+                        kByParty.terms);
+    }
+    return c;
+  };
+
+  /**
+   * @brief The additive share and messages computed in Mult::Prepare.
+   *
+   * @param a the first share
+   * @param b the second share
+   * @param add_share set to the additive share of a * b
+   * @param msgs set to the sum of the products for each first party and
+   * element of a double degree share.
+   */
+  static void MultiplyToAddAndMsgs(const Share& a, const Share& b,
+                                   Field& add_share, Msgs& msgs) {
+    add_share = Field();
+    for (std::size_t party = 0; party < kSenders; party++) {
+      for (std::size_t dest = 0; dest < kDoubleShareSize; dest++) {
+        const auto group = party * kDoubleShareSize + dest;
+        msgs[party][dest] =
+            SumOfProducts(a, b, kByParty.offsets[group],
+                          kByParty.offsets[group + 1], kByParty.terms);
+      }
+    }
+    if constexpr (Id < kSenders)
+      for (const auto& v : msgs[Id]) add_share += v;
+  };
+
+  /**
+   * @brief Copy a share created elsewhere, e.g., by a Replicator.
+   * @pre <code>share.size() == kShareSize</code>.
+   */
+  static Share FromShr(const Shr& share) {
+    Share r;
+    for (std::size_t i = 0; i < kShareSize; i++) r[i] = share[i];
+    return r;
+  };
+
+  /**
+   * @brief Copy a share into a Shr.
+   */
+  template <std::size_t K>
+  static Shr ToShr(const std::array<Field, K>& share) {
+    return Shr(share.begin(), share.end());
+  }
+
+  /**
+   * @brief The multiplication table of ShrManipulator for this party.
+   *
+   * Entries are ordered by first party and then destination, rather than by
+   * source indices.
+   */
+  static std::vector<MultEntry> TableMult() {
+    std::vector<MultEntry> table;
+    for (std::size_t group = 0; group < kSenders * kDoubleShareSize; group++)
+      for (auto i = kByParty.offsets[group]; i < kByParty.offsets[group + 1];
+           i++)
+        table.emplace_back(MultEntry{kByParty.terms[i].src_a,
+                                     kByParty.terms[i].src_b,
+                                     (unsigned)(group % kDoubleShareSize),
+                                     (unsigned)(group / kDoubleShareSize)});
+    return table;
+  };
+
+ private:
+  static constexpr details::Table<kShareSize> kTable =
+      details::MultTable<N, T, Id, kShareSize>();
+
+  static constexpr std::size_t kTableSize = kTable.size;
+
+  // the table grouped by destination.
+  static constexpr details::Groups<kDoubleShareSize, kTableSize> kByDest =
+      details::Group<kDoubleShareSize, kTableSize>(
+          kTable, [](const details::Entry& e) { return e.dest; });
+
+  // the table grouped by first party and then destination.
+  static constexpr details::Groups<kSenders * kDoubleShareSize, kTableSize>
+      kByParty = details::Group<kSenders * kDoubleShareSize, kTableSize>(
+          kTable, [](const details::Entry& e) {
+            return e.first_party * kDoubleShareSize + e.dest;
+          });
+
+  static constexpr int kConstantIndex =
+      details::ConstantIndex<N, T, Id, kShareSize>();
+
+  // sum_{i in [begin, end)} a[terms[i].src_a] * b[terms[i].src_b]. Each
+  // product is folded to less than 2^62 and added to a 128-bit accumulator,
+  // so there is a single reduction per group.
+  static Field SumOfProducts(
+      const Share& a, const Share& b, std::size_t begin, std::size_t end,
+      const std::array<details::Term, kTableSize>& terms) {
+    using u64 = std::uint64_t;
+    using u128 = __uint128_t;
+    constexpr u64 p = frn::lib::math::Mp61::kPrime;
+    u128 acc = 0;
+    for (auto i = begin; i < end; i++) {
+      const u128 z =
+          (u128)a[terms[i].src_a].Value() * b[terms[i].src_b].Value();
+      acc += ((u64)z & p) + (u64)(z >> 61);
+    }
+    return Field(((u64)acc & p) + (u64)(acc >> 61));
+  };
+};
+
+/**
+ * @brief Computes the additive share and messages of Mult::Prepare.
+ *
+ * @param a the first share
+ * @param b the second share
+ * @param add_share set to the additive share of a * b
+ * @param msgs 2t + 1 double degree shares which are set to the messages.
+ */
+using FixedMultiplyKernel = void (*)(const Shr& a, const Shr& b,
+                                     Field& add_share, std::vector<Shr>& msgs);
+
+/**
+ * @brief Find a FixedProtocol instance for a configuration.
+ *
+ * Instances exist for n = 4, 7 and 10 with t = (n - 1) / 3.
+ *
+ * @param n the number of parties
+ * @param t the threshold
+ * @param id the ID of the party
+ * @return the kernel of the instance, or nullptr if there is none.
+ */
+FixedMultiplyKernel FindFixedMultiplyKernel(std::size_t n, std::size_t t,
+                                            std::size_t id);
+
+/**
+ * @brief Find the fastest specialized multiplication kernel for a
+ * configuration.
+ *
+ * Prefers a kernel generated at build time (see FindGeneratedMultiplyKernel)
+ * over a FixedProtocol instance.
+ *
+ * @param n the number of parties
+ * @param t the threshold
+ * @param id the ID of the party
+ * @return the kernel, or nullptr if the configuration has none.
+ */
+FixedMultiplyKernel FindMultiplyKernel(std::size_t n, std::size_t t,
+                                       std::size_t id);
+
+}  // namespace frn
+
+#endif  // _FRN_FIXED_H
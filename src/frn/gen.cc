@@ -0,0 +1,54 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "frn/codegen.h"
+
+namespace {
+
+void Usage(const char* name) {
+  std::cout << "usage: " << name << " --parties N,... --output FILE\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::size_t> parties;
+  std::string output;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    std::string value = argv[i + 1];
+    if (arg == "--parties") {
+      std::stringstream ss(value);
+      std::string item;
+      while (std::getline(ss, item, ','))
+        if (!item.empty()) parties.emplace_back(std::stoul(item));
+    } else if (arg == "--output") {
+      output = value;
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (output.empty() || argc % 2 == 0) {
+    Usage(argv[0]);
+    return 1;
+  }
+
+  for (auto n : parties) {
+    if (n < 4) {
+      std::cerr << "cannot generate kernels for " << n << " parties\n";
+      return 1;
+    }
+  }
+
+  // write everything first, so a failed run does not leave a partial file.
+  std::stringstream code;
+  frn::WriteMultiplyKernels(code, parties);
+  std::ofstream file(output);
+  file << code.str();
+  return file ? 0 : 1;
+}
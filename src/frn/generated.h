@@ -0,0 +1,58 @@
+#ifndef _FRN_GENERATED_H
+#define _FRN_GENERATED_H
+
+#include <cstdint>
+
+#include "frn/fixed.h"
+
+namespace frn {
+
+/**
+ * @brief Helpers used by the kernels written by WriteMultiplyKernels.
+ */
+namespace generated {
+
+//! 64-bit unsigned integer.
+using u64 = std::uint64_t;
+
+//! 128-bit unsigned integer.
+using u128 = __uint128_t;
+
+/**
+ * @brief \f$x \cdot y\f$ modulo Mp61, up to a multiple of the prime.
+ *
+ * @param x a sum of at most 7 reduced values
+ * @param y a reduced value
+ * @return a value less than \f$2^{65}\f$.
+ */
+inline u128 MulFold(u64 x, u64 y) {
+  const u128 z = (u128)x * y;
+  return (z & frn::lib::math::Mp61::kPrime) + (z >> 61);
+}
+
+/**
+ * @brief Reduce a sum of values returned by MulFold.
+ */
+inline Field Reduce(u128 acc) {
+  return Field(((u64)acc & frn::lib::math::Mp61::kPrime) + (u64)(acc >> 61));
+}
+
+}  // namespace generated
+
+/**
+ * @brief Find a generated multiplication kernel for a configuration.
+ *
+ * Kernels are generated at build time for the numbers of parties listed in
+ * the FRN_GENERATED_PARTIES CMake option, with t = (n - 1) / 3.
+ *
+ * @param n the number of parties
+ * @param t the threshold
+ * @param id the ID of the party
+ * @return the kernel, or nullptr if none was generated.
+ */
+FixedMultiplyKernel FindGeneratedMultiplyKernel(std::size_t n, std::size_t t,
+                                                std::size_t id);
+
+}  // namespace frn
+
+#endif  // _FRN_GENERATED_H
@@ -1,16 +1,19 @@
 #include "frn/input.h"
 
 std::vector<std::vector<frn::Shr>> frn::Input::Run() {
-  START_TIMER(Input_send);
-  for (std::size_t i = 0; i < mSize; i++) {
-    if (mSharesToDistibute.size()) {
-      // not a proper broadcast.
-      mNetwork->Send(i, mSharesToDistibute);
+  TRACE_SPAN("Input::Run");
+  TRACE_COUNT(eElements, mSharesToDistibute.size());
+  {
+    TRACE_SPAN("send");
+    for (std::size_t i = 0; i < mSize; i++) {
+      if (mSharesToDistibute.size()) {
+        // not a proper broadcast.
+        mNetwork->Send(i, mSharesToDistibute);
+      }
     }
   }
-  STOP_TIMER(Input_send);
 
-  START_TIMER(Input_recv_add_constant);
+  TRACE_SPAN("receive_add_constant");
   std::vector<std::vector<Shr>> output(mSize);
   for (std::size_t i = 0; i < mSize; i++) {
     std::vector<frn::Shr> masked_shares = mSharesToReceive[i];
@@ -21,7 +24,6 @@ std::vector<std::vector<frn::Shr>> frn::Input::Run() {
           mManipulator.AddConstant(masked_shares[j], masked[j]));
     }
   }
-  STOP_TIMER(Input_recv_add_constant);
 
   return output;
 }
@@ -35,9 +35,10 @@ class Input {
    * @param secret the value we wish to input
    */
   void Prepare(const Field& secret) {
-    auto mask = mCorrelator.GetMask();
+    auto mask_share = mCorrelator.GetMaskShare(mId);
+    auto mask = frn::lib::math::vector::Sum(mask_share);
     mSharesToDistibute.emplace_back(secret - mask);
-    PrepareToReceive(mId);
+    mSharesToReceive[mId].emplace_back(mask_share);
   };
 
   void Prepare(const std::vector<Field>& secrets) {
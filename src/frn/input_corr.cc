@@ -1,13 +1,12 @@
 #include "frn/input_corr.h"
-#include "frn/lib/secret_sharing/additive.h"
 
 #include <algorithm>
 #include <iostream>
 
 frn::Field frn::GetRandomElement(frn::lib::primitives::PRG& prg) {
-  unsigned char buffer[Field::ByteSize()] = {0};
-  prg.Next(buffer, Field::ByteSize());
-  return Field::FromBytes(buffer);
+  Field element;
+  prg.NextFields(&element, 1);
+  return element;
 }
 
 frn::lib::primitives::PRG frn::FieldElementToPrg(const frn::Field& element) {
@@ -21,38 +20,48 @@ frn::lib::primitives::PRG frn::FieldElementToPrg(const frn::Field& element) {
 }
 
 frn::InputSetup::Correlator frn::InputSetup::Run() {
-  auto k = GetRandomElement(mPrg);
-  auto copy = mPrg;
-  auto size = mNetwork->Size();
-  auto shr_k = mReplicator.Share(k, mPrg);
-  auto add_k = frn::lib::secret_sharing::ShareAdditive(k, size, copy);
+  TRACE_SPAN("InputSetup::Run");
+  const unsigned id = mNetwork->Id();
+  const auto size = mNetwork->Size();
+  const auto& index_set = mReplicator.IndexSetFor(id);
+  const auto share_size = mReplicator.ShareSize();
 
-  for (std::size_t i = 0; i < size; i++) {
-    mNetwork->SendShares(i, {shr_k[i]});
+  // sample the keys of the sets this party deals, and send each to the other
+  // members of its set.
+  std::vector<Field> keys(share_size);
+  std::vector<std::vector<Field>> to_send(size);
+  for (std::size_t k = 0; k < share_size; k++) {
+    if (KeyDealer(mReplicator, index_set[k]) != id) continue;
+    keys[k] = GetRandomElement(mPrg);
+    for (auto party : mReplicator.Combination(index_set[k]))
+      if ((unsigned)party != id) to_send[party].emplace_back(keys[k]);
   }
+  for (std::size_t i = 0; i < size; i++)
+    if (to_send[i].size()) mNetwork->Send(i, to_send[i]);
 
-  std::vector<Shr> shares_k(size);
+  // keys from other dealers arrive in the order of the index sets.
+  std::vector<std::vector<std::size_t>> to_receive(size);
+  for (std::size_t k = 0; k < share_size; k++) {
+    const auto dealer = KeyDealer(mReplicator, index_set[k]);
+    if (dealer != id) to_receive[dealer].emplace_back(k);
+  }
   for (std::size_t i = 0; i < size; i++) {
-    shares_k[i] = mNetwork->RecvShares(i, 1)[0];
+    if (to_receive[i].empty()) continue;
+    const auto received = mNetwork->Recv(i, to_receive[i].size());
+    for (std::size_t j = 0; j < received.size(); j++)
+      keys[to_receive[i][j]] = received[j];
   }
 
-  std::vector<frn::lib::primitives::PRG> my_prg;
-  my_prg.reserve(add_k.size());
-  for (const auto& s: add_k)
-    my_prg.emplace_back(FieldElementToPrg(s));
-
-  auto share_size = mReplicator.ShareSize();
-  std::vector<std::vector<frn::lib::primitives::PRG>> other_prgs;
-  other_prgs.reserve(size);
-  for (std::size_t i = 0; i < size; i++) {
-    std::vector<frn::lib::primitives::PRG> prgs_for_i;
-    prgs_for_i.reserve(share_size);
-    auto share_from_i = shares_k[i];
-    for (const auto& v : share_from_i) {
-      prgs_for_i.emplace_back(FieldElementToPrg(v));
+  // the key of a set gives one PRG for each member's mask.
+  std::vector<std::vector<frn::lib::primitives::PRG>> prgs(size);
+  std::vector<std::vector<unsigned>> elements(size);
+  for (std::size_t k = 0; k < share_size; k++) {
+    auto master = FieldElementToPrg(keys[k]);
+    for (auto party : mReplicator.Combination(index_set[k])) {
+      prgs[party].emplace_back(FieldElementToPrg(GetRandomElement(master)));
+      elements[party].emplace_back(k);
     }
-    other_prgs.emplace_back(prgs_for_i);
   }
 
-  return Correlator(other_prgs, my_prg, share_size);
+  return Correlator(prgs, elements, share_size);
 }
@@ -13,6 +13,20 @@ Field GetRandomElement(frn::lib::primitives::PRG& prg);
 
 frn::lib::primitives::PRG FieldElementToPrg(const Field& element);
 
+/**
+ * @brief Setup of the masks used by Input.
+ *
+ * Every additive component of a replicated sharing belongs to a set of n - t
+ * parties. The parties of each set share a PRG key for the set, which one
+ * member, the dealer of the set, samples and sends to the others. The mask of
+ * party i is then \f$r_i = \sum_{S \ni i} \mathsf{PRG}(K_S, i)\f$, i.e., a
+ * replicated sharing whose components for sets without i are zero. Any t
+ * parties other than i miss the set which is the complement of them, and that
+ * set contains i, so \f$r_i\f$ stays hidden.
+ *
+ * Each key is sent once to each member of its set, instead of every party
+ * sending a full replicated share to every other party.
+ */
 class InputSetup {
  public:
   class Correlator;
@@ -24,37 +38,56 @@ class InputSetup {
 
   InputSetup::Correlator Run();
 
+  /**
+   * @brief The party which samples the key of an additive component.
+   *
+   * Dealers are spread over the members of each set, so that every party
+   * sends about as many keys.
+   *
+   * @param replicator the replicator
+   * @param idx the global index of the additive component
+   * @return the ID of the dealer.
+   */
+  static unsigned KeyDealer(
+      const frn::lib::secret_sharing::Replicator<Field>& replicator,
+      std::size_t idx) {
+    const auto& set = replicator.Combination(idx);
+    return set[idx % set.size()];
+  };
+
   class Correlator {
    public:
-    Correlator(std::vector<std::vector<frn::lib::primitives::PRG>> prgs,
-               std::vector<frn::lib::primitives::PRG> prg, std::size_t share_size)
-        : mPrgs(prgs), mPrg(prg), mShareSize(share_size){};
-
     /**
-     * @brief Returns r_j where j is this party's ID.
+     * @brief Create a correlator.
+     * @param prgs prgs[i][k] generates element elements[i][k] of the shares
+     * of the masks of party i.
+     * @param elements the elements of this party's share which belong to a set
+     * containing party i, for each i.
+     * @param share_size the size of a share
      */
-    Field GetMask() {
-      frn::Field v;
-      for (auto& prg : mPrg) v += GetRandomElement(prg);
-      return v;
-    };
+    Correlator(std::vector<std::vector<frn::lib::primitives::PRG>> prgs,
+               std::vector<std::vector<unsigned>> elements,
+               std::size_t share_size)
+        : mPrgs(prgs), mElements(elements), mShareSize(share_size){};
 
     /**
-     * @brief Returns [r_id] for some id.
+     * @brief Returns [r_id] for some id, for the next input of party id.
+     *
+     * Party id itself holds every non-zero component of its mask, so r_id is
+     * the sum of the elements of its own share.
+     *
      * @param id the id
      */
     Shr GetMaskShare(unsigned id) {
-      std::vector<frn::Field> share;
-      share.reserve(mShareSize);
-      auto prg_id = mPrgs[id];
-      for (std::size_t i = 0; i < mShareSize; i++)
-        share.emplace_back(GetRandomElement(prg_id[i]));
+      Shr share(mShareSize, Field(0));
+      for (std::size_t k = 0; k < mElements[id].size(); k++)
+        share[mElements[id][k]] = GetRandomElement(mPrgs[id][k]);
       return share;
     };
 
    private:
     std::vector<std::vector<frn::lib::primitives::PRG>> mPrgs;
-    std::vector<frn::lib::primitives::PRG> mPrg;
+    std::vector<std::vector<unsigned>> mElements;
     std::size_t mShareSize;
   };
 
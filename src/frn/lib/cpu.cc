@@ -0,0 +1,83 @@
+#include "frn/lib/cpu.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+
+using Level = frn::lib::cpu::Level;
+
+namespace {
+
+Level initial_level() {
+  auto level = frn::lib::cpu::Detect();
+  const char *cap = std::getenv(CPU_ENV_VARIABLE);
+  if (cap && *cap) {
+    auto requested = frn::lib::cpu::ParseLevel(cap);
+    if (requested < level) level = requested;
+  }
+  return level;
+}
+
+std::atomic<Level> &current_level() {
+  static std::atomic<Level> level(initial_level());
+  return level;
+}
+
+}  // namespace
+
+Level frn::lib::cpu::Detect() {
+  static const Level level = []() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Level::eAvx512;
+    if (__builtin_cpu_supports("avx2")) return Level::eAvx2;
+    if (__builtin_cpu_supports("sse4.2")) return Level::eSse42;
+    return Level::eGeneric;
+  }();
+  return level;
+}
+
+bool frn::lib::cpu::HasAes() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("aes");
+}
+
+bool frn::lib::cpu::HasVaes() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("vaes");
+}
+
+bool frn::lib::cpu::HasIfma() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx512ifma");
+}
+
+Level frn::lib::cpu::Current() {
+  return current_level().load(std::memory_order_relaxed);
+}
+
+Level frn::lib::cpu::Override(Level level) {
+  if (level > Detect()) level = Detect();
+  current_level().store(level, std::memory_order_relaxed);
+  return level;
+}
+
+std::string frn::lib::cpu::ToString(Level level) {
+  switch (level) {
+    case Level::eGeneric:
+      return "generic";
+    case Level::eSse42:
+      return "sse4.2";
+    case Level::eAvx2:
+      return "avx2";
+    case Level::eAvx512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+Level frn::lib::cpu::ParseLevel(const std::string &name) {
+  for (auto level :
+       {Level::eGeneric, Level::eSse42, Level::eAvx2, Level::eAvx512})
+    if (ToString(level) == name) return level;
+  throw std::invalid_argument("unknown CPU level: " + name);
+}
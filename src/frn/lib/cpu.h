@@ -0,0 +1,111 @@
+#ifndef _FRN_LIB_CPU_H
+#define _FRN_LIB_CPU_H
+
+#include <string>
+
+/**
+ * @brief Name of the environment variable which caps the instruction set used
+ * by dispatched kernels, e.g., <code>FRN_CPU=avx2</code>.
+ */
+#define CPU_ENV_VARIABLE "FRN_CPU"
+
+namespace frn::lib {
+
+/**
+ * @brief Runtime CPU dispatch.
+ *
+ * Hot kernels (the PRG, Keccak and batch arithmetic over Mp61) are compiled in
+ * several variants, one per instruction set Level. The best variant the host
+ * supports is chosen at startup, so a single binary runs everywhere and still
+ * uses AVX-512 where available.
+ */
+namespace cpu {
+
+/**
+ * @brief Instruction set levels for which kernels have variants.
+ */
+enum class Level {
+  //! Plain x86-64.
+  eGeneric,
+  //! SSE4.2.
+  eSse42,
+  //! AVX2.
+  eAvx2,
+  //! AVX-512 (F).
+  eAvx512
+};
+
+/**
+ * @brief The highest level supported by the host.
+ */
+Level Detect();
+
+/**
+ * @brief Whether the host supports AES-NI.
+ */
+bool HasAes();
+
+/**
+ * @brief Whether the host supports vector AES instructions (VAES).
+ */
+bool HasVaes();
+
+/**
+ * @brief Whether the host supports AVX-512 52-bit integer multiply-add (IFMA).
+ */
+bool HasIfma();
+
+/**
+ * @brief The level kernels are currently dispatched to.
+ *
+ * Defaults to Detect(), capped by the level named in the FRN_CPU environment
+ * variable if set.
+ */
+Level Current();
+
+/**
+ * @brief Dispatch kernels to a different level, e.g., to compare variants.
+ *
+ * @param level the new level. Capped at Detect().
+ * @return the level in effect.
+ */
+Level Override(Level level);
+
+/**
+ * @brief Name of a level, e.g., "avx2".
+ */
+std::string ToString(Level level);
+
+/**
+ * @brief Parse the name of a level, as returned by ToString.
+ * @throws std::invalid_argument if the name is unknown.
+ */
+Level ParseLevel(const std::string &name);
+
+/**
+ * @brief Pick the variant of a kernel for a level.
+ *
+ * @param level the level
+ * @param generic the plain x86-64 variant
+ * @param sse42 the SSE4.2 variant
+ * @param avx2 the AVX2 variant
+ * @param avx512 the AVX-512 variant
+ */
+template <typename F>
+F Select(Level level, F generic, F sse42, F avx2, F avx512) {
+  switch (level) {
+    case Level::eAvx512:
+      return avx512;
+    case Level::eAvx2:
+      return avx2;
+    case Level::eSse42:
+      return sse42;
+    default:
+      return generic;
+  }
+}
+
+}  // namespace cpu
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_CPU_H
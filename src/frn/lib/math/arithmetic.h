@@ -1,6 +1,7 @@
 #ifndef _FRN_LIB_MATH_ARITHMETIC_H
 #define _FRN_LIB_MATH_ARITHMETIC_H
 
+#include <cstdint>
 #include <stdexcept>
 #include <type_traits>
 
@@ -130,10 +131,58 @@ inline T inv2(const T &v) {
 
 /**
  * @brief \f$x \cdot y \mod n\f$.
+ *
+ * Only defined for the Mersenne primes below, where n is \f$2^{31} - 1\f$,
+ * \f$2^{61} - 1\f$ or \f$2^{127} - 1\f$ depending on the type. The
+ * definitions are inline, as multiplication is on the hot path of everything.
  */
 template <typename T>
 T mulm(const T &x, const T &y, const T &n);
 
+template <>
+inline std::uint32_t mulm(const std::uint32_t &x, const std::uint32_t &y,
+                          const std::uint32_t &n) {
+  const std::uint64_t z = (std::uint64_t)x * y;
+  const std::uint32_t a = z >> 31;
+  const std::uint32_t b = z & n;
+  return addm(a, b, n);
+}
+
+template <>
+inline std::uint64_t mulm(const std::uint64_t &x, const std::uint64_t &y,
+                          const std::uint64_t &n) {
+  const __uint128_t z = (__uint128_t)x * y;
+  std::uint64_t a = z >> 61;
+  std::uint64_t b = (std::uint64_t)z;
+
+  a |= b >> 61;
+  b &= n;
+
+  return addm(a, b, n);
+}
+
+// With x = x1 * 2^64 + x0 and y = y1 * 2^64 + y0, where x1, y1 < 2^63,
+//   x * y = x1 * y1 * 2^128 + m * 2^64 + x0 * y0
+//         = 2 * x1 * y1 + (m >> 63) + (m mod 2^63) * 2^64 + x0 * y0  mod p,
+// for m = x1 * y0 + x0 * y1, since 2^127 = 1. Each term is below 2^128, so no
+// 256-bit product and carry chain is needed.
+template <>
+inline __uint128_t mulm(const __uint128_t &x, const __uint128_t &y,
+                        const __uint128_t &n) {
+  using u128 = __uint128_t;
+  const std::uint64_t x0 = x, x1 = x >> 64;
+  const std::uint64_t y0 = y, y1 = y >> 64;
+  const u128 lo = (u128)x0 * y0;
+  const u128 mid = (u128)x1 * y0 + (u128)x0 * y1;
+  const u128 hi = (u128)x1 * y1;
+
+  u128 r = (lo & n) + (lo >> 127) + (hi << 1);
+  r = (r & n) + (r >> 127);
+  r += (mid >> 63) + ((mid & (n >> 64)) << 64);
+  r = (r & n) + (r >> 127);
+  return r >= n ? r - n : r;
+}
+
 }  // namespace details
 }  // namespace math
 }  // namespace frn::lib
@@ -0,0 +1,286 @@
+#ifndef _FRN_LIB_MATH_EXTENSION_H
+#define _FRN_LIB_MATH_EXTENSION_H
+
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+#include "frn/lib/math/fp.h"
+#include "frn/lib/math/ring.h"
+
+namespace frn::lib {
+namespace math {
+
+namespace details {
+
+/**
+ * @brief Returns true if FpExtension supports degree k over
+ * \f$\mathbb{F}_p\f$.
+ *
+ * \f$x^k - g\f$ is irreducible for a generator \f$g\f$ of the
+ * multiplicative group as soon as every prime factor of k divides
+ * \f$p - 1\f$ (and \f$p = 1 \bmod 4\f$ if 4 divides k), but the Frobenius
+ * map of FpExtension also needs a k'th root of unity in \f$\mathbb{F}_p\f$,
+ * so k itself must divide \f$p - 1\f$. This implies both conditions.
+ */
+template <typename U>
+constexpr bool IsBinomialExtension(U p, std::size_t k) {
+  return k >= 2 && (p - 1) % k == 0;
+}
+
+}  // namespace details
+
+/**
+ * @brief The field \f$\mathbb{F}_{p^K} = \mathbb{F}_p[x] / (x^K - g)\f$.
+ *
+ * \f$g\f$ is <code>Prime::kGenerator</code>. A small prime such as Mp31 makes
+ * for cheap arithmetic, but a random challenge in \f$\mathbb{F}_p\f$ only gives
+ * \f$\log p\f$ bits of soundness. Taking challenges from the extension gives
+ * \f$K \log p\f$ bits, while values stay in \f$\mathbb{F}_p\f$, which is
+ * embedded as the constant polynomials.
+ *
+ * @tparam Prime the prime. Must define <code>kGenerator</code>.
+ * @tparam K the degree of the extension. Must divide \f$p - 1\f$.
+ */
+template <typename Prime, std::size_t K>
+class FpExtension : RingElement<FpExtension<Prime, K>> {
+  static_assert(details::IsBinomialExtension(Prime::kPrime, K),
+                "K must divide kPrime - 1.");
+
+ public:
+  /**
+   * @brief Type of a coefficient.
+   */
+  using BaseType = FpElement<Prime>;
+
+  /**
+   * @brief Additive neutral element.
+   */
+  static const FpExtension kZero;
+
+  /**
+   * @brief Multiplicative neutral element.
+   */
+  static const FpExtension kOne;
+
+  /**
+   * @brief The degree of the extension.
+   */
+  static constexpr std::size_t Degree() { return K; };
+
+  /**
+   * @brief Size of an element in bytes.
+   */
+  static constexpr std::size_t ByteSize() { return K * BaseType::ByteSize(); };
+
+  /**
+   * @brief Construct a new element from a series of bytes.
+   *
+   * @pre <code>buffer</code> must point to at least <code>ByteSize()</code>
+   * bytes of memory.
+   */
+  static FpExtension FromBytes(const unsigned char *buffer) {
+    FpExtension element;
+    for (std::size_t i = 0; i < K; i++)
+      element.mCoefficients[i] =
+          BaseType::FromBytes(buffer + i * BaseType::ByteSize());
+    return element;
+  };
+
+  /**
+   * @brief Construct the zero element.
+   */
+  FpExtension() : mCoefficients{} {};
+
+  /**
+   * @brief Embed an element of the base field.
+   */
+  explicit FpExtension(const BaseType &constant) : mCoefficients{} {
+    mCoefficients[0] = constant;
+  };
+
+  /**
+   * @brief Construct an element from its coefficients, lowest degree first.
+   */
+  explicit FpExtension(const std::array<BaseType, K> &coefficients)
+      : mCoefficients(coefficients){};
+
+  /**
+   * @brief The coefficient of \f$x^i\f$.
+   */
+  const BaseType &operator[](std::size_t i) const { return mCoefficients[i]; };
+
+  /**
+   * @brief Set element to its additive negative.
+   */
+  FpExtension &Negate() {
+    for (auto &c : mCoefficients) c.Negate();
+    return *this;
+  };
+
+  /**
+   * @brief Applies the Frobenius map \f$a \mapsto a^{p^j}\f$.
+   *
+   * Since \f$x^p = \zeta x\f$ for the K'th root of unity
+   * \f$\zeta = g^{(p - 1) / K}\f$, this scales the coefficient of \f$x^i\f$ by
+   * \f$\zeta^{ij}\f$.
+   */
+  FpExtension Frobenius(std::size_t j) const {
+    const auto &roots = RootsOfUnity();
+    FpExtension result;
+    for (std::size_t i = 0; i < K; i++)
+      result.mCoefficients[i] = mCoefficients[i] * roots[(i * j) % K];
+    return result;
+  };
+
+  /**
+   * @brief Set element to its multiplicative inverse.
+   *
+   * The product \f$b\f$ of the conjugates \f$a^{p^j}\f$ for \f$0 < j < K\f$
+   * makes \f$ab\f$ the norm of \f$a\f$, which lies in the base field, so
+   * \f$a^{-1} = b / (ab)\f$ with a single inversion in the base field.
+   *
+   * @throws std::logic_error if this element is zero.
+   */
+  FpExtension &Invert() {
+    if (Equal(kZero)) throw std::logic_error("zero has no inverse");
+    FpExtension b = Frobenius(1);
+    for (std::size_t j = 2; j < K; j++) b *= Frobenius(j);
+    const auto norm_inverse = (*this * b)[0].Inverse();
+    for (std::size_t i = 0; i < K; i++)
+      mCoefficients[i] = b[i] * norm_inverse;
+    return *this;
+  };
+
+  /**
+   * @brief Return the multiplicative inverse of this element.
+   *
+   * @throws std::logic_error if this element is zero.
+   */
+  FpExtension Inverse() const {
+    FpExtension copy(*this);
+    return copy.Invert();
+  };
+
+  /**
+   * @brief Add another element to this.
+   */
+  FpExtension &operator+=(const FpExtension &other) {
+    for (std::size_t i = 0; i < K; i++) mCoefficients[i] += other[i];
+    return *this;
+  };
+
+  /**
+   * @brief Subtract another element from this.
+   */
+  FpExtension &operator-=(const FpExtension &other) {
+    for (std::size_t i = 0; i < K; i++) mCoefficients[i] -= other[i];
+    return *this;
+  };
+
+  /**
+   * @brief Multiply another element onto this.
+   */
+  FpExtension &operator*=(const FpExtension &other) {
+    std::array<BaseType, 2 * K - 1> product{};
+    for (std::size_t i = 0; i < K; i++)
+      for (std::size_t j = 0; j < K; j++)
+        product[i + j] += mCoefficients[i] * other[j];
+
+    // x^K = g.
+    const BaseType g(Prime::kGenerator);
+    for (std::size_t i = 0; i < K - 1; i++)
+      mCoefficients[i] = product[i] + g * product[i + K];
+    mCoefficients[K - 1] = product[K - 1];
+    return *this;
+  };
+
+  /**
+   * @brief Multiply this by the inverse of other.
+   *
+   * @throws std::logic_error if other is zero.
+   */
+  FpExtension &operator/=(const FpExtension &other) {
+    return *this *= other.Inverse();
+  };
+
+  /**
+   * @brief Returns true if this and other are equal.
+   */
+  bool Equal(const FpExtension &other) const {
+    return mCoefficients == other.mCoefficients;
+  };
+
+  /**
+   * @brief Returns true if this and other are not equal.
+   */
+  bool NotEqual(const FpExtension &other) const { return !Equal(other); };
+
+  /**
+   * @brief write this element into a buffer.
+   *
+   * @pre <code>buffer</code> must point to <code>ByteSize()</code> bytes of
+   * free space.
+   */
+  void ToBytes(unsigned char *dest) const {
+    for (std::size_t i = 0; i < K; i++)
+      mCoefficients[i].ToBytes(dest + i * BaseType::ByteSize());
+  };
+
+  /**
+   * @brief << overload.
+   */
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const FpExtension &element) {
+    return os << element.ToString();
+  };
+
+  /**
+   * @brief Returns a string representation of this element, lowest degree
+   * coefficient first.
+   */
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << "[";
+    for (std::size_t i = 0; i < K; i++)
+      ss << (i ? ", " : "") << mCoefficients[i].ToString();
+    ss << "]";
+    return ss.str();
+  };
+
+ private:
+  /**
+   * @brief The powers \f$\zeta^i\f$ for \f$i < K\f$ of the K'th root of unity
+   * \f$\zeta = g^{(p - 1) / K}\f$.
+   */
+  static const std::array<BaseType, K> &RootsOfUnity() {
+    static const auto roots = [] {
+      BaseType zeta = BaseType::kOne;
+      BaseType base(Prime::kGenerator);
+      for (auto e = (Prime::kPrime - 1) / K; e; e >>= 1) {
+        if (e & 1) zeta *= base;
+        base *= base;
+      }
+      std::array<BaseType, K> powers;
+      powers[0] = BaseType::kOne;
+      for (std::size_t i = 1; i < K; i++) powers[i] = powers[i - 1] * zeta;
+      return powers;
+    }();
+    return roots;
+  };
+
+  std::array<BaseType, K> mCoefficients;
+};
+
+template <typename Prime, std::size_t K>
+const FpExtension<Prime, K> FpExtension<Prime, K>::kZero =
+    FpExtension<Prime, K>();
+template <typename Prime, std::size_t K>
+const FpExtension<Prime, K> FpExtension<Prime, K>::kOne =
+    FpExtension<Prime, K>(FpElement<Prime>::kOne);
+
+}  // namespace math
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_MATH_EXTENSION_H
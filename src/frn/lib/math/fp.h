@@ -2,6 +2,7 @@
 #define _FRN_LIB_MATH_FPELEMENT_H
 
 #include <cstring>
+#include <stdexcept>
 
 #include "frn/lib/math/ring.h"
 #include "frn/lib/tools.h"
@@ -77,6 +78,21 @@ class FpElement : RingElement<FpElement<Prime>> {
    */
   static constexpr std::size_t BitSize() { return 8 * ByteSize(); };
 
+  /**
+   * @brief Number of bits needed to represent every element, i.e., the bit
+   * length of \f$p - 1\f$.
+   */
+  static constexpr std::size_t PackedBitSize() {
+    std::size_t bits = 0;
+    for (auto v = Prime::kPrime - 1; v; v >>= 1) bits++;
+    return bits;
+  };
+
+  /**
+   * @brief The prime \f$p\f$.
+   */
+  static constexpr ValueType Modulus() { return Prime::kPrime; };
+
   // LCOV_EXCL_START
 
   /**
@@ -105,6 +121,11 @@ class FpElement : RingElement<FpElement<Prime>> {
    */
   explicit FpElement(const ValueType &value) { mValue = Prime::Reduce(value); };
 
+  /**
+   * @brief The value of this element, i.e., an integer less than the prime.
+   */
+  const ValueType &Value() const { return mValue; };
+
   /**
    * @brief Set element to its additive negative.
    */
@@ -130,6 +151,19 @@ class FpElement : RingElement<FpElement<Prime>> {
    */
   FpElement Inverse() const { return FpElement(Prime::Invert(mValue)); };
 
+  /**
+   * @brief Return the modular inverse of this element, computed in time
+   * independent of its value.
+   *
+   * @throws std::logic_error if this FpElement is 0.
+   */
+  FpElement InverseConstantTime() const {
+    if (mValue == 0) throw std::logic_error("0 is not invertible mod p.");
+    FpElement inverse;
+    inverse.mValue = Prime::InvertConstantTime(mValue);
+    return inverse;
+  };
+
   /**
    * @brief Add another element to this.
    */
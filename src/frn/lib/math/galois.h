@@ -0,0 +1,248 @@
+#ifndef _FRN_LIB_MATH_GALOIS_H
+#define _FRN_LIB_MATH_GALOIS_H
+
+#include <array>
+#include <cstdint>
+#include <sstream>
+
+#include "frn/lib/math/ring.h"
+#include "frn/lib/math/z2k.h"
+
+namespace frn::lib {
+namespace math {
+
+namespace details {
+
+/**
+ * @brief The lower terms of a monic polynomial of degree d which is
+ * irreducible modulo 2, as a bit mask, or 0 if none is listed.
+ *
+ * Bit j is set if \f$x^j\f$ is a term. The polynomials are the trinomials and
+ * pentanomials of lowest weight for each degree.
+ */
+constexpr std::uint64_t GaloisModulus(std::size_t d) {
+  switch (d) {
+    case 2:
+    case 3:
+    case 4:
+    case 6:
+    case 7:
+      return 0x3;  // x^d + x + 1
+    case 5:
+      return 0x5;  // x^5 + x^2 + 1
+    case 8:
+      return 0x1B;  // x^8 + x^4 + x^3 + x + 1
+    case 16:
+      return 0x2B;  // x^16 + x^5 + x^3 + x + 1
+    case 32:
+      return 0x8D;  // x^32 + x^7 + x^3 + x^2 + 1
+    case 40:
+      return 0x39;  // x^40 + x^5 + x^4 + x^3 + 1
+    case 48:
+      return 0x2D;  // x^48 + x^5 + x^3 + x^2 + 1
+    case 64:
+      return 0x1B;  // x^64 + x^4 + x^3 + x + 1
+    default:
+      return 0;
+  }
+}
+
+}  // namespace details
+
+/**
+ * @brief The Galois ring \f$GR(2^K, D) = \mathbb{Z}_{2^K}[x] / f(x)\f$.
+ *
+ * \f$f\f$ is a monic polynomial of degree D which is irreducible modulo 2, so
+ * an element is a unit exactly when one of its coefficients is odd, and a
+ * uniformly random element is a zero divisor with probability \f$2^{-D}\f$.
+ * This makes the ring suitable for sampling the coefficients of random linear
+ * combinations of \f$\mathbb{Z}_{2^K}\f$ elements, where coefficients from
+ * \f$\mathbb{Z}_{2^K}\f$ itself are zero divisors half of the time.
+ *
+ * \f$\mathbb{Z}_{2^K}\f$ is embedded as the constant polynomials. Division is
+ * not supported.
+ *
+ * @tparam K the bit length of the coefficients.
+ * @tparam D the degree of the extension.
+ */
+template <std::size_t K, std::size_t D>
+class GaloisRingElement : RingElement<GaloisRingElement<K, D>> {
+  static_assert(details::GaloisModulus(D) != 0,
+                "no irreducible polynomial is listed for this degree.");
+
+ public:
+  /**
+   * @brief Type of a coefficient.
+   */
+  using BaseType = Z2kElement<K>;
+
+  /**
+   * @brief Additive neutral element.
+   */
+  static const GaloisRingElement kZero;
+
+  /**
+   * @brief Multiplicative neutral element.
+   */
+  static const GaloisRingElement kOne;
+
+  /**
+   * @brief The degree of the extension.
+   */
+  static constexpr std::size_t Degree() { return D; };
+
+  /**
+   * @brief Size of an element in bytes.
+   */
+  static constexpr std::size_t ByteSize() { return D * BaseType::ByteSize(); };
+
+  /**
+   * @brief Construct a new element from a series of bytes.
+   *
+   * @pre <code>buffer</code> must point to at least <code>ByteSize()</code>
+   * bytes of memory.
+   */
+  static GaloisRingElement FromBytes(const unsigned char *buffer) {
+    GaloisRingElement element;
+    for (std::size_t i = 0; i < D; i++)
+      element.mCoefficients[i] =
+          BaseType::FromBytes(buffer + i * BaseType::ByteSize());
+    return element;
+  };
+
+  /**
+   * @brief Construct the zero element.
+   */
+  GaloisRingElement() : mCoefficients{} {};
+
+  /**
+   * @brief Embed an element of \f$\mathbb{Z}_{2^K}\f$.
+   */
+  explicit GaloisRingElement(const BaseType &constant) : mCoefficients{} {
+    mCoefficients[0] = constant;
+  };
+
+  /**
+   * @brief Construct an element from its coefficients, lowest degree first.
+   */
+  explicit GaloisRingElement(const std::array<BaseType, D> &coefficients)
+      : mCoefficients(coefficients){};
+
+  /**
+   * @brief The coefficient of \f$x^i\f$.
+   */
+  const BaseType &operator[](std::size_t i) const { return mCoefficients[i]; };
+
+  /**
+   * @brief Returns true if this element has a multiplicative inverse.
+   */
+  bool IsUnit() const {
+    for (const auto &c : mCoefficients)
+      if (c.Value() & 1) return true;
+    return false;
+  };
+
+  /**
+   * @brief Set element to its additive negative.
+   */
+  GaloisRingElement &Negate() {
+    for (auto &c : mCoefficients) c.Negate();
+    return *this;
+  };
+
+  /**
+   * @brief Add another element to this.
+   */
+  GaloisRingElement &operator+=(const GaloisRingElement &other) {
+    for (std::size_t i = 0; i < D; i++) mCoefficients[i] += other[i];
+    return *this;
+  };
+
+  /**
+   * @brief Subtract another element from this.
+   */
+  GaloisRingElement &operator-=(const GaloisRingElement &other) {
+    for (std::size_t i = 0; i < D; i++) mCoefficients[i] -= other[i];
+    return *this;
+  };
+
+  /**
+   * @brief Multiply another element onto this.
+   */
+  GaloisRingElement &operator*=(const GaloisRingElement &other) {
+    // products are computed modulo 2^64, which the mask of the coefficients
+    // reduces to 2^K at the end.
+    constexpr auto kModulus = details::GaloisModulus(D);
+    std::uint64_t product[2 * D - 1] = {};
+    for (std::size_t i = 0; i < D; i++)
+      for (std::size_t j = 0; j < D; j++)
+        product[i + j] += mCoefficients[i].Value() * other[j].Value();
+
+    // x^D = -(lower terms of f).
+    for (std::size_t i = 2 * D - 2; i >= D; i--)
+      for (std::size_t j = 0; j < D; j++)
+        if ((kModulus >> j) & 1) product[i - D + j] -= product[i];
+
+    for (std::size_t i = 0; i < D; i++) mCoefficients[i] = BaseType(product[i]);
+    return *this;
+  };
+
+  /**
+   * @brief Returns true if this and other are equal.
+   */
+  bool Equal(const GaloisRingElement &other) const {
+    return mCoefficients == other.mCoefficients;
+  };
+
+  /**
+   * @brief Returns true if this and other are not equal.
+   */
+  bool NotEqual(const GaloisRingElement &other) const { return !Equal(other); };
+
+  /**
+   * @brief write this element into a buffer.
+   *
+   * @pre <code>buffer</code> must point to <code>ByteSize()</code> bytes of
+   * free space.
+   */
+  void ToBytes(unsigned char *dest) const {
+    for (std::size_t i = 0; i < D; i++)
+      mCoefficients[i].ToBytes(dest + i * BaseType::ByteSize());
+  };
+
+  /**
+   * @brief << overload.
+   */
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const GaloisRingElement &element) {
+    return os << element.ToString();
+  };
+
+  /**
+   * @brief Returns a string representation of this element, lowest degree
+   * coefficient first.
+   */
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << "[";
+    for (std::size_t i = 0; i < D; i++)
+      ss << (i ? ", " : "") << mCoefficients[i].ToString();
+    ss << "]";
+    return ss.str();
+  };
+
+ private:
+  std::array<BaseType, D> mCoefficients;
+};
+
+template <std::size_t K, std::size_t D>
+const GaloisRingElement<K, D> GaloisRingElement<K, D>::kZero =
+    GaloisRingElement<K, D>();
+template <std::size_t K, std::size_t D>
+const GaloisRingElement<K, D> GaloisRingElement<K, D>::kOne =
+    GaloisRingElement<K, D>(Z2kElement<K>(1));
+
+}  // namespace math
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_MATH_GALOIS_H
@@ -0,0 +1,671 @@
+#include "frn/lib/math/kernels.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "frn/lib/math/p.h"
+
+// Kernels are written once using GCC vector extensions and inlined into a
+// function per level, which then gets compiled for that instruction set. The
+// non-inlined helpers would pass wide vectors in registers, which GCC warns
+// about, but they never exist in the final object.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+using u32 = std::uint32_t;
+using u64 = std::uint64_t;
+using Mp31 = frn::lib::math::Mp31;
+using Mp61 = frn::lib::math::Mp61;
+using u128 = __uint128_t;
+using Mp127 = frn::lib::math::Mp127;
+
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+typedef u64 v2u64 __attribute__((vector_size(16)));
+typedef u64 v4u64 __attribute__((vector_size(32)));
+typedef u64 v8u64 __attribute__((vector_size(64)));
+
+static constexpr u64 P = Mp61::kPrime;
+static constexpr u64 M29 = (1ULL << 29) - 1;
+static constexpr u64 M32 = (1ULL << 32) - 1;
+
+// number of lanes of a vector type. u64 itself is a vector with one lane.
+template <typename V>
+static constexpr std::size_t lanes = sizeof(V) / sizeof(u64);
+
+template <typename V>
+static ALWAYS_INLINE V load(const void *src) {
+  V v;
+  std::memcpy(&v, src, sizeof(V));
+  return v;
+}
+
+template <typename V>
+static ALWAYS_INLINE void store(void *dest, const V &v) {
+  std::memcpy(dest, &v, sizeof(V));
+}
+
+// x mod p for x < 2^64, up to a multiple of p. The result is below 2^61 + 8.
+template <typename V>
+static ALWAYS_INLINE V fold(const V &x) {
+  return (x & P) + (x >> 61);
+}
+
+// x mod p for x < 2p.
+template <typename V>
+static ALWAYS_INLINE V canonical(const V &x) {
+  return x >= P ? x - P : x;
+}
+
+// the products of the low 32 bits of each lane of x and y. GCC does not see
+// that (x & M32) * (y & M32) needs a single pmuludq, and multiplies all 64
+// bits instead, so each level uses the instruction directly. These are not
+// always_inline, since the templates calling them have no target; they get
+// inlined once the templates are inlined into the kernel of their level.
+static ALWAYS_INLINE u64 mul32(u64 x, u64 y) { return (x & M32) * (y & M32); }
+
+static inline v2u64 mul32(const v2u64 &x, const v2u64 &y) {
+  return (v2u64)_mm_mul_epu32((__m128i)x, (__m128i)y);
+}
+
+__attribute__((target("avx2"))) static inline v4u64 mul32(const v4u64 &x,
+                                                          const v4u64 &y) {
+  return (v4u64)_mm256_mul_epu32((__m256i)x, (__m256i)y);
+}
+
+__attribute__((target("avx512f"))) static inline v8u64 mul32(const v8u64 &x,
+                                                             const v8u64 &y) {
+  // the masked form avoids a spurious -Wuninitialized in GCC's headers.
+  return (v8u64)_mm512_maskz_mul_epu32(0xFF, (__m512i)x, (__m512i)y);
+}
+
+// a vector with x in every lane.
+template <typename V>
+static ALWAYS_INLINE V broadcast(u64 x) {
+  return V{} + x;
+}
+
+// GCC builds V{} + x one lane at a time with AVX-512. Like mul32, this is not
+// always_inline.
+template <>
+__attribute__((target("avx512f"))) inline v8u64 broadcast<v8u64>(u64 x) {
+  return (v8u64)_mm512_maskz_set1_epi64(0xFF, x);
+}
+
+// x * y mod p, up to a multiple of p, for x, y < 2^61 + 8. Each 64 by 64
+// multiplication is split into four 32 by 32 ones which every level supports
+// on vectors (e.g., pmuludq).
+template <typename V>
+static ALWAYS_INLINE V mul_folded(const V &x, const V &y) {
+  const V x1 = x >> 32;
+  const V y1 = y >> 32;
+
+  // x * y = hi * 2^64 + mid * 2^32 + lo, where 2^61 = 1 and 2^64 = 8 mod p.
+  const V lo = mul32(x, y);
+  const V mid = mul32(x, y1) + mul32(x1, y);
+  const V hi = mul32(x1, y1);
+
+  const V r = (lo & P) + (lo >> 61) + (hi << 3) + ((mid & M29) << 32) +
+              (mid >> 29);
+  return fold(r);
+}
+
+template <typename V>
+static ALWAYS_INLINE void add_into(u64 *x, const u64 *y, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + lanes<V> <= n; i += lanes<V>)
+    store(x + i, canonical(load<V>(x + i) + load<V>(y + i)));
+  for (; i < n; i++) x[i] = canonical(x[i] + y[i]);
+}
+
+template <typename V>
+static ALWAYS_INLINE void subtract_into(u64 *x, const u64 *y, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + lanes<V> <= n; i += lanes<V>)
+    store(x + i, canonical(load<V>(x + i) + P - load<V>(y + i)));
+  for (; i < n; i++) x[i] = canonical(x[i] + P - y[i]);
+}
+
+template <typename V>
+static ALWAYS_INLINE void multiply_into(u64 *x, const u64 *y, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + lanes<V> <= n; i += lanes<V>)
+    store(x + i, canonical(mul_folded(load<V>(x + i), load<V>(y + i))));
+  for (; i < n; i++) x[i] = canonical(mul_folded(x[i], y[i]));
+}
+
+template <typename V>
+static ALWAYS_INLINE void sum_of_products(u64 *x, const u64 *a, const u64 *b,
+                                          std::size_t stride,
+                                          const unsigned *src_a,
+                                          const unsigned *src_b, std::size_t m,
+                                          std::size_t n) {
+  // several vectors are accumulated per pass over the terms, which keeps the
+  // accumulators in registers and hides the latency of the multiplications.
+  // Consecutive terms with the same a are computed as a * (b + b' + ...), with
+  // at most 7 reduced b's summed so the sum fits in 64 bits.
+  constexpr std::size_t kVectors = 4;
+  constexpr std::size_t kStep = kVectors * lanes<V>;
+  constexpr std::size_t kMaxFactorTerms = 7;
+  std::size_t i = 0;
+  for (; i + kStep <= n; i += kStep) {
+    V acc[kVectors] = {};
+    for (std::size_t k = 0; k < m;) {
+      const u64 *ak = a + src_a[k] * stride + i;
+      V sum[kVectors] = {};
+      const std::size_t end = std::min(m, k + kMaxFactorTerms);
+      do {
+        const u64 *bk = b + src_b[k] * stride + i;
+        for (std::size_t j = 0; j < kVectors; j++)
+          sum[j] += load<V>(bk + j * lanes<V>);
+        k++;
+      } while (k < end && src_a[k] == src_a[k - 1]);
+      for (std::size_t j = 0; j < kVectors; j++)
+        acc[j] = fold(acc[j] +
+                      mul_folded(load<V>(ak + j * lanes<V>), fold(sum[j])));
+    }
+    for (std::size_t j = 0; j < kVectors; j++)
+      store(x + i + j * lanes<V>, canonical(fold(acc[j])));
+  }
+  for (; i < n; i++) {
+    u64 acc = 0;
+    for (std::size_t k = 0; k < m; k++)
+      acc = fold(acc + mul_folded(a[src_a[k] * stride + i],
+                                  b[src_b[k] * stride + i]));
+    x[i] = canonical(fold(acc));
+  }
+}
+
+template <typename V>
+static ALWAYS_INLINE u64 dot(const u64 *x, const u64 *y, std::size_t n) {
+  // the accumulators stay below 2^61 + 8 by folding after each addition.
+  V acc{};
+  std::size_t i = 0;
+  for (; i + lanes<V> <= n; i += lanes<V>)
+    acc = fold(acc + mul_folded(load<V>(x + i), load<V>(y + i)));
+
+  u64 accs[lanes<V>];
+  store(accs, acc);
+  u64 result = 0;
+  for (std::size_t j = 0; j < lanes<V>; j++)
+    result = canonical(result + canonical(fold(accs[j])));
+  for (; i < n; i++)
+    result = canonical(result + canonical(mul_folded(x[i], y[i])));
+  return result;
+}
+
+// Matrix products accumulate the 32 by 32 bit partial products of a * b by
+// their weight, 1, 2^32 and 2^64, without reducing them. The terms of weight
+// 2^64 are below 2^59, so kLazyTerms of them fit in 64 bits before a tile has
+// to reduce its accumulators.
+static constexpr std::size_t kLazyTerms = 32;
+static constexpr u64 M58 = (1ULL << 58) - 1;
+
+// a tile is kTileRows rows of a times kTileDepth rows of b, so that the rows
+// of b used by a column of tiles stay in L1 and the rows of a in L2.
+static constexpr std::size_t kTileRows = 64;
+static constexpr std::size_t kTileDepth = 256;
+
+// c_r += sum_{k < depth} a_{r,k} * b_k, up to a multiple of p, for the R rows
+// of c starting at c and the lanes<V> columns of b starting at b.
+template <typename V, std::size_t R>
+static ALWAYS_INLINE void matmul_tile(u64 *c, std::size_t ldc, const u64 *a,
+                                      std::size_t lda, const u64 *b,
+                                      std::size_t ldb, std::size_t depth) {
+  for (std::size_t k0 = 0; k0 < depth; k0 += kLazyTerms) {
+    const std::size_t k1 = std::min(depth, k0 + kLazyTerms);
+    V c0[R] = {}, c1[R] = {}, c2[R] = {};
+    for (std::size_t k = k0; k < k1; k++) {
+      const V y = load<V>(b + k * ldb);
+#pragma GCC unroll 4
+      for (std::size_t r = 0; r < R; r++) {
+        const V x = broadcast<V>(a[r * lda + k]);
+        const V lo = mul32(x, y);
+        const V mid = mul32(x, y >> 32) + mul32(x >> 32, y);
+        c0[r] += lo & M32;
+        c1[r] += (lo >> 32) + (mid & M32);
+        c2[r] += (mid >> 32) + mul32(x >> 32, y >> 32);
+      }
+    }
+    // 2^32 * c1 and 2^64 * c2 mod p, where 2^61 = 1.
+#pragma GCC unroll 4
+    for (std::size_t r = 0; r < R; r++) {
+      const V t = c0[r] + ((c1[r] & M29) << 32) + (c1[r] >> 29) +
+                  ((c2[r] & M58) << 3) + (c2[r] >> 58);
+      store(c + r * ldc, fold(load<V>(c + r * ldc) + fold(t)));
+    }
+  }
+}
+
+// matmul_tile for every row of c, a few rows at a time.
+template <typename V>
+static ALWAYS_INLINE void matmul_rows(u64 *c, std::size_t ldc, const u64 *a,
+                                      std::size_t lda, const u64 *b,
+                                      std::size_t ldb, std::size_t rows,
+                                      std::size_t depth) {
+  std::size_t i = 0;
+  for (; i + 4 <= rows; i += 4)
+    matmul_tile<V, 4>(c + i * ldc, ldc, a + i * lda, lda, b, ldb, depth);
+  switch (rows - i) {
+    case 3:
+      matmul_tile<V, 3>(c + i * ldc, ldc, a + i * lda, lda, b, ldb, depth);
+      break;
+    case 2:
+      matmul_tile<V, 2>(c + i * ldc, ldc, a + i * lda, lda, b, ldb, depth);
+      break;
+    case 1:
+      matmul_tile<V, 1>(c + i * ldc, ldc, a + i * lda, lda, b, ldb, depth);
+      break;
+  }
+}
+
+template <typename V>
+static ALWAYS_INLINE void matmul(u64 *c, std::size_t ldc, const u64 *a,
+                                 std::size_t lda, const u64 *b,
+                                 std::size_t ldb, std::size_t n, std::size_t p,
+                                 std::size_t m) {
+  for (std::size_t i = 0; i < n; i++)
+    std::fill(c + i * ldc, c + i * ldc + m, 0);
+
+  for (std::size_t k0 = 0; k0 < p; k0 += kTileDepth) {
+    const std::size_t depth = std::min(kTileDepth, p - k0);
+    for (std::size_t i0 = 0; i0 < n; i0 += kTileRows) {
+      const std::size_t rows = std::min(kTileRows, n - i0);
+      u64 *ci = c + i0 * ldc;
+      const u64 *ai = a + i0 * lda + k0;
+      const u64 *bk = b + k0 * ldb;
+      std::size_t j = 0;
+      for (; j + lanes<V> <= m; j += lanes<V>)
+        matmul_rows<V>(ci + j, ldc, ai, lda, bk + j, ldb, rows, depth);
+      for (; j < m; j++)
+        matmul_rows<u64>(ci + j, ldc, ai, lda, bk + j, ldb, rows, depth);
+    }
+  }
+
+  for (std::size_t i = 0; i < n; i++)
+    for (std::size_t j = 0; j < m; j++)
+      c[i * ldc + j] = canonical(fold(c[i * ldc + j]));
+}
+
+// Mp31 kernels work on vectors W of 32-bit lanes. Products are computed on
+// the vector of 64-bit lanes of the same size, wide<W>, one for the even and
+// one for the odd 32-bit lanes.
+
+typedef u32 v2u32 __attribute__((vector_size(8)));
+typedef u32 v4u32 __attribute__((vector_size(16)));
+typedef u32 v8u32 __attribute__((vector_size(32)));
+typedef u32 v16u32 __attribute__((vector_size(64)));
+
+template <typename W>
+struct wide_of;
+template <>
+struct wide_of<v2u32> {
+  using type = u64;
+};
+template <>
+struct wide_of<v4u32> {
+  using type = v2u64;
+};
+template <>
+struct wide_of<v8u32> {
+  using type = v4u64;
+};
+template <>
+struct wide_of<v16u32> {
+  using type = v8u64;
+};
+
+template <typename W>
+using wide = typename wide_of<W>::type;
+
+template <typename W>
+static constexpr std::size_t lanes31 = sizeof(W) / sizeof(u32);
+
+static constexpr u32 P31 = Mp31::kPrime;
+
+// x mod p for x < 2^62, up to a multiple of p. The result is below 2^32.
+template <typename V>
+static ALWAYS_INLINE V fold31(const V &x) {
+  return (x & P31) + (x >> 31);
+}
+
+// x mod p for x < 2p.
+template <typename V>
+static ALWAYS_INLINE V canonical31(const V &x) {
+  return x >= P31 ? x - P31 : x;
+}
+
+// x * y mod p for x, y < p.
+static ALWAYS_INLINE u32 mul31(u32 x, u32 y) {
+  return canonical31(fold31(fold31((u64)x * y)));
+}
+
+// the products of the even and odd lanes of x and y, each below 2^62.
+template <typename W>
+static ALWAYS_INLINE void mul31_wide(const W &x, const W &y, wide<W> &even,
+                                     wide<W> &odd) {
+  const auto xv = load<wide<W>>(&x);
+  const auto yv = load<wide<W>>(&y);
+  even = mul32(xv, yv);
+  odd = mul32(xv >> 32, yv >> 32);
+}
+
+template <typename W>
+static ALWAYS_INLINE W mul31(const W &x, const W &y) {
+  wide<W> even, odd;
+  mul31_wide(x, y, even, odd);
+  even = canonical31(fold31(fold31(even)));
+  odd = canonical31(fold31(fold31(odd)));
+  even |= odd << 32;
+  return load<W>(&even);
+}
+
+template <typename W>
+static ALWAYS_INLINE void add_into31(u32 *x, const u32 *y, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + lanes31<W> <= n; i += lanes31<W>)
+    store(x + i, canonical31(load<W>(x + i) + load<W>(y + i)));
+  for (; i < n; i++) x[i] = canonical31(x[i] + y[i]);
+}
+
+template <typename W>
+static ALWAYS_INLINE void subtract_into31(u32 *x, const u32 *y,
+                                          std::size_t n) {
+  std::size_t i = 0;
+  for (; i + lanes31<W> <= n; i += lanes31<W>)
+    store(x + i, canonical31(load<W>(x + i) + P31 - load<W>(y + i)));
+  for (; i < n; i++) x[i] = canonical31(x[i] + P31 - y[i]);
+}
+
+template <typename W>
+static ALWAYS_INLINE void multiply_into31(u32 *x, const u32 *y,
+                                          std::size_t n) {
+  std::size_t i = 0;
+  for (; i + lanes31<W> <= n; i += lanes31<W>)
+    store(x + i, mul31(load<W>(x + i), load<W>(y + i)));
+  for (; i < n; i++) x[i] = mul31(x[i], y[i]);
+}
+
+template <typename W>
+static ALWAYS_INLINE u32 dot31(const u32 *x, const u32 *y, std::size_t n) {
+  // the accumulator stays below 2^32 by folding after each addition.
+  using V = wide<W>;
+  V acc{};
+  std::size_t i = 0;
+  for (; i + lanes31<W> <= n; i += lanes31<W>) {
+    V even, odd;
+    mul31_wide(load<W>(x + i), load<W>(y + i), even, odd);
+    acc = fold31(acc + fold31(even) + fold31(odd));
+  }
+
+  u64 accs[lanes<V>];
+  store(accs, acc);
+  u32 result = 0;
+  for (std::size_t j = 0; j < lanes<V>; j++)
+    result = canonical31(result + canonical31(fold31(accs[j])));
+  for (; i < n; i++) result = canonical31(result + mul31(x[i], y[i]));
+  return result;
+}
+
+#define DEFINE_KERNELS(name, target, V)                                       \
+  target static void add_into_##name(u64 *x, const u64 *y, std::size_t n) {   \
+    add_into<V>(x, y, n);                                                     \
+  }                                                                           \
+  target static void subtract_into_##name(u64 *x, const u64 *y,               \
+                                          std::size_t n) {                    \
+    subtract_into<V>(x, y, n);                                                \
+  }                                                                           \
+  target static void multiply_into_##name(u64 *x, const u64 *y,               \
+                                          std::size_t n) {                    \
+    multiply_into<V>(x, y, n);                                                \
+  }                                                                           \
+  target static void sum_of_products_##name(                                  \
+      u64 *x, const u64 *a, const u64 *b, std::size_t stride,                 \
+      const unsigned *src_a, const unsigned *src_b, std::size_t m,            \
+      std::size_t n) {                                                        \
+    sum_of_products<V>(x, a, b, stride, src_a, src_b, m, n);                  \
+  }                                                                           \
+  target static u64 dot_##name(const u64 *x, const u64 *y, std::size_t n) {   \
+    return dot<V>(x, y, n);                                                   \
+  }                                                                           \
+  target static void matmul_##name(                                           \
+      u64 *c, std::size_t ldc, const u64 *a, std::size_t lda, const u64 *b,   \
+      std::size_t ldb, std::size_t n, std::size_t p, std::size_t m) {         \
+    matmul<V>(c, ldc, a, lda, b, ldb, n, p, m);                               \
+  }                                                                           \
+  static const frn::lib::math::kernels::Mp61Kernels kernels_##name = {        \
+      add_into_##name, subtract_into_##name, multiply_into_##name,            \
+      sum_of_products_##name, dot_##name, matmul_##name};
+
+DEFINE_KERNELS(generic, , u64)
+DEFINE_KERNELS(sse42, __attribute__((target("sse4.2"))), v2u64)
+DEFINE_KERNELS(avx2, __attribute__((target("avx2"))), v4u64)
+DEFINE_KERNELS(avx512, __attribute__((target("avx512f"))), v8u64)
+
+#undef DEFINE_KERNELS
+
+#define DEFINE_MP31_KERNELS(name, target, W)                                  \
+  target static void add_into31_##name(u32 *x, const u32 *y, std::size_t n) { \
+    add_into31<W>(x, y, n);                                                   \
+  }                                                                           \
+  target static void subtract_into31_##name(u32 *x, const u32 *y,             \
+                                            std::size_t n) {                  \
+    subtract_into31<W>(x, y, n);                                              \
+  }                                                                           \
+  target static void multiply_into31_##name(u32 *x, const u32 *y,             \
+                                            std::size_t n) {                  \
+    multiply_into31<W>(x, y, n);                                              \
+  }                                                                           \
+  target static u32 dot31_##name(const u32 *x, const u32 *y, std::size_t n) { \
+    return dot31<W>(x, y, n);                                                 \
+  }                                                                           \
+  static const frn::lib::math::kernels::Mp31Kernels kernels31_##name = {      \
+      add_into31_##name, subtract_into31_##name, multiply_into31_##name,      \
+      dot31_##name};
+
+DEFINE_MP31_KERNELS(generic, , v2u32)
+DEFINE_MP31_KERNELS(sse42, __attribute__((target("sse4.2"))), v4u32)
+DEFINE_MP31_KERNELS(avx2, __attribute__((target("avx2"))), v8u32)
+DEFINE_MP31_KERNELS(avx512, __attribute__((target("avx512f"))), v16u32)
+
+#undef DEFINE_MP31_KERNELS
+
+const frn::lib::math::kernels::Mp61Kernels &
+frn::lib::math::kernels::Mp61KernelsFor(cpu::Level level) {
+  return *cpu::Select(level, &kernels_generic, &kernels_sse42, &kernels_avx2,
+                      &kernels_avx512);
+}
+
+const frn::lib::math::kernels::Mp31Kernels &
+frn::lib::math::kernels::Mp31KernelsFor(cpu::Level level) {
+  return *cpu::Select(level, &kernels31_generic, &kernels31_sse42,
+                      &kernels31_avx2, &kernels31_avx512);
+}
+
+// Mp127 kernels without IFMA use the scalar arithmetic.
+
+static void add_into127_generic(u128 *x, const u128 *y, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) x[i] = Mp127::Add(x[i], y[i]);
+}
+
+static void subtract_into127_generic(u128 *x, const u128 *y, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) x[i] = Mp127::Subtract(x[i], y[i]);
+}
+
+static void multiply_into127_generic(u128 *x, const u128 *y, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) x[i] = Mp127::Multiply(x[i], y[i]);
+}
+
+static u128 dot127_generic(const u128 *x, const u128 *y, std::size_t n) {
+  u128 result = 0;
+  for (std::size_t i = 0; i < n; i++)
+    result = Mp127::Add(result, Mp127::Multiply(x[i], y[i]));
+  return result;
+}
+
+static const frn::lib::math::kernels::Mp127Kernels kernels127_generic = {
+    add_into127_generic, subtract_into127_generic, multiply_into127_generic,
+    dot127_generic};
+
+// With IFMA, eight elements are held in three vectors of 52-bit limbs,
+// x = l0 + l1 * 2^52 + l2 * 2^104, and products are accumulated in five
+// vectors of 64-bit lanes, one per power of 2^52, without carrying. Each
+// product adds less than 5 * 2^52 to a lane, so a lane can take 256 products
+// before it needs to be reduced.
+
+#define IFMA_TARGET __attribute__((target("avx512f,avx512ifma")))
+
+static constexpr u64 M52 = (1ULL << 52) - 1;
+static constexpr u64 M23 = (1ULL << 23) - 1;
+static constexpr std::size_t kLazyProducts127 = 256;
+
+// the shifts and logic are written with vector extensions, and only the
+// multiply-adds and permutations with intrinsics.
+
+IFMA_TARGET static ALWAYS_INLINE v8u64 madd52lo(const v8u64 &z, const v8u64 &x,
+                                                const v8u64 &y) {
+  return (v8u64)_mm512_madd52lo_epu64((__m512i)z, (__m512i)x, (__m512i)y);
+}
+
+IFMA_TARGET static ALWAYS_INLINE v8u64 madd52hi(const v8u64 &z, const v8u64 &x,
+                                                const v8u64 &y) {
+  return (v8u64)_mm512_madd52hi_epu64((__m512i)z, (__m512i)x, (__m512i)y);
+}
+
+IFMA_TARGET static ALWAYS_INLINE v8u64 permute2(const v8u64 &a,
+                                                const v8u64 &index,
+                                                const v8u64 &b) {
+  return (v8u64)_mm512_permutex2var_epi64((__m512i)a, (__m512i)index,
+                                          (__m512i)b);
+}
+
+IFMA_TARGET static ALWAYS_INLINE void load127(const u128 *src, v8u64 l[3]) {
+  const auto a = load<v8u64>(src);
+  const auto b = load<v8u64>(src + 4);
+  const auto lo = permute2(a, v8u64{0, 2, 4, 6, 8, 10, 12, 14}, b);
+  const auto hi = permute2(a, v8u64{1, 3, 5, 7, 9, 11, 13, 15}, b);
+  l[0] = lo & M52;
+  l[1] = ((lo >> 52) | (hi << 12)) & M52;
+  l[2] = hi >> 40;
+}
+
+IFMA_TARGET static ALWAYS_INLINE void store127(u128 *dest, const v8u64 l[3]) {
+  const v8u64 lo = l[0] | (l[1] << 52);
+  const v8u64 hi = (l[1] >> 12) | (l[2] << 40);
+  store(dest, permute2(lo, v8u64{0, 8, 1, 9, 2, 10, 3, 11}, hi));
+  store(dest + 4, permute2(lo, v8u64{4, 12, 5, 13, 6, 14, 7, 15}, hi));
+}
+
+// z += x * y, where z[k] is the coefficient of 2^(52 k). x2 * y2 < 2^46 has no
+// high part.
+IFMA_TARGET static ALWAYS_INLINE void mul_acc127(v8u64 z[5], const v8u64 x[3],
+                                                 const v8u64 y[3]) {
+  z[0] = madd52lo(z[0], x[0], y[0]);
+
+  z[1] = madd52hi(z[1], x[0], y[0]);
+  z[1] = madd52lo(z[1], x[0], y[1]);
+  z[1] = madd52lo(z[1], x[1], y[0]);
+
+  z[2] = madd52hi(z[2], x[0], y[1]);
+  z[2] = madd52hi(z[2], x[1], y[0]);
+  z[2] = madd52lo(z[2], x[0], y[2]);
+  z[2] = madd52lo(z[2], x[1], y[1]);
+  z[2] = madd52lo(z[2], x[2], y[0]);
+
+  z[3] = madd52hi(z[3], x[0], y[2]);
+  z[3] = madd52hi(z[3], x[1], y[1]);
+  z[3] = madd52hi(z[3], x[2], y[0]);
+  z[3] = madd52lo(z[3], x[1], y[2]);
+  z[3] = madd52lo(z[3], x[2], y[1]);
+
+  z[4] = madd52hi(z[4], x[1], y[2]);
+  z[4] = madd52hi(z[4], x[2], y[1]);
+  z[4] = madd52lo(z[4], x[2], y[2]);
+}
+
+// moves the bits of a above 52 into b.
+IFMA_TARGET static ALWAYS_INLINE void carry52(v8u64 &a, v8u64 &b) {
+  b += a >> 52;
+  a &= M52;
+}
+
+// r = z mod p, for z[k] < 2^63.
+IFMA_TARGET static ALWAYS_INLINE void reduce127(v8u64 z[5], v8u64 r[3]) {
+  for (std::size_t k = 0; k < 4; k++) carry52(z[k], z[k + 1]);
+
+  // z = L + H * 2^127 = L + H mod p, where L is the lower 127 bits.
+  r[0] = z[0] + (((z[2] >> 23) | (z[3] << 29)) & M52);
+  r[1] = z[1] + (((z[3] >> 23) | (z[4] << 29)) & M52);
+  r[2] = (z[2] & M23) + (z[4] >> 23);
+
+  // the sum is below 2^146. Two more folds of the bits above 127 leave a
+  // value of at most p.
+  for (int i = 0; i < 2; i++) {
+    carry52(r[0], r[1]);
+    carry52(r[1], r[2]);
+    r[0] += r[2] >> 23;
+    r[2] &= M23;
+  }
+  carry52(r[0], r[1]);
+  carry52(r[1], r[2]);
+
+  const v8u64 is_p = (r[0] == M52) & (r[1] == M52) & (r[2] == M23);
+  for (std::size_t k = 0; k < 3; k++) r[k] &= ~is_p;
+}
+
+IFMA_TARGET static void multiply_into127_ifma(u128 *x, const u128 *y,
+                                              std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    v8u64 a[3], b[3], r[3];
+    v8u64 z[5] = {};
+    load127(x + i, a);
+    load127(y + i, b);
+    mul_acc127(z, a, b);
+    reduce127(z, r);
+    store127(x + i, r);
+  }
+  multiply_into127_generic(x + i, y + i, n - i);
+}
+
+IFMA_TARGET static u128 dot127_ifma(const u128 *x, const u128 *y,
+                                    std::size_t n) {
+  v8u64 z[5] = {};
+  v8u64 r[3];
+  std::size_t i = 0;
+  std::size_t products = 0;
+  for (; i + 8 <= n; i += 8) {
+    v8u64 a[3], b[3];
+    load127(x + i, a);
+    load127(y + i, b);
+    mul_acc127(z, a, b);
+    if (++products == kLazyProducts127) {
+      reduce127(z, r);
+      z[0] = r[0];
+      z[1] = r[1];
+      z[2] = r[2];
+      z[3] = z[4] = v8u64{};
+      products = 0;
+    }
+  }
+  reduce127(z, r);
+
+  u128 lanes[8];
+  store127(lanes, r);
+  u128 result = dot127_generic(x + i, y + i, n - i);
+  for (auto lane : lanes) result = Mp127::Add(result, lane);
+  return result;
+}
+
+static const frn::lib::math::kernels::Mp127Kernels kernels127_ifma = {
+    add_into127_generic, subtract_into127_generic, multiply_into127_ifma,
+    dot127_ifma};
+
+#undef IFMA_TARGET
+
+const frn::lib::math::kernels::Mp127Kernels &
+frn::lib::math::kernels::Mp127KernelsFor(cpu::Level level) {
+  if (level == cpu::Level::eAvx512 && cpu::HasIfma()) return kernels127_ifma;
+  return kernels127_generic;
+}
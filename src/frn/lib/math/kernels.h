@@ -0,0 +1,142 @@
+#ifndef _FRN_LIB_MATH_KERNELS_H
+#define _FRN_LIB_MATH_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "frn/lib/cpu.h"
+
+namespace frn::lib {
+namespace math {
+namespace kernels {
+
+/**
+ * @brief Batch arithmetic over Mp61.
+ *
+ * Each kernel works on arrays of reduced values, i.e., the underlying values
+ * of <code>FpElement<Mp61></code>, and processes several values at a time
+ * using 32-bit limb multiplication. One table of kernels exists per
+ * cpu::Level.
+ */
+struct Mp61Kernels {
+  //! \f$x_i = x_i + y_i\f$ for \f$i < n\f$.
+  void (*add_into)(std::uint64_t *x, const std::uint64_t *y, std::size_t n);
+  //! \f$x_i = x_i - y_i\f$ for \f$i < n\f$.
+  void (*subtract_into)(std::uint64_t *x, const std::uint64_t *y,
+                        std::size_t n);
+  //! \f$x_i = x_i \cdot y_i\f$ for \f$i < n\f$.
+  void (*multiply_into)(std::uint64_t *x, const std::uint64_t *y,
+                        std::size_t n);
+  /**
+   * \f$x_i = \sum_{k < m} a_{s_k, i} \cdot b_{t_k, i}\f$ for \f$i < n\f$,
+   * where \f$a_{s, i}\f$ is <code>a[s * stride + i]</code>. The arguments
+   * are x, a, b, stride, s, t, m and n.
+   */
+  void (*sum_of_products)(std::uint64_t *x, const std::uint64_t *a,
+                          const std::uint64_t *b, std::size_t stride,
+                          const unsigned *src_a, const unsigned *src_b,
+                          std::size_t m, std::size_t n);
+  //! \f$\sum_{i<n} x_i \cdot y_i\f$.
+  std::uint64_t (*dot)(const std::uint64_t *x, const std::uint64_t *y,
+                       std::size_t n);
+  /**
+   * \f$C = A \cdot B\f$ for an n by p matrix A and a p by m matrix B, where
+   * \f$C_{i,j}\f$ is <code>c[i * ldc + j]</code>, and likewise for A and B.
+   * The products are accumulated without reductions over tiles of rows. The
+   * arguments are c, ldc, a, lda, b, ldb, n, p and m.
+   */
+  void (*matmul)(std::uint64_t *c, std::size_t ldc, const std::uint64_t *a,
+                 std::size_t lda, const std::uint64_t *b, std::size_t ldb,
+                 std::size_t n, std::size_t p, std::size_t m);
+};
+
+/**
+ * @brief The Mp61 kernels for a specific level.
+ *
+ * @remark the caller must ensure that the host supports the level.
+ */
+const Mp61Kernels &Mp61KernelsFor(cpu::Level level);
+
+/**
+ * @brief The Mp61 kernels for cpu::Current().
+ */
+inline const Mp61Kernels &Mp61KernelsCurrent() {
+  return Mp61KernelsFor(cpu::Current());
+}
+
+/**
+ * @brief Batch arithmetic over Mp31.
+ *
+ * Same as Mp61Kernels, but for the underlying values of
+ * <code>FpElement<Mp31></code>. Values are 32 bits, so each vector holds twice
+ * as many of them, e.g., eight on AVX2.
+ */
+struct Mp31Kernels {
+  //! \f$x_i = x_i + y_i\f$ for \f$i < n\f$.
+  void (*add_into)(std::uint32_t *x, const std::uint32_t *y, std::size_t n);
+  //! \f$x_i = x_i - y_i\f$ for \f$i < n\f$.
+  void (*subtract_into)(std::uint32_t *x, const std::uint32_t *y,
+                        std::size_t n);
+  //! \f$x_i = x_i \cdot y_i\f$ for \f$i < n\f$.
+  void (*multiply_into)(std::uint32_t *x, const std::uint32_t *y,
+                        std::size_t n);
+  //! \f$\sum_{i<n} x_i \cdot y_i\f$.
+  std::uint32_t (*dot)(const std::uint32_t *x, const std::uint32_t *y,
+                       std::size_t n);
+};
+
+/**
+ * @brief The Mp31 kernels for a specific level.
+ *
+ * @remark the caller must ensure that the host supports the level.
+ */
+const Mp31Kernels &Mp31KernelsFor(cpu::Level level);
+
+/**
+ * @brief The Mp31 kernels for cpu::Current().
+ */
+inline const Mp31Kernels &Mp31KernelsCurrent() {
+  return Mp31KernelsFor(cpu::Current());
+}
+
+/**
+ * @brief Batch arithmetic over Mp127.
+ *
+ * Same as Mp61Kernels, but for the underlying values of
+ * <code>FpElement<Mp127></code>. Only multiplication and dot products are
+ * vectorized, and only with AVX-512 IFMA, where eight elements are multiplied
+ * at a time in radix \f$2^{52}\f$. Other levels use the scalar arithmetic.
+ */
+struct Mp127Kernels {
+  //! \f$x_i = x_i + y_i\f$ for \f$i < n\f$.
+  void (*add_into)(__uint128_t *x, const __uint128_t *y, std::size_t n);
+  //! \f$x_i = x_i - y_i\f$ for \f$i < n\f$.
+  void (*subtract_into)(__uint128_t *x, const __uint128_t *y, std::size_t n);
+  //! \f$x_i = x_i \cdot y_i\f$ for \f$i < n\f$.
+  void (*multiply_into)(__uint128_t *x, const __uint128_t *y, std::size_t n);
+  //! \f$\sum_{i<n} x_i \cdot y_i\f$.
+  __uint128_t (*dot)(const __uint128_t *x, const __uint128_t *y,
+                     std::size_t n);
+};
+
+/**
+ * @brief The Mp127 kernels for a specific level.
+ *
+ * The AVX-512 kernels are only used if the host also supports IFMA.
+ *
+ * @remark the caller must ensure that the host supports the level.
+ */
+const Mp127Kernels &Mp127KernelsFor(cpu::Level level);
+
+/**
+ * @brief The Mp127 kernels for cpu::Current().
+ */
+inline const Mp127Kernels &Mp127KernelsCurrent() {
+  return Mp127KernelsFor(cpu::Current());
+}
+
+}  // namespace kernels
+}  // namespace math
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_MATH_KERNELS_H
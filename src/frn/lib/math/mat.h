@@ -1,8 +1,11 @@
 #ifndef _FRN_LIB_MATH_MATRIX_H
 #define _FRN_LIB_MATH_MATRIX_H
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <thread>
+#include <type_traits>
 
 #include "frn/lib/math/ring.h"
 #include "frn/lib/math/vec.h"
@@ -11,6 +14,194 @@
 namespace frn::lib {
 namespace math {
 
+/**
+ * @brief A rectangular block of the elements of a matrix.
+ *
+ * A view does not own its elements, so it must not outlive the matrix it was
+ * taken from. Consecutive rows of a view are <code>Stride()</code> elements
+ * apart.
+ *
+ * @tparam T the type of the ring. Views of a const matrix have a const T.
+ */
+template <typename T>
+class MatrixView {
+ public:
+  /**
+   * @brief A view of the same elements that does not allow changing them.
+   */
+  using ConstView = MatrixView<const std::remove_const_t<T>>;
+
+  /**
+   * @brief Construct a view of nrows-by-ncols elements.
+   *
+   * @param data the first element.
+   * @param nrows the number of rows.
+   * @param ncols the number of columns.
+   * @param stride the distance between the first elements of two rows.
+   */
+  MatrixView(T *data, std::size_t nrows, std::size_t ncols,
+             std::size_t stride)
+      : mData(data), mRows(nrows), mCols(ncols), mStride(stride){};
+
+  /**
+   * @brief A view of the same elements that does not allow changing them.
+   */
+  template <typename U = T, std::enable_if_t<!std::is_const_v<U>, int> = 0>
+  operator ConstView() const {
+    return ConstView(mData, mRows, mCols, mStride);
+  }
+
+  /**
+   * @brief The number of rows in this view.
+   */
+  std::size_t RowCount() const { return mRows; };
+
+  /**
+   * @brief The number of columns in this view.
+   */
+  std::size_t ColumnCount() const { return mCols; };
+
+  /**
+   * @brief The distance between the first elements of two rows.
+   */
+  std::size_t Stride() const { return mStride; };
+
+  /**
+   * @brief The first element of this view.
+   */
+  T *Data() const { return mData; };
+
+  /**
+   * @brief Element access.
+   *
+   * @param r the row.
+   * @param c the column.
+   * @returns The element at the r'th row and c'th column.
+   *
+   * @remark This method does not perform any kind of bounds check.
+   */
+  T &operator()(std::size_t r, std::size_t c) const {
+    return mData[mStride * r + c];
+  };
+
+  /**
+   * @brief Extract a submatrix.
+   *
+   * Returns a view of the \f$(i_1 - i_0)\times(j_1 - j_0)\f$ elements in
+   * rows \f$i_0, \dots, i_1 - 1\f$ and columns \f$j_0, \dots, j_1 - 1\f$.
+   *
+   * @param row_beg row offset begin.
+   * @param row_end row offset end.
+   * @param col_beg column offset begin.
+   * @param col_end column offset end.
+   *
+   * @throws std::logic_error offsets are invalid or if the requested
+   * submatrix extends past this view.
+   */
+  MatrixView extract_submatrix(std::size_t row_beg, std::size_t row_end,
+                               std::size_t col_beg, std::size_t col_end) const {
+    if (row_beg > row_end || row_end > RowCount())
+      throw std::logic_error("invalid row offsets");
+
+    if (col_beg > col_end || col_end > ColumnCount())
+      throw std::logic_error("invalid column offsets");
+
+    return MatrixView(mData + mStride * row_beg + col_beg, row_end - row_beg,
+                      col_end - col_beg, mStride);
+  };
+
+ private:
+  T *mData;
+  std::size_t mRows;
+  std::size_t mCols;
+  std::size_t mStride;
+};
+
+namespace details {
+
+/**
+ * @brief Rows row_beg to row_end of result = left * right.
+ */
+template <typename T>
+void MatMulRows(const MatrixView<T> &result, const MatrixView<const T> &left,
+                const MatrixView<const T> &right, std::size_t row_beg,
+                std::size_t row_end) {
+  const auto p = left.ColumnCount();
+  const auto m = right.ColumnCount();
+  if (row_beg == row_end) return;
+
+  if constexpr (std::is_same_v<T, FpElement<Mp61>>) {
+    using U = typename T::ValueType;
+    vector::details::Kernels<T>().matmul(
+        reinterpret_cast<U *>(&result(row_beg, 0)), result.Stride(),
+        reinterpret_cast<const U *>(&left(row_beg, 0)), left.Stride(),
+        reinterpret_cast<const U *>(right.Data()), right.Stride(),
+        row_end - row_beg, p, m);
+  } else {
+    for (std::size_t i = row_beg; i < row_end; i++) {
+      for (std::size_t j = 0; j < m; j++) result(i, j) = T();
+      for (std::size_t k = 0; k < p; k++)
+        for (std::size_t j = 0; j < m; j++)
+          result(i, j) += left(i, k) * right(k, j);
+    }
+  }
+}
+
+/**
+ * @brief Products with fewer multiplications than this per thread are not
+ * worth starting a thread for.
+ */
+constexpr std::size_t kMinMatMulWorkPerThread = 1 << 20;
+
+}  // namespace details
+
+/**
+ * @brief Computes the matrix product of two views into a third.
+ *
+ * Over Mp61, the product is computed by the batch kernels, which accumulate
+ * the products of a tile of rows before reducing them. The rows of the result
+ * are divided between up to <code>threads</code> threads, but each thread gets
+ * at least details::kMinMatMulWorkPerThread multiplications.
+ *
+ * @param result an N x M view for the result.
+ * @param left an N x P view.
+ * @param right a P x M view.
+ * @param threads the largest number of threads to use.
+ *
+ * @throws std::invalid_argument if the dimensions do not match.
+ *
+ * @pre <code>result</code> does not overlap <code>left</code> or
+ * <code>right</code>.
+ */
+template <typename T>
+void MatMulInto(const MatrixView<T> &result,
+                const typename MatrixView<T>::ConstView &left,
+                const typename MatrixView<T>::ConstView &right,
+                std::size_t threads = std::thread::hardware_concurrency()) {
+  if (left.ColumnCount() != right.RowCount())
+    throw std::invalid_argument(
+        "cannot multiply N x P, Q x M matrices when P != Q.");
+  if (result.RowCount() != left.RowCount() ||
+      result.ColumnCount() != right.ColumnCount())
+    throw std::invalid_argument("result must be N x M.");
+
+  const auto n = result.RowCount();
+  const auto work = n * left.ColumnCount() * right.ColumnCount();
+  threads = std::min({threads, n, work / details::kMinMatMulWorkPerThread});
+  if (threads <= 1) {
+    details::MatMulRows<T>(result, left, right, 0, n);
+    return;
+  }
+
+  const auto rows = (n + threads - 1) / threads;
+  std::vector<std::thread> workers;
+  for (std::size_t beg = rows; beg < n; beg += rows)
+    workers.emplace_back(details::MatMulRows<T>, result, left, right, beg,
+                         std::min(n, beg + rows));
+  details::MatMulRows<T>(result, left, right, 0, rows);
+  for (auto &worker : workers) worker.join();
+}
+
 /**
  * @brief A two dimensional matrix over a ring.
  *
@@ -41,6 +232,19 @@ class Matrix {
     mValues = std::vector<T>(mRows * mCols);
   };
 
+  /**
+   * @brief Construct a matrix with a copy of the elements of a view.
+   *
+   * @param view the view.
+   *
+   * @throws std::invalid_argument if the view has no rows or columns.
+   */
+  explicit Matrix(const MatrixView<const T> &view)
+      : Matrix(view.RowCount(), view.ColumnCount()) {
+    for (std::size_t i = 0; i < mRows; ++i)
+      for (std::size_t j = 0; j < mCols; ++j) operator()(i, j) = view(i, j);
+  };
+
   /**
    * @brief The number of rows in this matrix.
    */
@@ -77,10 +281,25 @@ class Matrix {
     return mValues[mCols * r + c];
   };
 
+  /**
+   * @brief A view of all elements of this matrix.
+   */
+  MatrixView<T> View() {
+    return MatrixView<T>(mValues.data(), mRows, mCols, mCols);
+  };
+
+  /**
+   * @brief A view of all elements of this matrix.
+   */
+  MatrixView<const T> View() const {
+    return MatrixView<const T>(mValues.data(), mRows, mCols, mCols);
+  };
+
   /**
    * @brief Extract a submatrix.
    *
-   * Returns a matrix M' of size \f$(i_1 - i_0)\times(j_1 - j_0)\f$.
+   * Returns a view M' of size \f$(i_1 - i_0)\times(j_1 - j_0)\f$. Changes to
+   * M' are changes to this matrix.
    *
    * @param row_beg row offset begin.
    * @param row_end row offset end.
@@ -88,25 +307,23 @@ class Matrix {
    * @param col_end column offset end.
    *
    * @throws std::logic_error offsets are invalid or if the requested
-   * submatrix is larger than the matrix.
+   * submatrix extends past the matrix.
    */
-  Matrix extract_submatrix(std::size_t row_beg, std::size_t row_end,
-                           std::size_t col_beg, std::size_t col_end) {
-    if (row_beg > row_end || row_end - row_beg > RowCount())
-      throw std::logic_error("invalid row offsets");
-
-    if (col_beg > col_end || col_end - col_beg > ColumnCount())
-      throw std::logic_error("invalid column offsets");
+  MatrixView<T> extract_submatrix(std::size_t row_beg, std::size_t row_end,
+                                  std::size_t col_beg, std::size_t col_end) {
+    return View().extract_submatrix(row_beg, row_end, col_beg, col_end);
+  };
 
-    auto nrows = row_end - row_beg;
-    auto ncols = col_end - col_beg;
-    Matrix sub(nrows, ncols);
-    for (std::size_t i = 0; i < nrows; ++i) {
-      for (std::size_t j = 0; j < ncols; ++j) {
-        sub(i, j) = this->operator()(row_beg + i, col_beg + j);
-      }
-    }
-    return sub;
+  /**
+   * @brief Extract a submatrix.
+   *
+   * @see extract_submatrix.
+   */
+  MatrixView<const T> extract_submatrix(std::size_t row_beg,
+                                        std::size_t row_end,
+                                        std::size_t col_beg,
+                                        std::size_t col_end) const {
+    return View().extract_submatrix(row_beg, row_end, col_beg, col_end);
   };
 
   /**
@@ -226,26 +443,22 @@ class Matrix {
    * @brief Performs a matrix multiplication between matrices.
    *
    * @param other the right hand side, a P x M matrix.
+   * @param threads the largest number of threads to use.
    *
    * @throws std::invalid_argument if ncols of left does not equal nrows of
    * right.
+   *
+   * @see MatMulInto.
    */
-  Matrix MatMul(const Matrix<T> &other) {
+  Matrix MatMul(
+      const Matrix<T> &other,
+      std::size_t threads = std::thread::hardware_concurrency()) const {
     if (ColumnCount() != other.RowCount())
       throw std::invalid_argument(
           "cannot multiply N x P, Q x M matrices when P != Q.");
 
-    const auto n = RowCount();
-    const auto p = ColumnCount();
-    const auto m = other.ColumnCount();
-
-    Matrix result(n, m);
-
-    for (std::size_t i = 0; i < n; i++)
-      for (std::size_t k = 0; k < p; k++)
-        for (std::size_t j = 0; j < m; j++)
-          result(i, j) += operator()(i, k) * other(k, j);
-
+    Matrix result(RowCount(), other.ColumnCount());
+    MatMulInto(result.View(), View(), other.View(), threads);
     return result;
   };
 
@@ -1,16 +1,134 @@
 #ifndef _FRN_LIB_MATH_VECTOR_H
 #define _FRN_LIB_MATH_VECTOR_H
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
+#include "frn/lib/math/fp.h"
+#include "frn/lib/math/kernels.h"
+#include "frn/lib/math/p.h"
 #include "frn/lib/math/ring.h"
 
 namespace frn::lib {
 namespace math {
 namespace vector {
 
+namespace details {
+
+/**
+ * @brief Whether operations on vectors of T use the batch kernels of
+ * kernels::Mp61Kernels, kernels::Mp31Kernels or kernels::Mp127Kernels.
+ */
+template <typename T>
+inline constexpr bool kUsesKernels = std::is_same_v<T, FpElement<Mp61>> ||
+                                     std::is_same_v<T, FpElement<Mp31>> ||
+                                     std::is_same_v<T, FpElement<Mp127>>;
+
+/**
+ * @brief The batch kernels for vectors of T.
+ */
+template <typename T>
+const auto &Kernels() {
+  if constexpr (std::is_same_v<T, FpElement<Mp61>>)
+    return kernels::Mp61KernelsCurrent();
+  else if constexpr (std::is_same_v<T, FpElement<Mp127>>)
+    return kernels::Mp127KernelsCurrent();
+  else
+    return kernels::Mp31KernelsCurrent();
+}
+
+/**
+ * @brief The underlying values of a vector of <code>FpElement</code>.
+ */
+template <typename T>
+typename T::ValueType *Values(std::vector<T> &vector) {
+  static_assert(sizeof(T) == sizeof(typename T::ValueType));
+  return reinterpret_cast<typename T::ValueType *>(vector.data());
+}
+
+template <typename T>
+const typename T::ValueType *Values(const std::vector<T> &vector) {
+  static_assert(sizeof(T) == sizeof(typename T::ValueType));
+  return reinterpret_cast<const typename T::ValueType *>(vector.data());
+}
+
+/**
+ * @brief Writes values of at most 64 bits to a little-endian bit stream.
+ */
+class BitWriter {
+ public:
+  explicit BitWriter(unsigned char *dest) : mDest(dest){};
+
+  /**
+   * @brief Appends the w lower bits of x, where x < 2^w and w <= 64.
+   */
+  void Write(std::uint64_t x, unsigned w) {
+    mBuffer |= static_cast<__uint128_t>(x) << mFilled;
+    mFilled += w;
+    if (mFilled >= 64) {
+      const auto word = static_cast<std::uint64_t>(mBuffer);
+      std::memcpy(mDest, &word, sizeof(word));
+      mDest += sizeof(word);
+      mBuffer >>= 64;
+      mFilled -= 64;
+    }
+  };
+
+  /**
+   * @brief Writes the remaining bits, padded with zeros to a whole byte.
+   */
+  void Flush() {
+    const auto word = static_cast<std::uint64_t>(mBuffer);
+    std::memcpy(mDest, &word, (mFilled + 7) / 8);
+  };
+
+ private:
+  unsigned char *mDest;
+  __uint128_t mBuffer = 0;
+  unsigned mFilled = 0;
+};
+
+/**
+ * @brief Reads values written by BitWriter.
+ */
+class BitReader {
+ public:
+  BitReader(const unsigned char *src, std::size_t size)
+      : mSrc(src), mEnd(src + size){};
+
+  /**
+   * @brief Reads the next w bits, where w <= 64.
+   */
+  std::uint64_t Read(unsigned w) {
+    if (mAvailable < w) {
+      std::uint64_t word = 0;
+      const std::size_t k =
+          std::min<std::size_t>(sizeof(word), mEnd - mSrc);
+      std::memcpy(&word, mSrc, k);
+      mSrc += k;
+      mBuffer |= static_cast<__uint128_t>(word) << mAvailable;
+      mAvailable += 64;
+    }
+    const auto x = static_cast<std::uint64_t>(mBuffer) &
+                   (w == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << w) - 1);
+    mBuffer >>= w;
+    mAvailable -= w;
+    return x;
+  };
+
+ private:
+  const unsigned char *mSrc;
+  const unsigned char *mEnd;
+  __uint128_t mBuffer = 0;
+  unsigned mAvailable = 0;
+};
+
+}  // namespace details
+
 /**
  * @brief Computes the inner product between two vectors.
  *
@@ -26,6 +144,10 @@ RingType<T, T> Dot(const std::vector<T> &left, const std::vector<T> &right) {
   if (n != right.size())
     throw std::logic_error("cannot Dot vectors with different sizes");
 
+  if constexpr (details::kUsesKernels<T>)
+    return T(details::Kernels<T>().dot(
+        details::Values(left), details::Values(right), n));
+
   auto lit = left.begin();
   auto rit = right.begin();
 
@@ -52,6 +174,12 @@ RingType<T, std::vector<T> &> AddInto(std::vector<T> &left,
   if (n != right.size())
     throw std::logic_error("addition of vectors with different sizes");
 
+  if constexpr (details::kUsesKernels<T>) {
+    details::Kernels<T>().add_into(details::Values(left),
+                             details::Values(right), n);
+    return left;
+  }
+
   auto lit = left.begin();
   auto rit = right.begin();
 
@@ -92,6 +220,12 @@ RingType<T, std::vector<T> &> SubtractInto(std::vector<T> &left,
   if (n != right.size())
     throw std::logic_error("subtraction of vectors with different sizes");
 
+  if constexpr (details::kUsesKernels<T>) {
+    details::Kernels<T>().subtract_into(details::Values(left),
+                             details::Values(right), n);
+    return left;
+  }
+
   auto lit = left.begin();
   auto rit = right.begin();
 
@@ -133,6 +267,12 @@ RingType<T, std::vector<T> &> MultiplyInto(std::vector<T> &left,
     throw std::logic_error(
         "entry-wise multiplication of vectors with different sizes");
 
+  if constexpr (details::kUsesKernels<T>) {
+    details::Kernels<T>().multiply_into(details::Values(left),
+                             details::Values(right), n);
+    return left;
+  }
+
   auto lit = left.begin();
   auto rit = right.begin();
 
@@ -157,6 +297,54 @@ RingType<T, std::vector<T>> Multiply(const std::vector<T> &left,
   return MultiplyInto(temp, right);
 }
 
+/**
+ * @brief Inverts every entry of a vector.
+ *
+ * Uses Montgomery's trick: the inverse of the product of all entries gives
+ * each inverse through the prefix products, so n entries take one inversion
+ * and \f$3(n - 1)\f$ multiplications.
+ *
+ * @param vector the vector \f$v\f$.
+ * @return the vector \f$v\f$ updated such that \f$v_i = v_i^{-1}\f$.
+ *
+ * @throws std::logic_error if an entry is not invertible, in which case the
+ * vector is left unchanged.
+ */
+template <typename T>
+RingType<T, std::vector<T> &> BatchInvertInto(std::vector<T> &vector) {
+  const auto n = vector.size();
+  if (!n) return vector;
+
+  std::vector<T> prefix;
+  prefix.reserve(n);
+  prefix.emplace_back(vector[0]);
+  for (std::size_t i = 1; i < n; i++)
+    prefix.emplace_back(prefix[i - 1] * vector[i]);
+
+  T inverse = prefix[n - 1].Inverse();
+  for (std::size_t i = n - 1; i > 0; i--) {
+    const T entry = vector[i];
+    vector[i] = inverse * prefix[i - 1];
+    inverse *= entry;
+  }
+  vector[0] = inverse;
+  return vector;
+}
+
+/**
+ * @brief Inverts every entry of a vector and returns the result.
+ *
+ * @param vector the vector \f$v\f$.
+ * @return a vector \f$z\f$ such that \f$z_i = v_i^{-1}\f$.
+ *
+ * @throws std::logic_error if an entry is not invertible.
+ */
+template <typename T>
+RingType<T, std::vector<T>> BatchInvert(const std::vector<T> &vector) {
+  std::vector<T> temp(vector);
+  return BatchInvertInto(temp);
+}
+
 /**
  * @brief Scales a vector by a constant.
  *
@@ -220,6 +408,73 @@ RingType<T, std::vector<T>> FromBytes(const unsigned char *buffer,
   return items;
 }
 
+/**
+ * @brief The number of bytes used by ToPackedBytes.
+ *
+ * @param size the number of elements.
+ */
+template <typename T>
+constexpr std::size_t PackedByteSize(std::size_t size) {
+  return (size * T::PackedBitSize() + 7) / 8;
+}
+
+/**
+ * @brief Writes the content of a vector to a buffer, using only
+ * <code>T::PackedBitSize()</code> bits per element.
+ *
+ * E.g., Mp61 elements take 61 bits instead of 64, and Mp127 elements 127 bits
+ * instead of 128.
+ *
+ * @param buffer the desination buffer.
+ * @param vector the vector.
+ *
+ * @remark assumes that <code>buffer</code> points to
+ * <code>PackedByteSize<T>(vector.size())</code> bytes.
+ */
+template <typename T>
+RingType<T, void> ToPackedBytes(unsigned char *buffer,
+                                const std::vector<T> &vector) {
+  constexpr unsigned kBits = T::PackedBitSize();
+  static_assert(kBits <= 128);
+  details::BitWriter writer(buffer);
+  for (const auto &v : vector) {
+    if constexpr (kBits <= 64) {
+      writer.Write(v.Value(), kBits);
+    } else {
+      writer.Write(static_cast<std::uint64_t>(v.Value()), 64);
+      writer.Write(static_cast<std::uint64_t>(v.Value() >> 64), kBits - 64);
+    }
+  }
+  writer.Flush();
+}
+
+/**
+ * @brief Reads a vector written by ToPackedBytes.
+ *
+ * @param buffer the buffer with the serialized vector.
+ * @param size the number of elements to read.
+ * @return the deserialized vector.
+ */
+template <typename T>
+RingType<T, std::vector<T>> FromPackedBytes(const unsigned char *buffer,
+                                            std::size_t size) {
+  using ValueType = typename T::ValueType;
+  constexpr unsigned kBits = T::PackedBitSize();
+  details::BitReader reader(buffer, PackedByteSize<T>(size));
+  std::vector<T> items;
+  items.reserve(size);
+  for (std::size_t i = 0; i < size; i++) {
+    if constexpr (kBits <= 64) {
+      items.emplace_back(static_cast<ValueType>(reader.Read(kBits)));
+    } else {
+      const ValueType low = reader.Read(64);
+      const ValueType high = reader.Read(kBits - 64);
+      items.emplace_back(low | high << 64);
+    }
+  }
+  return items;
+}
+
 /**
  * @brief Compute the sum over a vector of values.
  *
@@ -0,0 +1,200 @@
+#ifndef _FRN_LIB_MATH_Z2K_H
+#define _FRN_LIB_MATH_Z2K_H
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "frn/lib/math/ring.h"
+#include "frn/lib/tools.h"
+
+namespace frn::lib {
+namespace math {
+
+/**
+ * @brief The ring of integers modulo \f$2^K\f$.
+ *
+ * Elements are stored in a 64-bit integer, so arithmetic is the native
+ * wrapping arithmetic of the CPU followed by a mask when \f$K < 64\f$. Only odd
+ * elements have inverses.
+ *
+ * @tparam K the bit length of the ring. Must be at most 64.
+ */
+template <std::size_t K>
+class Z2kElement : RingElement<Z2kElement<K>> {
+  static_assert(0 < K && K <= 64, "K must be between 1 and 64.");
+
+ public:
+  /**
+   * @brief Numeric type of an element.
+   */
+  using ValueType = std::uint64_t;
+
+  /**
+   * @brief Mask of the K lower bits.
+   */
+  static constexpr ValueType kMask = K == 64 ? ~ValueType(0)
+                                             : (ValueType(1) << K) - 1;
+
+  /**
+   * @brief Additive neutral element.
+   */
+  static const Z2kElement kZero;
+
+  /**
+   * @brief Multiplicative neutral element.
+   */
+  static const Z2kElement kOne;
+
+  /**
+   * @brief Construct a new element from a series of bytes.
+   *
+   * @pre <code>buffer</code> must point to at least <code>ByteSize()</code>
+   * bytes of memory.
+   */
+  static Z2kElement FromBytes(const unsigned char *buffer) {
+    ValueType value;
+    std::memcpy(&value, buffer, ByteSize());
+    return Z2kElement(value);
+  };
+
+  /**
+   * @brief Size of an element in bytes.
+   */
+  static constexpr std::size_t ByteSize() { return sizeof(ValueType); };
+
+  /**
+   * @brief Size of an element in bits.
+   */
+  static constexpr std::size_t BitSize() { return K; };
+
+  /**
+   * @brief Construct a new element with value 0.
+   */
+  constexpr Z2kElement() : mValue(0){};
+
+  /**
+   * @brief Construct a new element from an integer, taken modulo \f$2^K\f$.
+   */
+  constexpr explicit Z2kElement(const ValueType &value)
+      : mValue(value & kMask){};
+
+  /**
+   * @brief The value of this element, i.e., an integer less than \f$2^K\f$.
+   */
+  const ValueType &Value() const { return mValue; };
+
+  /**
+   * @brief Set element to its additive negative.
+   */
+  Z2kElement &Negate() {
+    mValue = (0 - mValue) & kMask;
+    return *this;
+  };
+
+  /**
+   * @brief Set element to its multiplicative inverse.
+   *
+   * @throws std::logic_error if this element is even.
+   */
+  Z2kElement &Invert() {
+    if (!(mValue & 1)) throw std::logic_error("even elements have no inverse");
+    // Newton's iteration doubles the number of correct bits each step, and x
+    // is its own inverse modulo 8.
+    ValueType y = mValue;
+    for (int i = 0; i < 5; i++) y *= 2 - mValue * y;
+    mValue = y & kMask;
+    return *this;
+  };
+
+  /**
+   * @brief Return the multiplicative inverse of this element.
+   *
+   * @throws std::logic_error if this element is even.
+   */
+  Z2kElement Inverse() const {
+    Z2kElement copy(*this);
+    return copy.Invert();
+  };
+
+  /**
+   * @brief Add another element to this.
+   */
+  Z2kElement &operator+=(const Z2kElement &other) {
+    mValue = (mValue + other.mValue) & kMask;
+    return *this;
+  };
+
+  /**
+   * @brief Subtract another element from this.
+   */
+  Z2kElement &operator-=(const Z2kElement &other) {
+    mValue = (mValue - other.mValue) & kMask;
+    return *this;
+  };
+
+  /**
+   * @brief Multiply another element onto this.
+   */
+  Z2kElement &operator*=(const Z2kElement &other) {
+    mValue = (mValue * other.mValue) & kMask;
+    return *this;
+  };
+
+  /**
+   * @brief Multiply this by the inverse of other.
+   *
+   * @throws std::logic_error if other is even.
+   */
+  Z2kElement &operator/=(const Z2kElement &other) {
+    return *this *= other.Inverse();
+  };
+
+  /**
+   * @brief Returns true if this and other are equal.
+   */
+  bool Equal(const Z2kElement &other) const { return mValue == other.mValue; };
+
+  /**
+   * @brief Returns true if this and other are not equal.
+   */
+  bool NotEqual(const Z2kElement &other) const { return !Equal(other); };
+
+  /**
+   * @brief write this element into a buffer.
+   *
+   * @pre <code>buffer</code> must point to <code>ByteSize()</code> bytes of
+   * free space.
+   */
+  void ToBytes(unsigned char *dest) const {
+    std::memcpy(dest, &mValue, ByteSize());
+  };
+
+  /**
+   * @brief << overload.
+   */
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const Z2kElement &element) {
+    return os << element.ToString();
+  };
+
+  /**
+   * @brief Returns a string representation of this element.
+   */
+  std::string ToString() const {
+    return frn::lib::utils::to_string<ValueType>(mValue);
+  };
+
+ private:
+  ValueType mValue;
+};
+
+template <std::size_t K>
+const Z2kElement<K> Z2kElement<K>::kZero = Z2kElement<K>(0);
+template <std::size_t K>
+const Z2kElement<K> Z2kElement<K>::kOne = Z2kElement<K>(1);
+
+}  // namespace math
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_MATH_Z2K_H
@@ -10,6 +10,8 @@
 #include "frn/lib/logging/nowhere.h"
 #include "frn/lib/net/channel.h"
 #include "frn/lib/net/connector.h"
+#include "frn/lib/net/memory.h"
+#include "frn/lib/net/mesh.h"
 #include "frn/lib/net/network.h"
 #include "frn/lib/net/shared_deque.h"
 #include "frn/lib/net/sysi.h"
@@ -19,9 +21,12 @@ using Connector = frn::lib::net::Connector;
 using LocalConnector = frn::lib::net::LocalConnector;
 using Channel = frn::lib::net::Channel;
 using SystemInterface = frn::lib::net::SystemInterface;
-using TCPClientConnector = frn::lib::net::TCPClientConnector;
-using TCPServerConnector = frn::lib::net::TCPServerConnector;
+using TCPMeshConnector = frn::lib::net::TCPMeshConnector;
+using ConnectionManager = frn::lib::net::ConnectionManager;
+using SocketOptions = frn::lib::net::SocketOptions;
 using AsyncSenderChannel = frn::lib::net::AsyncSenderChannel;
+using MemoryConnector = frn::lib::net::MemoryConnector;
+using MemoryHub = frn::lib::net::MemoryHub;
 using Network = frn::lib::net::Network;
 
 static inline std::unique_ptr<Connector> make_local_connector() {
@@ -29,15 +34,17 @@ static inline std::unique_ptr<Connector> make_local_connector() {
   return std::make_unique<LocalConnector>(buffer, buffer);
 }
 
-using PortSupplier = std::function<int(bool is_server, int id)>;
-
 static inline std::vector<std::unique_ptr<Channel>> create_tcp_channels(
-    int local_id, std::size_t size, PortSupplier get_port,
-    const std::vector<std::string>& ips) {
+    int local_id, std::size_t size, const std::vector<int>& ports,
+    const std::vector<std::string>& ips, const SocketOptions& options) {
   std::vector<std::unique_ptr<Channel>> channels;
   channels.reserve(size);
 
   std::shared_ptr<SystemInterface> system = std::make_shared<SystemInterface>();
+  // shared by all TCP connectors, so that the first one to be opened connects
+  // the whole mesh in parallel.
+  auto manager = std::make_shared<ConnectionManager>(system, local_id, ips,
+                                                     ports, options);
 
   for (std::size_t i = 0; i < size; ++i) {
     // this line is missed by gcov for some reason.
@@ -46,18 +53,28 @@ static inline std::vector<std::unique_ptr<Channel>> create_tcp_channels(
     // LCOV_EXCL_STOP
     if ((int)i == local_id) {
       connector = make_local_connector();
-    } else if ((int)i < local_id) {
-      auto port = get_port(false, i);
-      connector = std::make_unique<TCPClientConnector>(system, port, ips[i]);
-    } else {  // i > local_id
-      auto port = get_port(true, i);
-      connector = std::make_unique<TCPServerConnector>(system, port);
+    } else {
+      connector = std::make_unique<TCPMeshConnector>(system, manager, i);
     }
     channels.emplace_back(std::make_unique<AsyncSenderChannel>(connector));
   }
   return channels;
 }
 
+static inline std::vector<std::unique_ptr<Channel>> create_memory_channels(
+    int local_id, std::size_t size, const std::shared_ptr<MemoryHub>& hub) {
+  std::vector<std::unique_ptr<Channel>> channels;
+  channels.reserve(size);
+
+  for (std::size_t i = 0; i < size; ++i) {
+    std::unique_ptr<Connector> connector = std::make_unique<MemoryConnector>(
+        hub->Link(local_id, i), hub->Link(i, local_id));
+    // sending on a memory link never blocks, so no need for a sender thread.
+    channels.emplace_back(std::make_unique<Channel>(connector));
+  }
+  return channels;
+}
+
 Network frn::lib::net::Network::Builder::Build() const {
   if (!mLocalPeerId) throw std::logic_error("identifier not set");
 
@@ -81,15 +98,25 @@ Network frn::lib::net::Network::Builder::Build() const {
       ips = mIps.value();
     }
 
+    // every party listens on a single port.
     int base_port = mBasePort.value_or(Network::kBasePort);
-    auto port_picker = [&base_port, &id, &n](bool is_server, int other_id) {
-      const auto server_port = id * n + other_id;
-      const auto client_port = other_id * n + id;
-      return base_port + (is_server ? server_port : client_port);
-    };
-    auto channels = create_tcp_channels(id, n, port_picker, ips);
-
-    return Network(id, n, ttype, channels, logger);
+    std::vector<int> ports(n);
+    for (std::size_t i = 0; i < n; ++i) ports[i] = base_port + i;
+    auto channels = create_tcp_channels(id, n, ports, ips, mSocketOptions);
+
+    return Network(id, n, ttype, channels, logger, mWriteBufferSize);
+  }
+
+  if (ttype == Network::TransportType::eMemory) {
+    int id = mLocalPeerId.value();
+    std::size_t n = mSize.value();
+
+    if (!mHub) throw std::logic_error("memory hub not provided");
+    if (mHub->Size() != n)
+      throw std::logic_error("memory hub size does not match network size");
+
+    auto channels = create_memory_channels(id, n, mHub);
+    return Network(id, n, ttype, channels, logger, mWriteBufferSize);
   }
 
   throw std::logic_error("unknown transport type");
@@ -159,3 +186,43 @@ frn::lib::net::Network::Builder& frn::lib::net::Network::Builder::Logger(
   mLogger = std::make_optional<LoggerPtr>(logger);
   return *this;
 }
+
+frn::lib::net::Network::Builder& frn::lib::net::Network::Builder::Hub(
+    std::shared_ptr<MemoryHub> hub) {
+  if (!hub) throw std::logic_error("memory hub cannot be null");
+  mHub = hub;
+  return *this;
+}
+
+frn::lib::net::Network::Builder& frn::lib::net::Network::Builder::StreamsPerPeer(
+    std::size_t streams) {
+  if (!streams) throw std::logic_error("need at least one stream per peer");
+  mSocketOptions.streams = streams;
+  return *this;
+}
+
+frn::lib::net::Network::Builder& frn::lib::net::Network::Builder::SocketBufferSize(
+    int bytes) {
+  if (bytes <= 0) throw std::logic_error("buffer size must be positive");
+  mSocketOptions.buffer_size = bytes;
+  return *this;
+}
+
+frn::lib::net::Network::Builder& frn::lib::net::Network::Builder::NoDelay(
+    bool no_delay) {
+  mSocketOptions.no_delay = no_delay;
+  return *this;
+}
+
+frn::lib::net::Network::Builder& frn::lib::net::Network::Builder::Cork(
+    bool cork) {
+  mSocketOptions.cork = cork;
+  return *this;
+}
+
+frn::lib::net::Network::Builder& frn::lib::net::Network::Builder::WriteBufferSize(
+    std::size_t bytes) {
+  if (!bytes) throw std::logic_error("write buffer size must be positive");
+  mWriteBufferSize = bytes;
+  return *this;
+}
@@ -6,6 +6,8 @@
 #include <vector>
 
 #include "frn/lib/logging/logger.h"
+#include "frn/lib/net/memory.h"
+#include "frn/lib/net/mesh.h"
 #include "frn/lib/net/network.h"
 
 namespace frn::lib {
@@ -78,6 +80,8 @@ class Network::Builder {
   /**
    * @brief Set the base port.
    *
+   * Party <code>i</code> listens for connections on <code>port + i</code>.
+   *
    * @param port other peers ports are offsets of this one.
    * @remark has no effect if TransportType is set to <code>MEMORY</code>.
    */
@@ -104,6 +108,65 @@ class Network::Builder {
    */
   Builder &Logger(std::shared_ptr<logging::Logger> logger);
 
+  /**
+   * @brief Set the hub through which parties talk.
+   *
+   * This method is mandatory if TransportType is <code>MEMORY</code>. All
+   * parties in the network must be built with the same hub.
+   *
+   * @param hub the hub.
+   * @throws std::logic_error if the hub is null.
+   */
+  Builder &Hub(std::shared_ptr<MemoryHub> hub);
+
+  /**
+   * @brief Set the number of TCP streams between each pair of parties.
+   *
+   * Large messages are striped across all streams, which helps filling links
+   * with a large bandwidth-delay product. Default is 1.
+   *
+   * @param streams the number of streams.
+   * @throws std::logic_error if streams is 0.
+   * @remark has no effect if TransportType is set to <code>MEMORY</code>.
+   */
+  Builder &StreamsPerPeer(std::size_t streams);
+
+  /**
+   * @brief Set the size of the kernel send and receive buffers of sockets.
+   * @param bytes the buffer size.
+   * @throws std::logic_error if bytes is not positive.
+   * @remark has no effect if TransportType is set to <code>MEMORY</code>.
+   */
+  Builder &SocketBufferSize(int bytes);
+
+  /**
+   * @brief Set TCP_NODELAY on all sockets.
+   * @param no_delay whether to disable Nagle's algorithm.
+   * @remark has no effect if TransportType is set to <code>MEMORY</code>.
+   */
+  Builder &NoDelay(bool no_delay = true);
+
+  /**
+   * @brief Set TCP_CORK on all sockets.
+   *
+   * Partial TCP segments are then only sent when the network is flushed.
+   *
+   * @param cork whether to cork sockets.
+   * @remark has no effect if TransportType is set to <code>MEMORY</code>.
+   */
+  Builder &Cork(bool cork = true);
+
+  /**
+   * @brief Combine small writes to the same peer.
+   *
+   * Messages to a peer are held back until Network::Flush is called, or
+   * until at least <code>bytes</code> bytes are pending.
+   *
+   * @param bytes the size of the per-peer write buffer.
+   * @throws std::logic_error if bytes is 0.
+   */
+  Builder &WriteBufferSize(std::size_t bytes);
+
  protected:
   /**
    * @brief The transport type of the network we're building.
@@ -139,6 +202,22 @@ class Network::Builder {
    * @brief The logger.
    */
   std::optional<std::shared_ptr<logging::Logger>> mLogger;
+
+  /**
+   * @brief Links used by an in-memory network.
+   */
+  std::shared_ptr<MemoryHub> mHub;
+
+  /**
+   * @brief Options for sockets of a TCP network.
+   */
+  SocketOptions mSocketOptions;
+
+  /**
+   * @brief Size of the per-peer write buffer. 0 means writes are not
+   * combined.
+   */
+  std::size_t mWriteBufferSize = 0;
 };
 
 }  // namespace net
@@ -10,9 +10,12 @@ void frn::lib::net::AsyncSenderChannel::Open() {
   mConnector->Connect();
   mSender = std::async(std::launch::async, [&]() {
     while (true) {
-      std::vector<unsigned char> buf = mSendQueue.Front();
-      if (mConnector->State() != Connector::State::eActive) break;
-      mConnector->Send(buf.data(), buf.size());
+      const auto& request = mSendQueue.Front();
+      if (request.kind == Request::Kind::eClose) break;
+      if (request.kind == Request::Kind::eFlush)
+        mConnector->Flush();
+      else
+        mConnector->Send(request.data.data(), request.data.size());
       mSendQueue.PopFront();
     }
   });
@@ -20,15 +23,18 @@ void frn::lib::net::AsyncSenderChannel::Open() {
 
 void frn::lib::net::AsyncSenderChannel::Send(const unsigned char* buffer,
                                         std::size_t size) {
-  mSendQueue.PushBack({buffer, buffer + size});
+  mSendQueue.PushBack({Request::Kind::eSend, {buffer, buffer + size}});
+}
+
+void frn::lib::net::AsyncSenderChannel::Flush() {
+  // has to happen after all previous sends, so it goes through the queue.
+  mSendQueue.PushBack({Request::Kind::eFlush, {}});
 }
 
 void frn::lib::net::AsyncSenderChannel::Close() {
-  // signal the async job that we're done by closing the connector and then
-  // sending an empty message. The message ensures that sender job will check
-  // if the connector is still alive and thus exit correctly.
-  mConnector->Close();
-  unsigned char dummy = 1;
-  Send(&dummy, 1);
+  // let the sender job finish everything that was queued before closing the
+  // connector, so that no messages are lost.
+  mSendQueue.PushBack({Request::Kind::eClose, {}});
   mSender.wait();
+  mConnector->Close();
 }
@@ -66,6 +66,11 @@ class Channel {
     }
   }
 
+  /**
+   * @brief Push out anything the connector is holding back.
+   */
+  virtual void Flush() { mConnector->Flush(); }
+
   /**
    * @brief Get the state of this Channel.
    */
@@ -111,8 +116,16 @@ class AsyncSenderChannel : public Channel {
 
   void Send(const unsigned char *buffer, std::size_t size);
 
+  void Flush();
+
  private:
-  SharedDeque<std::vector<unsigned char>> mSendQueue;
+  // Work for the sender job.
+  struct Request {
+    enum class Kind { eSend, eFlush, eClose } kind;
+    std::vector<unsigned char> data;
+  };
+
+  SharedDeque<Request> mSendQueue;
   std::future<void> mSender;
 };
 
@@ -95,6 +95,11 @@ class Connector {
    */
   virtual std::int64_t Recv(unsigned char *buffer, std::size_t size) = 0;
 
+  /**
+   * @brief Push out data which the connector is holding back, if any.
+   */
+  virtual void Flush(){};
+
   /**
    * @brief Returns a string representation of this Connector.
    */
@@ -177,10 +182,15 @@ class LocalConnector : public Connector {
   };
 
   std::int64_t Recv(unsigned char *buffer, std::size_t size) {
-    auto data = mIncoming->Front();
-    auto actual_size = std::min(data.size(), size);
-    std::memcpy(buffer, data.data(), actual_size);
-    mIncoming->PopFront();
+    const auto &data = mIncoming->Front();
+    auto actual_size = std::min(data.size() - mOffset, size);
+    std::memcpy(buffer, data.data() + mOffset, actual_size);
+    // keep the rest of the message around for the next call.
+    mOffset += actual_size;
+    if (mOffset == data.size()) {
+      mIncoming->PopFront();
+      mOffset = 0;
+    }
     return actual_size;
   };
 
@@ -196,6 +206,7 @@ class LocalConnector : public Connector {
 
   BufferPtr mOutgoing = 0;
   BufferPtr mIncoming = 0;
+  std::size_t mOffset = 0;
 };
 
 /**
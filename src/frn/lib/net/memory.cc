@@ -0,0 +1,72 @@
+#include "frn/lib/net/memory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+using Clock = frn::lib::net::MemoryLink::Clock;
+
+// Waits shorter than this are spun rather than slept, since sleeping has a
+// resolution much worse than the latencies we wish to model.
+static constexpr auto kSpinThreshold = std::chrono::microseconds(100);
+
+void frn::lib::net::MemoryLink::Write(const unsigned char* buffer,
+                                      std::size_t size) {
+  Message msg;
+  msg.data = std::vector<unsigned char>(buffer, buffer + size);
+
+  if (mModel.Instant()) {
+    msg.deliver_at = Clock::time_point::min();
+  } else {
+    auto now = Clock::now();
+    auto start = std::max(now, mBusyUntil);
+    auto transmit = std::chrono::nanoseconds(0);
+    if (mModel.bandwidth)
+      transmit = std::chrono::nanoseconds(
+          (std::uint64_t)((1e9 * size) / (double)mModel.bandwidth));
+    mBusyUntil = start + transmit;
+    msg.deliver_at = mBusyUntil + mModel.latency;
+  }
+
+  mQueue.PushBack(std::move(msg));
+}
+
+frn::lib::net::MemoryLink::Message& frn::lib::net::MemoryLink::WaitForFront() {
+  Message* msg;
+  while (!(msg = mQueue.Front())) std::this_thread::yield();
+
+  while (true) {
+    auto now = Clock::now();
+    if (now >= msg->deliver_at) break;
+    if (msg->deliver_at - now > kSpinThreshold)
+      std::this_thread::sleep_until(msg->deliver_at - kSpinThreshold);
+    else
+      std::this_thread::yield();
+  }
+
+  return *msg;
+}
+
+std::size_t frn::lib::net::MemoryLink::Read(unsigned char* buffer,
+                                            std::size_t size) {
+  auto& msg = WaitForFront();
+  auto n = std::min(size, msg.data.size() - mOffset);
+  std::memcpy(buffer, msg.data.data() + mOffset, n);
+  mOffset += n;
+  if (mOffset == msg.data.size()) {
+    mQueue.PopFront();
+    mOffset = 0;
+  }
+  return n;
+}
+
+frn::lib::net::MemoryHub::MemoryHub(std::size_t n, LinkModel model)
+    : mSize(n) {
+  mLinks.reserve(n * n);
+  for (std::size_t from = 0; from < n; ++from) {
+    for (std::size_t to = 0; to < n; ++to) {
+      mLinks.emplace_back(
+          std::make_shared<MemoryLink>(from == to ? LinkModel() : model));
+    }
+  }
+}
@@ -0,0 +1,202 @@
+#ifndef _FRN_LIB_NET_MEMORY_H
+#define _FRN_LIB_NET_MEMORY_H
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "frn/lib/net/connector.h"
+#include "frn/lib/net/spsc_queue.h"
+
+namespace frn::lib {
+namespace net {
+
+/**
+ * @brief Performance model of a simulated link.
+ *
+ * A message of <code>s</code> bytes that is sent at time <code>t</code> on an
+ * idle link becomes readable at <code>t + s/bandwidth + latency</code>.
+ * Messages on the same link are serialized, so a message cannot start
+ * transmitting before the previous one has finished.
+ */
+struct LinkModel {
+  //! One-way latency added to every message.
+  std::chrono::microseconds latency{0};
+
+  //! Bandwidth in bytes per second. 0 means unlimited.
+  std::size_t bandwidth = 0;
+
+  /**
+   * @brief True if this model does not delay messages at all.
+   */
+  bool Instant() const { return latency.count() == 0 && bandwidth == 0; };
+};
+
+/**
+ * @brief A one-directional in-memory link between two parties.
+ *
+ * A link is written by exactly one party and read by exactly one party, so it
+ * is backed by a lock-free single-producer single-consumer queue.
+ */
+class MemoryLink {
+ public:
+  /**
+   * @brief Clock used for the link model.
+   */
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Create a new link.
+   * @param model the performance model of the link.
+   */
+  MemoryLink(LinkModel model) : mModel(model){};
+
+  /**
+   * @brief Write a message onto the link. Called by the sender only.
+   * @param buffer the data to send
+   * @param size the number of bytes to send
+   */
+  void Write(const unsigned char *buffer, std::size_t size);
+
+  /**
+   * @brief Read bytes from the link. Called by the receiver only.
+   *
+   * Blocks until at least one byte is available and returns as soon as some
+   * data could be read.
+   *
+   * @param buffer where to write the received bytes
+   * @param size the maximum number of bytes to read
+   * @return the number of bytes read.
+   */
+  std::size_t Read(unsigned char *buffer, std::size_t size);
+
+  /**
+   * @brief Change the performance model of this link.
+   */
+  void SetModel(LinkModel model) { mModel = model; };
+
+  /**
+   * @brief Get the performance model of this link.
+   */
+  LinkModel Model() const { return mModel; };
+
+ private:
+  struct Message {
+    Clock::time_point deliver_at;
+    std::vector<unsigned char> data;
+  };
+
+  // wait until the front message exists and is delivered.
+  Message &WaitForFront();
+
+  LinkModel mModel;
+
+  SpscQueue<Message> mQueue;
+
+  // sender side: time at which the link is done transmitting.
+  Clock::time_point mBusyUntil;
+
+  // receiver side: how much of the front message has been read already.
+  std::size_t mOffset = 0;
+};
+
+/**
+ * @brief A set of in-memory links connecting n parties.
+ *
+ * A MemoryHub is shared by all parties in a simulation and owns the n*n
+ * directed links between them. Links from a party to itself are never
+ * delayed.
+ */
+class MemoryHub {
+ public:
+  /**
+   * @brief Create a hub for n parties where all links follow the same model.
+   * @param n the number of parties
+   * @param model the model used for links between distinct parties
+   */
+  MemoryHub(std::size_t n, LinkModel model = LinkModel());
+
+  /**
+   * @brief Helper to create a hub behind a shared pointer.
+   */
+  static std::shared_ptr<MemoryHub> Create(std::size_t n,
+                                           LinkModel model = LinkModel()) {
+    return std::make_shared<MemoryHub>(n, model);
+  };
+
+  /**
+   * @brief Set the model of the link from one party to another.
+   * @param from the sender
+   * @param to the receiver
+   * @param model the new model
+   */
+  void SetLinkModel(std::size_t from, std::size_t to, LinkModel model) {
+    Link(from, to)->SetModel(model);
+  };
+
+  /**
+   * @brief Get the link used for messages from one party to another.
+   */
+  std::shared_ptr<MemoryLink> Link(std::size_t from, std::size_t to) const {
+    return mLinks[from * mSize + to];
+  };
+
+  /**
+   * @brief The number of parties connected through this hub.
+   */
+  std::size_t Size() const { return mSize; };
+
+ private:
+  std::size_t mSize;
+  std::vector<std::shared_ptr<MemoryLink>> mLinks;
+};
+
+/**
+ * @brief A Connector which talks to a party in the same process.
+ */
+class MemoryConnector : public Connector {
+ public:
+  /**
+   * @brief Create a connector from an outgoing and an incoming link.
+   * @param out link for outgoing messages
+   * @param in link for incoming messages
+   */
+  MemoryConnector(std::shared_ptr<MemoryLink> out,
+                  std::shared_ptr<MemoryLink> in)
+      : mOutgoing(out), mIncoming(in) {
+    if (!(mOutgoing && mIncoming))
+      throw std::logic_error("links cannot be null");
+  };
+
+  std::int64_t Send(const unsigned char *buffer, std::size_t size) override {
+    mOutgoing->Write(buffer, size);
+    return size;
+  };
+
+  std::int64_t Recv(unsigned char *buffer, std::size_t size) override {
+    return mIncoming->Read(buffer, size);
+  };
+
+  /**
+   * @brief Returns <code>"MemoryConnector(state = ...)"</code>.
+   */
+  std::string ToString() const override {
+    std::stringstream ss;
+    ss << "MemoryConnector(state = " << utils::to_string(State()) << ")";
+    return ss.str();
+  };
+
+ private:
+  void EstablishConnection() override{};
+
+  void TeardownConnection() override{};
+
+  std::shared_ptr<MemoryLink> mOutgoing;
+  std::shared_ptr<MemoryLink> mIncoming;
+};
+
+}  // namespace net
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_NET_MEMORY_H
@@ -0,0 +1,356 @@
+#include "frn/lib/net/mesh.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+using SystemInterface = frn::lib::net::SystemInterface;
+
+// Sent by the connecting party on a new connection: 4 magic bytes followed by
+// the ID of the sender and the index of the stream.
+static constexpr unsigned char kHandshakeMagic[4] = {'F', 'R', 'N', '1'};
+static constexpr std::size_t kHandshakeSize = 12;
+
+static inline bool write_all(std::shared_ptr<SystemInterface>& system,
+                             int sock, const unsigned char* buffer,
+                             std::size_t size) {
+  while (size > 0) {
+    auto n = system->write(sock, buffer, size);
+    if (n <= 0) return false;
+    buffer += n;
+    size -= n;
+  }
+  return true;
+}
+
+static inline bool read_all(std::shared_ptr<SystemInterface>& system, int sock,
+                            unsigned char* buffer, std::size_t size) {
+  while (size > 0) {
+    auto n = system->read(sock, buffer, size);
+    if (n <= 0) return false;
+    buffer += n;
+    size -= n;
+  }
+  return true;
+}
+
+frn::lib::net::ConnectionManager::ConnectionManager(
+    std::shared_ptr<SystemInterface> system, int id,
+    std::vector<std::string> hosts, std::vector<int> ports,
+    SocketOptions options)
+    : mSystem(system),
+      mId(id),
+      mHosts(hosts),
+      mPorts(ports),
+      mOptions(options) {
+  if (mHosts.size() != mPorts.size())
+    throw std::invalid_argument("need exactly one port per host");
+  if (mId < 0 || (std::size_t)mId >= mHosts.size())
+    throw std::invalid_argument("identifier out of range");
+  for (auto port : mPorts)
+    if (invalid_port(port)) throw std::invalid_argument("invalid port");
+  if (!mOptions.streams)
+    throw std::invalid_argument("need at least one stream per peer");
+  mSockets = std::vector<std::vector<int>>(
+      mHosts.size(), std::vector<int>(mOptions.streams, -1));
+}
+
+void frn::lib::net::ConnectionManager::Connect() {
+  if (mConnected) return;
+
+  // listen before dialing, so that peers dialing us do not have to wait for
+  // our own outgoing connections.
+  const bool has_larger_peers = (std::size_t)mId + 1 < Size();
+  int listen_socket = has_larger_peers ? Listen() : -1;
+
+  const std::uint32_t streams = mOptions.streams;
+  std::vector<std::future<int>> dials;
+  dials.reserve(mId * streams);
+  for (int peer = 0; peer < mId; ++peer) {
+    for (std::uint32_t stream = 0; stream < streams; ++stream) {
+      dials.emplace_back(std::async(std::launch::async, [this, peer, stream]() {
+        return DialPeer(peer, stream);
+      }));
+    }
+  }
+
+  if (has_larger_peers) {
+    AcceptPeers(listen_socket);
+    mSystem->close(listen_socket);
+  }
+
+  for (int peer = 0; peer < mId; ++peer) {
+    for (std::uint32_t stream = 0; stream < streams; ++stream)
+      mSockets[peer][stream] = dials[peer * streams + stream].get();
+  }
+
+  mConnected = true;
+}
+
+int frn::lib::net::ConnectionManager::Listen() {
+  int sock = mSystem->create_socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0) Throw("could not acquire socket");
+
+  int opt = 1;
+  if (mSystem->set_socket_options(sock, SOL_SOCKET, SO_REUSEADDR, &opt,
+                                  sizeof(opt)) < 0)
+    Throw("could not set options on socket");
+
+  // accepted sockets inherit the buffer sizes of the listening socket.
+  SetBufferSizes(sock);
+
+  struct sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(Port());
+
+  if (mSystem->bind(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+    Throw("bind");
+
+  if (mSystem->listen(sock, Size()) < 0) Throw("listen");
+
+  return sock;
+}
+
+void frn::lib::net::ConnectionManager::AcceptPeers(int listen_socket) {
+  std::size_t remaining = (Size() - mId - 1) * mOptions.streams;
+
+  while (remaining > 0) {
+    int sock = mSystem->accept(listen_socket, nullptr, nullptr);
+    if (sock < 0) Throw("could not accept connection from peer");
+
+    unsigned char handshake[kHandshakeSize];
+    if (!read_all(mSystem, sock, handshake, kHandshakeSize) ||
+        std::memcmp(handshake, kHandshakeMagic, sizeof(kHandshakeMagic))) {
+      // not one of ours.
+      mSystem->close(sock);
+      continue;
+    }
+
+    std::uint32_t peer, stream;
+    std::memcpy(&peer, handshake + sizeof(kHandshakeMagic), sizeof(peer));
+    std::memcpy(&stream, handshake + sizeof(kHandshakeMagic) + sizeof(peer),
+                sizeof(stream));
+    peer = ntohl(peer);
+    stream = ntohl(stream);
+
+    if (peer <= (std::uint32_t)mId || peer >= Size() ||
+        stream >= mOptions.streams || mSockets[peer][stream] >= 0) {
+      mSystem->close(sock);
+      continue;
+    }
+
+    SetTcpOptions(sock);
+    mSockets[peer][stream] = sock;
+    remaining--;
+  }
+}
+
+int frn::lib::net::ConnectionManager::DialPeer(int peer,
+                                               std::uint32_t stream) {
+  using namespace std::chrono_literals;
+
+  struct sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(mPorts[peer]);
+  if (mSystem->inet_to_int(AF_INET, mHosts[peer].c_str(), &addr.sin_addr) != 1)
+    throw std::runtime_error("invalid hostname");
+
+  unsigned char handshake[kHandshakeSize];
+  std::uint32_t id = htonl(mId);
+  stream = htonl(stream);
+  std::memcpy(handshake, kHandshakeMagic, sizeof(kHandshakeMagic));
+  std::memcpy(handshake + sizeof(kHandshakeMagic), &id, sizeof(id));
+  std::memcpy(handshake + sizeof(kHandshakeMagic) + sizeof(id), &stream,
+              sizeof(stream));
+
+  std::chrono::microseconds backoff = CONNECT_BACKOFF_MIN;
+  const std::chrono::microseconds max_backoff = CONNECT_BACKOFF_MAX;
+
+  while (true) {
+    int sock = mSystem->create_socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) Throw("could not acquire socket");
+    SetBufferSizes(sock);
+
+    if (mSystem->connect(sock, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+      if (!write_all(mSystem, sock, handshake, kHandshakeSize))
+        Throw("could not send handshake");
+      // after the handshake, which would otherwise sit in a corked socket.
+      SetTcpOptions(sock);
+      return sock;
+    }
+
+    // the state of a socket is unspecified after a failed connect, so start
+    // over with a fresh one.
+    mSystem->close(sock);
+    std::this_thread::sleep_for(backoff);
+    backoff = std::min(2 * backoff, max_backoff);
+  }
+}
+
+void frn::lib::net::ConnectionManager::SetBufferSizes(int sock) {
+  int size = mOptions.buffer_size;
+  if (!size) return;
+  if (mSystem->set_socket_options(sock, SOL_SOCKET, SO_SNDBUF, &size,
+                                  sizeof(size)) < 0 ||
+      mSystem->set_socket_options(sock, SOL_SOCKET, SO_RCVBUF, &size,
+                                  sizeof(size)) < 0)
+    Throw("could not set socket buffer sizes");
+}
+
+void frn::lib::net::ConnectionManager::SetTcpOptions(int sock) {
+  int opt = 1;
+  if (mOptions.no_delay &&
+      mSystem->set_socket_options(sock, IPPROTO_TCP, TCP_NODELAY, &opt,
+                                  sizeof(opt)) < 0)
+    Throw("could not set TCP_NODELAY");
+  if (mOptions.cork && mSystem->set_socket_options(sock, IPPROTO_TCP, TCP_CORK,
+                                                   &opt, sizeof(opt)) < 0)
+    Throw("could not set TCP_CORK");
+}
+
+void frn::lib::net::ConnectionManager::Throw(std::string error_message) {
+  auto err = mSystem->get_errno();
+  throw std::system_error(err, std::generic_category(), error_message.c_str());
+}
+
+frn::lib::net::TCPMeshConnector::Worker::Worker()
+    : mThread([this]() {
+        while (true) {
+          auto job = std::move(mJobs.Front());
+          mJobs.PopFront();
+          // an empty job means we're done.
+          if (!job.valid()) break;
+          job();
+        }
+      }) {}
+
+frn::lib::net::TCPMeshConnector::Worker::~Worker() {
+  mJobs.PushBack(std::packaged_task<void()>());
+  mThread.join();
+}
+
+std::future<void> frn::lib::net::TCPMeshConnector::Worker::Submit(
+    std::function<void()> job) {
+  std::packaged_task<void()> task(std::move(job));
+  auto result = task.get_future();
+  mJobs.PushBack(std::move(task));
+  return result;
+}
+
+void frn::lib::net::TCPMeshConnector::EstablishConnection() {
+  mManager->Connect();
+  mSockets = mManager->Sockets(mPeer);
+  mSocket = mSockets[0];
+
+  if (mSockets.size() > 1) {
+    for (std::size_t i = 0; i < mSockets.size(); ++i) {
+      mSendWorkers.emplace_back(std::make_unique<Worker>());
+      mRecvWorkers.emplace_back(std::make_unique<Worker>());
+    }
+  }
+}
+
+void frn::lib::net::TCPMeshConnector::TeardownConnection() {
+  mSendWorkers.clear();
+  mRecvWorkers.clear();
+  for (auto sock : mSockets) {
+    if (mSystem->close(sock) < 0)
+      set_error_and_throw("error while closing socket");
+  }
+}
+
+std::vector<std::vector<frn::lib::net::TCPMeshConnector::Segment>>
+frn::lib::net::TCPMeshConnector::Stripe(std::size_t pos,
+                                        std::size_t size) const {
+  const std::size_t k = mSockets.size();
+  std::vector<std::vector<Segment>> segments(k);
+  std::size_t offset = 0;
+  while (offset < size) {
+    const std::size_t p = pos + offset;
+    const std::size_t stream = (p / STRIPE_SEGMENT_SIZE) % k;
+    const std::size_t len =
+        std::min(STRIPE_SEGMENT_SIZE - p % STRIPE_SEGMENT_SIZE, size - offset);
+    segments[stream].push_back({offset, len});
+    offset += len;
+  }
+  return segments;
+}
+
+void frn::lib::net::TCPMeshConnector::Transfer(
+    std::size_t& pos, std::size_t size,
+    std::vector<std::unique_ptr<Worker>>& workers,
+    const std::function<void(int, const Segment&)>& io) {
+  auto segments = Stripe(pos, size);
+  pos += size;
+
+  auto run = [&](std::size_t stream) {
+    for (const auto& seg : segments[stream]) io(mSockets[stream], seg);
+  };
+
+  // small messages only touch a single stream, so there's no point in
+  // involving the workers.
+  const std::size_t touched =
+      std::count_if(segments.begin(), segments.end(),
+                    [](const auto& segs) { return !segs.empty(); });
+
+  if (touched == 1) {
+    for (std::size_t i = 0; i < segments.size(); ++i)
+      if (!segments[i].empty()) run(i);
+    return;
+  }
+
+  std::vector<std::future<void>> pending;
+  for (std::size_t i = 0; i < segments.size(); ++i) {
+    if (segments[i].empty()) continue;
+    pending.emplace_back(workers[i]->Submit([&run, i]() { run(i); }));
+  }
+  // wait for everyone before rethrowing, since jobs refer to our stack.
+  for (auto& p : pending) p.wait();
+  for (auto& p : pending) p.get();
+}
+
+void frn::lib::net::TCPMeshConnector::Flush() {
+  if (!mManager->Options().cork) return;
+  // clearing TCP_CORK sends whatever is pending right away.
+  int off = 0, on = 1;
+  for (auto sock : mSockets) {
+    if (mSystem->set_socket_options(sock, IPPROTO_TCP, TCP_CORK, &off,
+                                    sizeof(off)) < 0 ||
+        mSystem->set_socket_options(sock, IPPROTO_TCP, TCP_CORK, &on,
+                                    sizeof(on)) < 0)
+      set_error_and_throw("could not flush socket");
+  }
+}
+
+std::int64_t frn::lib::net::TCPMeshConnector::Send(const unsigned char* buffer,
+                                                   std::size_t size) {
+  if (mSockets.size() == 1) return TCPConnector::Send(buffer, size);
+
+  Transfer(mSendPos, size, mSendWorkers, [&](int sock, const Segment& seg) {
+    if (!write_all(mSystem, sock, buffer + seg.offset, seg.size))
+      set_error_and_throw("write failed");
+  });
+  return size;
+}
+
+std::int64_t frn::lib::net::TCPMeshConnector::Recv(unsigned char* buffer,
+                                                   std::size_t size) {
+  if (mSockets.size() == 1) return TCPConnector::Recv(buffer, size);
+
+  Transfer(mRecvPos, size, mRecvWorkers, [&](int sock, const Segment& seg) {
+    if (!read_all(mSystem, sock, buffer + seg.offset, seg.size))
+      set_error_and_throw("recv failed");
+  });
+  return size;
+}
@@ -0,0 +1,243 @@
+#ifndef _FRN_LIB_NET_MESH_H
+#define _FRN_LIB_NET_MESH_H
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frn/lib/net/connector.h"
+#include "frn/lib/net/shared_deque.h"
+#include "frn/lib/net/sysi.h"
+
+/**
+ * @brief Initial wait before retrying to connect to a peer.
+ */
+#ifndef CONNECT_BACKOFF_MIN
+#define CONNECT_BACKOFF_MIN 1ms
+#endif
+
+/**
+ * @brief Upper bound on the wait between two connection attempts.
+ */
+#ifndef CONNECT_BACKOFF_MAX
+#define CONNECT_BACKOFF_MAX 256ms
+#endif
+
+/**
+ * @brief Number of consecutive bytes sent on one stream before moving on to
+ * the next when a peer is connected through several streams.
+ */
+#ifndef STRIPE_SEGMENT_SIZE
+#define STRIPE_SEGMENT_SIZE 65536
+#endif
+
+namespace frn::lib {
+namespace net {
+
+/**
+ * @brief Options applied to every socket of a mesh.
+ */
+struct SocketOptions {
+  /**
+   * @brief The number of TCP streams between each pair of parties.
+   */
+  std::size_t streams = 1;
+
+  /**
+   * @brief Size of the kernel send and receive buffers. 0 means the system
+   * default.
+   */
+  int buffer_size = 0;
+
+  /**
+   * @brief Whether to disable Nagle's algorithm.
+   */
+  bool no_delay = false;
+
+  /**
+   * @brief Whether to set TCP_CORK, so that partial segments are only sent
+   * when a connector is flushed.
+   */
+  bool cork = false;
+};
+
+/**
+ * @brief Establishes a full mesh of TCP connections between n parties.
+ *
+ * Each party listens on a single port. A party connects to all peers with a
+ * smaller identifier and accepts connections from all peers with a larger
+ * identifier. All outgoing connections are attempted concurrently, and failed
+ * attempts are retried with exponential back-off. The first thing a party
+ * sends on a new connection is a small handshake identifying it, so incoming
+ * connections can be accepted in any order.
+ *
+ * Optionally, every pair of parties is connected through several streams.
+ */
+class ConnectionManager {
+ public:
+  /**
+   * @brief Create a new connection manager.
+   *
+   * @param system access to system calls
+   * @param id the identifier of the local party
+   * @param hosts the address of every party
+   * @param ports the port every party listens on
+   * @param options options for all sockets
+   * @throws std::invalid_argument if hosts and ports do not have the same
+   *   size, if id is out of range or if the number of streams is 0.
+   */
+  ConnectionManager(std::shared_ptr<SystemInterface> system, int id,
+                    std::vector<std::string> hosts, std::vector<int> ports,
+                    SocketOptions options = SocketOptions());
+
+  ConnectionManager(const ConnectionManager &) = delete;
+  ConnectionManager &operator=(const ConnectionManager &) = delete;
+
+  /**
+   * @brief Connect to all peers.
+   *
+   * Returns once a connection to every other party has been established.
+   * Calling Connect more than once has no effect.
+   *
+   * @throws std::system_error if the listening socket could not be created.
+   */
+  void Connect();
+
+  /**
+   * @brief Get the sockets connected to a particular peer, ordered by stream.
+   * @pre Connect has been called.
+   */
+  const std::vector<int> &Sockets(int peer) const { return mSockets[peer]; };
+
+  /**
+   * @brief The number of parties in the mesh.
+   */
+  std::size_t Size() const { return mHosts.size(); };
+
+  /**
+   * @brief The port the local party listens on.
+   */
+  int Port() const { return mPorts[mId]; };
+
+  /**
+   * @brief The options applied to all sockets.
+   */
+  const SocketOptions &Options() const { return mOptions; };
+
+ private:
+  // Listen on our port and accept a connection from every larger peer.
+  void AcceptPeers(int listen_socket);
+
+  // Connect to a smaller peer, retrying until it is listening.
+  int DialPeer(int peer, std::uint32_t stream);
+
+  int Listen();
+
+  // Must be called before a socket is connected or starts listening.
+  void SetBufferSizes(int sock);
+
+  // TCP level options, set once a socket is connected.
+  void SetTcpOptions(int sock);
+
+  void Throw(std::string error_message);
+
+  std::shared_ptr<SystemInterface> mSystem;
+  int mId;
+  std::vector<std::string> mHosts;
+  std::vector<int> mPorts;
+  SocketOptions mOptions;
+  std::vector<std::vector<int>> mSockets;
+  bool mConnected = false;
+};
+
+/**
+ * @brief A TCP Connector which gets its sockets from a ConnectionManager.
+ *
+ * If the peer is connected through more than one stream, data is striped
+ * across the streams in segments of STRIPE_SEGMENT_SIZE bytes. Which stream a
+ * byte goes on only depends on its position in the overall byte stream, so
+ * sends and receives of any size can be mixed freely. Segments for different
+ * streams are written and read in parallel.
+ */
+class TCPMeshConnector : public TCPConnector {
+ public:
+  /**
+   * @brief Constructor.
+   * @param system pointer for accessing system calls.
+   * @param manager the manager that owns the mesh.
+   * @param peer the remote party.
+   */
+  TCPMeshConnector(std::shared_ptr<SystemInterface> system,
+                   std::shared_ptr<ConnectionManager> manager, int peer)
+      : TCPConnector(system), mManager(manager), mPeer(peer){};
+
+  std::int64_t Send(const unsigned char *buffer, std::size_t size) override;
+
+  std::int64_t Recv(unsigned char *buffer, std::size_t size) override;
+
+  /**
+   * @brief Uncork all sockets, if corked, so that partial segments are sent.
+   */
+  void Flush() override;
+
+  /**
+   * @brief Returns <code>"TCPMeshConnector(state = ..., peer = ...,
+   * streams = ...)"</code>.
+   */
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << "TCPMeshConnector(state = " << utils::to_string(State())
+       << ", peer = " << mPeer << ", streams = " << mSockets.size() << ")";
+    return ss.str();
+  };
+
+ private:
+  // Runs jobs for a single stream in a separate thread.
+  class Worker {
+   public:
+    Worker();
+    ~Worker();
+    std::future<void> Submit(std::function<void()> job);
+
+   private:
+    SharedDeque<std::packaged_task<void()>> mJobs;
+    std::thread mThread;
+  };
+
+  // A piece of a buffer that goes on a single stream.
+  struct Segment {
+    std::size_t offset;
+    std::size_t size;
+  };
+
+  // Split size bytes at stream position pos into per-stream segments.
+  std::vector<std::vector<Segment>> Stripe(std::size_t pos,
+                                           std::size_t size) const;
+
+  // Apply io to every segment of a transfer, in parallel across streams.
+  void Transfer(std::size_t &pos, std::size_t size,
+                std::vector<std::unique_ptr<Worker>> &workers,
+                const std::function<void(int, const Segment &)> &io);
+
+  void EstablishConnection() override;
+
+  void TeardownConnection() override;
+
+  std::shared_ptr<ConnectionManager> mManager;
+  int mPeer;
+  std::vector<int> mSockets;
+  std::vector<std::unique_ptr<Worker>> mSendWorkers;
+  std::vector<std::unique_ptr<Worker>> mRecvWorkers;
+  std::size_t mSendPos = 0;
+  std::size_t mRecvPos = 0;
+};
+
+}  // namespace net
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_NET_MESH_H
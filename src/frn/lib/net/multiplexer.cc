@@ -0,0 +1,141 @@
+#include "frn/lib/net/multiplexer.h"
+
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+// A frame header is the session ID followed by the payload length.
+static constexpr std::size_t kHeaderSize = 8;
+
+static inline void write_header(unsigned char *buffer, std::uint32_t session,
+                                std::uint32_t size) {
+  session = htonl(session);
+  size = htonl(size);
+  std::memcpy(buffer, &session, sizeof(session));
+  std::memcpy(buffer + sizeof(session), &size, sizeof(size));
+}
+
+static inline void read_header(const unsigned char *buffer,
+                               std::uint32_t &session, std::uint32_t &size) {
+  std::memcpy(&session, buffer, sizeof(session));
+  std::memcpy(&size, buffer + sizeof(session), sizeof(size));
+  session = ntohl(session);
+  size = ntohl(size);
+}
+
+void frn::lib::net::Multiplexer::Queue::Push(std::vector<unsigned char> &&data) {
+  std::unique_lock<std::mutex> lock(mMutex);
+  mData.emplace_back(std::move(data));
+  lock.unlock();
+  mCond.notify_one();
+}
+
+void frn::lib::net::Multiplexer::Queue::Pop(unsigned char *buffer,
+                                            std::size_t size) {
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (size > 0) {
+    mCond.wait(lock, [this]() { return !mData.empty(); });
+    auto &front = mData.front();
+    auto n = std::min(front.size() - mOffset, size);
+    std::memcpy(buffer, front.data() + mOffset, n);
+    buffer += n;
+    size -= n;
+    mOffset += n;
+    if (mOffset == front.size()) {
+      mData.pop_front();
+      mOffset = 0;
+    }
+  }
+}
+
+frn::lib::net::Multiplexer::Multiplexer(std::shared_ptr<Network> network)
+    : mNetwork(network), mSendMutexes(network->Size()) {}
+
+frn::lib::net::Multiplexer::~Multiplexer() { Stop(); }
+
+void frn::lib::net::Multiplexer::Start() {
+  if (mRunning) return;
+  for (std::size_t i = 0; i < Size(); ++i) {
+    // messages to ourselves go directly into the receive queue.
+    if ((int)i == LocalPeerId()) continue;
+    mReaders.emplace_back([this, i]() { ReadFrom(i); });
+  }
+  mRunning = true;
+}
+
+void frn::lib::net::Multiplexer::Stop() {
+  if (!mRunning) return;
+  unsigned char frame[kHeaderSize];
+  write_header(frame, kCloseSession, 0);
+  for (std::size_t i = 0; i < Size(); ++i) {
+    if ((int)i == LocalPeerId()) continue;
+    std::lock_guard<std::mutex> lock(mSendMutexes[i]);
+    mNetwork->SendTo(i, frame, kHeaderSize);
+    mNetwork->Flush(i);
+  }
+  for (auto &reader : mReaders) reader.join();
+  mReaders.clear();
+  mRunning = false;
+}
+
+void frn::lib::net::Multiplexer::SendTo(std::uint32_t session, int id,
+                                        const unsigned char *data,
+                                        std::size_t size) {
+  if (session == kCloseSession)
+    throw std::invalid_argument("session ID is reserved");
+  if (size > std::numeric_limits<std::uint32_t>::max())
+    throw std::invalid_argument("message too large");
+
+  if (id == LocalPeerId()) {
+    QueueFor(session, id).Push({data, data + size});
+    return;
+  }
+
+  // header and payload go out as one message, so that concurrent sessions
+  // cannot interleave them.
+  std::vector<unsigned char> frame(kHeaderSize + size);
+  write_header(frame.data(), session, size);
+  std::memcpy(frame.data() + kHeaderSize, data, size);
+
+  // sessions do not know about each other's rounds, so frames are never held
+  // back.
+  std::lock_guard<std::mutex> lock(mSendMutexes[id]);
+  mNetwork->SendTo(id, frame.data(), frame.size());
+  mNetwork->Flush(id);
+}
+
+void frn::lib::net::Multiplexer::RecvFrom(std::uint32_t session, int id,
+                                          unsigned char *buffer,
+                                          std::size_t size) {
+  QueueFor(session, id).Pop(buffer, size);
+}
+
+frn::lib::net::Multiplexer::Queue &frn::lib::net::Multiplexer::QueueFor(
+    std::uint32_t session, int id) {
+  std::lock_guard<std::mutex> lock(mQueuesMutex);
+  auto &queues = mQueues[session];
+  if (queues.empty()) {
+    queues.reserve(Size());
+    for (std::size_t i = 0; i < Size(); ++i)
+      queues.emplace_back(std::make_unique<Queue>());
+  }
+  return *queues[id];
+}
+
+void frn::lib::net::Multiplexer::ReadFrom(int id) {
+  unsigned char header[kHeaderSize];
+  while (true) {
+    mNetwork->RecvFrom(id, header, kHeaderSize);
+    std::uint32_t session, size;
+    read_header(header, session, size);
+
+    if (session == kCloseSession) break;
+
+    std::vector<unsigned char> data(size);
+    mNetwork->RecvFrom(id, data.data(), size);
+    QueueFor(session, id).Push(std::move(data));
+  }
+}
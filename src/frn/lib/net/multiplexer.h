@@ -0,0 +1,131 @@
+#ifndef _FRN_LIB_NET_MULTIPLEXER_H
+#define _FRN_LIB_NET_MULTIPLEXER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "frn/lib/net/network.h"
+
+namespace frn::lib {
+namespace net {
+
+/**
+ * @brief Runs several independent sessions over the channels of one Network.
+ *
+ * Every message is framed with the ID of the session it belongs to and its
+ * length. A reader thread per peer demultiplexes incoming frames into a
+ * receive queue per session and peer, so a session only ever sees its own
+ * messages, in the order they were sent. Sessions can therefore be used
+ * concurrently from different threads, e.g., to run several protocol
+ * instances at the same time.
+ *
+ * Once Start has been called, the underlying Network must not be used
+ * directly until Stop has returned.
+ */
+class Multiplexer {
+ public:
+  /**
+   * @brief Reserved session ID used to signal that a peer is done.
+   */
+  static constexpr std::uint32_t kCloseSession = 0xFFFFFFFF;
+
+  /**
+   * @brief Create a new multiplexer.
+   * @param network a connected network.
+   */
+  Multiplexer(std::shared_ptr<Network> network);
+
+  Multiplexer(const Multiplexer &) = delete;
+  Multiplexer &operator=(const Multiplexer &) = delete;
+
+  /**
+   * @brief Destructor. Calls Stop.
+   */
+  ~Multiplexer();
+
+  /**
+   * @brief Start reading from all peers.
+   */
+  void Start();
+
+  /**
+   * @brief Stop reading from all peers.
+   *
+   * Tells every peer that we are done, and returns once every peer has told
+   * us the same. All parties must therefore call Stop.
+   */
+  void Stop();
+
+  /**
+   * @brief Send some bytes to a party in a session.
+   * @param session the session ID
+   * @param id the identity of the receiver
+   * @param data a pointer to the data to send
+   * @param size how many bytes to send
+   * @throws std::invalid_argument if session is kCloseSession or if the
+   *   message does not fit in a single frame.
+   */
+  void SendTo(std::uint32_t session, int id, const unsigned char *data,
+              std::size_t size);
+
+  /**
+   * @brief Receive bytes from a party in a session.
+   *
+   * Blocks until enough bytes have been received. Message boundaries are not
+   * preserved, so any number of bytes can be received at a time.
+   *
+   * @param session the session ID
+   * @param id the identity of the sender
+   * @param buffer where to store the received data
+   * @param size how many bytes are expected to be received
+   */
+  void RecvFrom(std::uint32_t session, int id, unsigned char *buffer,
+                std::size_t size);
+
+  /**
+   * @brief Return the amount of peers in the network.
+   */
+  std::size_t Size() const { return mNetwork->Size(); };
+
+  /**
+   * @brief Return the identifier for the local peer.
+   */
+  int LocalPeerId() const { return mNetwork->LocalPeerId(); };
+
+ private:
+  // Bytes received from one peer in one session.
+  class Queue {
+   public:
+    void Push(std::vector<unsigned char> &&data);
+    void Pop(unsigned char *buffer, std::size_t size);
+
+   private:
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    std::deque<std::vector<unsigned char>> mData;
+    std::size_t mOffset = 0;
+  };
+
+  Queue &QueueFor(std::uint32_t session, int id);
+
+  // Body of the reader thread for a peer.
+  void ReadFrom(int id);
+
+  std::shared_ptr<Network> mNetwork;
+  std::vector<std::mutex> mSendMutexes;
+  std::mutex mQueuesMutex;
+  std::map<std::uint32_t, std::vector<std::unique_ptr<Queue>>> mQueues;
+  std::vector<std::thread> mReaders;
+  bool mRunning = false;
+};
+
+}  // namespace net
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_NET_MULTIPLEXER_H
@@ -34,6 +34,9 @@ class Network {
     //! Channels are connected via. TCP
     eTcp,
 
+    //! Channels are in-memory links shared by parties in the same process.
+    eMemory,
+
     //! Dummy TransportType. Used in testing.
     eFake
   };
@@ -49,9 +52,10 @@ class Network {
   };
 
   /**
-   * @brief Close the network.
+   * @brief Close the network. Flushes all pending writes first.
    */
   void Close() {
+    Flush();
     for (std::size_t i = 0; i < mSize; ++i) {
       LOG_INFO(mLogger, "closing %", mChannels[i]->ToString());
       mChannels[i]->Close();
@@ -60,12 +64,49 @@ class Network {
 
   /**
    * @brief Send some bytes to a particular party.
+   *
+   * If the network combines writes, small messages are held back until Flush
+   * is called or enough data has been sent to the party.
+   *
    * @param id the identity of the receiver
    * @param data a pointer to the data to send
    * @param size how many bytes to send
    */
   virtual void SendTo(int id, const unsigned char *data, std::size_t size) {
-    mChannels[id]->Send(data, size);
+    mUnflushed[id] = true;
+    if (!mWriteBufferSize) {
+      mChannels[id]->Send(data, size);
+      return;
+    }
+
+    auto &pending = mPending[id];
+    if (pending.size() + size > mWriteBufferSize) {
+      SendPending(id);
+      // no point in copying large messages.
+      if (size >= mWriteBufferSize) {
+        mChannels[id]->Send(data, size);
+        return;
+      }
+    }
+    pending.insert(pending.end(), data, data + size);
+  };
+
+  /**
+   * @brief Send everything held back for a particular party.
+   * @param id the identity of the receiver
+   */
+  void Flush(int id) {
+    if (!mUnflushed[id]) return;
+    SendPending(id);
+    mChannels[id]->Flush();
+    mUnflushed[id] = false;
+  };
+
+  /**
+   * @brief Send everything held back for all parties.
+   */
+  void Flush() {
+    for (std::size_t i = 0; i < mSize; ++i) Flush(i);
   };
 
   /**
@@ -81,6 +122,10 @@ class Network {
 
   /**
    * @brief Recveive from a particular party.
+   *
+   * This does not flush pending writes, so when writes are combined, callers
+   * must Flush anything the sender might be waiting for.
+   *
    * @param id the identity of the sender
    * @param buffer where to store the received data
    * @param size how many bytes are expected to be received
@@ -108,15 +153,28 @@ class Network {
    * @param ttype enum denoting how connections are established.
    * @param channels channels between the different peers.
    * @param logger the logger to use.
+   * @param write_buffer_size combine writes to a peer until this many bytes
+   *   are pending. 0 disables combining.
    */
   Network(int id, std::size_t n, TransportType ttype,
           std::vector<std::unique_ptr<Channel>> &channels,
-          std::shared_ptr<logging::Logger> logger)
+          std::shared_ptr<logging::Logger> logger,
+          std::size_t write_buffer_size = 0)
       : mId(id),
         mSize(n),
         mTransportType(ttype),
         mChannels(std::move(channels)),
-        mLogger(std::move(logger)){};
+        mLogger(std::move(logger)),
+        mWriteBufferSize(write_buffer_size),
+        mPending(n),
+        mUnflushed(n, false){};
+
+  void SendPending(int id) {
+    auto &pending = mPending[id];
+    if (pending.empty()) return;
+    mChannels[id]->Send(pending.data(), pending.size());
+    pending.clear();
+  };
 
  protected:
   int mId = 0;
@@ -124,6 +182,10 @@ class Network {
   TransportType mTransportType;
   std::vector<std::unique_ptr<Channel>> mChannels;
   std::shared_ptr<logging::Logger> mLogger;
+  std::size_t mWriteBufferSize = 0;
+  std::vector<std::vector<unsigned char>> mPending;
+  // not a vector<bool>, since different peers may be flushed concurrently.
+  std::vector<char> mUnflushed;
 };
 
 constexpr int Network::kBasePort;
@@ -0,0 +1,90 @@
+#ifndef _FRN_LIB_NET_SPSCQUEUE_H
+#define _FRN_LIB_NET_SPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+namespace frn::lib {
+namespace net {
+
+/**
+ * @brief An unbounded lock-free single-producer single-consumer queue.
+ *
+ * The queue is a singly linked list with a dummy head node. The producer only
+ * ever touches the tail and the consumer only ever touches the head, so the
+ * only synchronization needed is a release/acquire pair on the
+ * <code>next</code> pointer of the most recently pushed node.
+ *
+ * Exactly one thread may call PushBack and exactly one (possibly different)
+ * thread may call Front, PopFront and Empty.
+ */
+template <typename T>
+class SpscQueue {
+ public:
+  SpscQueue() : mHead(new Node), mTail(mHead){};
+
+  SpscQueue(const SpscQueue &) = delete;
+  SpscQueue &operator=(const SpscQueue &) = delete;
+
+  ~SpscQueue() {
+    while (mHead) {
+      Node *next = mHead->next.load(std::memory_order_relaxed);
+      delete mHead;
+      mHead = next;
+    }
+  };
+
+  /**
+   * @brief Move an item to the back of the queue. Producer only.
+   */
+  void PushBack(T &&item) {
+    Node *node = new Node;
+    node->value = std::move(item);
+    mTail->next.store(node, std::memory_order_release);
+    mTail = node;
+  };
+
+  /**
+   * @brief Peek at the front of the queue. Consumer only.
+   * @return a pointer to the front item, or nullptr if the queue is empty.
+   */
+  T *Front() {
+    Node *next = mHead->next.load(std::memory_order_acquire);
+    return next ? &next->value : nullptr;
+  };
+
+  /**
+   * @brief Remove the front item. Consumer only.
+   * @pre the queue is not empty.
+   */
+  void PopFront() {
+    Node *next = mHead->next.load(std::memory_order_acquire);
+    delete mHead;
+    // next becomes the new dummy node, so release the memory its value holds.
+    next->value = T();
+    mHead = next;
+  };
+
+  /**
+   * @brief True if there is nothing to read. Consumer only.
+   */
+  bool Empty() const {
+    return mHead->next.load(std::memory_order_acquire) == nullptr;
+  };
+
+ private:
+  struct Node {
+    std::atomic<Node *> next{nullptr};
+    T value;
+  };
+
+  // head and tail are touched by different threads, so keep them on separate
+  // cache lines.
+  alignas(64) Node *mHead;
+  alignas(64) Node *mTail;
+};
+
+}  // namespace net
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_NET_SPSCQUEUE_H
@@ -49,3 +49,9 @@ int frn::lib::net::SystemInterface::accept(int sockfd, struct sockaddr* addr,
                                       socklen_t* addrlen) {
   return ::accept(sockfd, addr, addrlen);
 }
+
+int frn::lib::net::SystemInterface::connect(int sockfd,
+                                       const struct sockaddr* addr,
+                                       socklen_t addrlen) {
+  return ::connect(sockfd, addr, addrlen);
+}
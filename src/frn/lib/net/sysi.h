@@ -80,6 +80,12 @@ class SystemInterface {
    * @brief Man 2 accept.
    */
   virtual int accept(int sockfd, struct sockaddr *addr, socklen_t *addrlen);
+
+  /**
+   * @brief Man 2 connect.
+   */
+  virtual int connect(int sockfd, const struct sockaddr *addr,
+                      socklen_t addrlen);
 };
 
 }  // namespace net
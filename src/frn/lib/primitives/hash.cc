@@ -0,0 +1,86 @@
+#include "frn/lib/primitives/hash.h"
+
+#include "frn/lib/cpu.h"
+
+static const uint64_t keccakf_rndc[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+static const unsigned int keccakf_rotc[24] = {1,  3,  6,  10, 15, 21, 28, 36,
+                                              45, 55, 2,  14, 27, 41, 56, 8,
+                                              25, 43, 62, 18, 39, 61, 20, 44};
+
+static const unsigned int keccakf_piln[24] = {10, 7,  11, 17, 18, 3,  5,  16,
+                                              8,  21, 24, 4,  15, 23, 19, 13,
+                                              12, 2,  20, 14, 22, 9,  6,  1};
+
+static inline uint64_t rotl64(uint64_t x, uint64_t y) {
+  return (x << y) | (x >> ((sizeof(uint64_t) * 8) - y));
+}
+
+static inline __attribute__((always_inline)) void keccakf_body(
+    uint64_t state[25]) {
+  uint64_t t;
+  uint64_t bc[5];
+
+  for (std::size_t round = 0; round < 24; ++round) {
+    for (std::size_t i = 0; i < 5; ++i)
+      bc[i] = state[i] ^ state[i + 5] ^ state[i + 10] ^ state[i + 15] ^
+              state[i + 20];
+
+    for (std::size_t i = 0; i < 5; ++i) {
+      t = bc[(i + 4) % 5] ^ rotl64(bc[(i + 1) % 5], 1);
+      for (std::size_t j = 0; j < 25; j += 5) state[j + i] ^= t;
+    }
+
+    t = state[1];
+    for (std::size_t i = 0; i < 24; ++i) {
+      const uint64_t v = keccakf_piln[i];
+      bc[0] = state[v];
+      state[v] = rotl64(t, keccakf_rotc[i]);
+      t = bc[0];
+    }
+
+    for (std::size_t j = 0; j < 25; j += 5) {
+      for (std::size_t i = 0; i < 5; ++i) bc[i] = state[j + i];
+      for (std::size_t i = 0; i < 5; ++i)
+        state[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+    }
+
+    state[0] ^= keccakf_rndc[round];
+  }
+}
+
+// The permutation is plain 64-bit code. The variants let the compiler use
+// wider registers and newer instructions (e.g., rotates and ternary logic on
+// AVX-512) for the column parities and the chi step.
+
+static void keccakf_generic(uint64_t state[25]) { keccakf_body(state); }
+
+__attribute__((target("sse4.2"))) static void keccakf_sse42(
+    uint64_t state[25]) {
+  keccakf_body(state);
+}
+
+__attribute__((target("avx2,bmi2"))) static void keccakf_avx2(
+    uint64_t state[25]) {
+  keccakf_body(state);
+}
+
+__attribute__((target("avx512f,avx512vl,bmi2"))) static void keccakf_avx512(
+    uint64_t state[25]) {
+  keccakf_body(state);
+}
+
+void frn::lib::primitives::keccakf(uint64_t state[25]) {
+  using kernel = void (*)(uint64_t *);
+  frn::lib::cpu::Select<kernel>(frn::lib::cpu::Current(), keccakf_generic,
+                                keccakf_sse42, keccakf_avx2,
+                                keccakf_avx512)(state);
+}
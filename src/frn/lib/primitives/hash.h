@@ -102,59 +102,15 @@ class Hash {
   unsigned int mWordIndex = 0;
 };
 
-static const uint64_t keccakf_rndc[24] = {
-    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
-    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
-    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
-    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
-    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
-    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
-    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
-    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
-
-static const unsigned int keccakf_rotc[24] = {1,  3,  6,  10, 15, 21, 28, 36,
-                                              45, 55, 2,  14, 27, 41, 56, 8,
-                                              25, 43, 62, 18, 39, 61, 20, 44};
-
-static const unsigned int keccakf_piln[24] = {10, 7,  11, 17, 18, 3,  5,  16,
-                                              8,  21, 24, 4,  15, 23, 19, 13,
-                                              12, 2,  20, 14, 22, 9,  6,  1};
-
-static inline uint64_t rotl64(uint64_t x, uint64_t y) {
-  return (x << y) | (x >> ((sizeof(uint64_t) * 8) - y));
-}
-
-static inline void keccakf(uint64_t state[25]) {
-  uint64_t t;
-  uint64_t bc[5];
-
-  for (std::size_t round = 0; round < 24; ++round) {
-    for (std::size_t i = 0; i < 5; ++i)
-      bc[i] = state[i] ^ state[i + 5] ^ state[i + 10] ^ state[i + 15] ^
-              state[i + 20];
-
-    for (std::size_t i = 0; i < 5; ++i) {
-      t = bc[(i + 4) % 5] ^ rotl64(bc[(i + 1) % 5], 1);
-      for (std::size_t j = 0; j < 25; j += 5) state[j + i] ^= t;
-    }
-
-    t = state[1];
-    for (std::size_t i = 0; i < 24; ++i) {
-      const uint64_t v = keccakf_piln[i];
-      bc[0] = state[v];
-      state[v] = rotl64(t, keccakf_rotc[i]);
-      t = bc[0];
-    }
-
-    for (std::size_t j = 0; j < 25; j += 5) {
-      for (std::size_t i = 0; i < 5; ++i) bc[i] = state[j + i];
-      for (std::size_t i = 0; i < 5; ++i)
-        state[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
-    }
-
-    state[0] ^= keccakf_rndc[round];
-  }
-}
+/**
+ * @brief The Keccak-f[1600] permutation.
+ *
+ * Dispatched at runtime to a variant for the instruction set of the host (see
+ * frn::lib::cpu).
+ *
+ * @param state the state to permute in place.
+ */
+void keccakf(uint64_t state[25]);
 
 template <typename Tag>
 Hash<Tag> &Hash<Tag>::Update(const unsigned char *bytes, std::size_t nbytes) {
@@ -1,8 +1,11 @@
 #include "frn/lib/primitives/prg.h"
 
+#include <immintrin.h>
+
 #include <cstring>
 #include <stdexcept>
 
+#include "frn/lib/cpu.h"
 #include "frn/lib/tools.h"
 
 /* https://github.com/sebastien-riou/aes-brute-force */
@@ -13,25 +16,14 @@ using block_t = __m128i;
 using std::size_t;
 using std::vector;
 
-#define DO_ENC_BLOCK(m, k)              \
-  do {                                  \
-    m = _mm_xor_si128(m, k[0]);         \
-    m = _mm_aesenc_si128(m, k[1]);      \
-    m = _mm_aesenc_si128(m, k[2]);      \
-    m = _mm_aesenc_si128(m, k[3]);      \
-    m = _mm_aesenc_si128(m, k[4]);      \
-    m = _mm_aesenc_si128(m, k[5]);      \
-    m = _mm_aesenc_si128(m, k[6]);      \
-    m = _mm_aesenc_si128(m, k[7]);      \
-    m = _mm_aesenc_si128(m, k[8]);      \
-    m = _mm_aesenc_si128(m, k[9]);      \
-    m = _mm_aesenclast_si128(m, k[10]); \
-  } while (0)
+// Key expansion only runs when a PRG is seeded, so a single variant is enough.
+#define AES_TARGET __attribute__((target("sse4.2,aes")))
 
 #define AES_128_key_exp(k, rcon) \
   aes_128_key_expansion(k, _mm_aeskeygenassist_si128(k, rcon))
 
-inline static block_t aes_128_key_expansion(block_t key, block_t keygened) {
+AES_TARGET inline static block_t aes_128_key_expansion(block_t key,
+                                                       block_t keygened) {
   keygened = _mm_shuffle_epi32(keygened, _MM_SHUFFLE(3, 3, 3, 3));
   key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
   key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
@@ -39,7 +31,8 @@ inline static block_t aes_128_key_expansion(block_t key, block_t keygened) {
   return _mm_xor_si128(key, keygened);
 }
 
-inline static void aes128_load_key(byte_t* enc_key, block_t* key_schedule) {
+AES_TARGET static void aes128_load_key(byte_t* enc_key,
+                                       block_t* key_schedule) {
   key_schedule[0] = _mm_loadu_si128((const block_t*)enc_key);
   key_schedule[1] = AES_128_key_exp(key_schedule[0], 0x01);
   key_schedule[2] = AES_128_key_exp(key_schedule[1], 0x02);
@@ -53,10 +46,107 @@ inline static void aes128_load_key(byte_t* enc_key, block_t* key_schedule) {
   key_schedule[10] = AES_128_key_exp(key_schedule[9], 0x36);
 }
 
-inline static void aes128_enc(block_t* key_schedule, byte_t* pt, byte_t* ct) {
-  block_t m = _mm_loadu_si128((block_t*)pt);
-  DO_ENC_BLOCK(m, key_schedule);
-  _mm_storeu_si128((block_t*)ct, m);
+// Encrypts nblocks consecutive counters, starting at counter, into out. The
+// variants differ in how many blocks they encrypt with one instruction, but
+// produce the same output.
+using ctr_kernel = void (*)(const block_t* keys, long counter, byte_t* out,
+                            size_t nblocks);
+
+// Blocks encrypted in parallel to hide the latency of the AES instructions.
+#define CTR_LANES 8
+
+AES_TARGET static void ctr_aesni(const block_t* keys, long counter,
+                                 byte_t* out, size_t nblocks) {
+  size_t i = 0;
+  for (; i + CTR_LANES <= nblocks; i += CTR_LANES) {
+    block_t m[CTR_LANES];
+    for (int j = 0; j < CTR_LANES; j++)
+      m[j] = _mm_xor_si128(_mm_set_epi64x(PRG_NONCE, counter + i + j),
+                           keys[0]);
+    for (int r = 1; r < 10; r++)
+      for (int j = 0; j < CTR_LANES; j++) m[j] = _mm_aesenc_si128(m[j], keys[r]);
+    for (int j = 0; j < CTR_LANES; j++) {
+      m[j] = _mm_aesenclast_si128(m[j], keys[10]);
+      _mm_storeu_si128((block_t*)(out + (i + j) * sizeof(block_t)), m[j]);
+    }
+  }
+  for (; i < nblocks; i++) {
+    block_t m = _mm_xor_si128(_mm_set_epi64x(PRG_NONCE, counter + i), keys[0]);
+    for (int r = 1; r < 10; r++) m = _mm_aesenc_si128(m, keys[r]);
+    m = _mm_aesenclast_si128(m, keys[10]);
+    _mm_storeu_si128((block_t*)(out + i * sizeof(block_t)), m);
+  }
+}
+
+__attribute__((target("avx2,aes,vaes"))) static void ctr_vaes256(
+    const block_t* keys, long counter, byte_t* out, size_t nblocks) {
+  // CTR_LANES / 2 registers of two blocks each.
+  constexpr size_t kBlocks = CTR_LANES;
+  __m256i k[11];
+  for (int r = 0; r < 11; r++) k[r] = _mm256_broadcastsi128_si256(keys[r]);
+
+  size_t i = 0;
+  for (; i + kBlocks <= nblocks; i += kBlocks) {
+    __m256i m[CTR_LANES / 2];
+    for (int j = 0; j < CTR_LANES / 2; j++) {
+      long c = counter + i + 2 * j;
+      m[j] = _mm256_xor_si256(
+          _mm256_set_epi64x(PRG_NONCE, c + 1, PRG_NONCE, c), k[0]);
+    }
+    for (int r = 1; r < 10; r++)
+      for (int j = 0; j < CTR_LANES / 2; j++)
+        m[j] = _mm256_aesenc_epi128(m[j], k[r]);
+    for (int j = 0; j < CTR_LANES / 2; j++) {
+      m[j] = _mm256_aesenclast_epi128(m[j], k[10]);
+      _mm256_storeu_si256((__m256i*)(out + (i + 2 * j) * sizeof(block_t)),
+                          m[j]);
+    }
+  }
+  ctr_aesni(keys, counter + i, out + i * sizeof(block_t), nblocks - i);
+}
+
+__attribute__((target("avx512f,aes,vaes"))) static void ctr_vaes512(
+    const block_t* keys, long counter, byte_t* out, size_t nblocks) {
+  // CTR_LANES / 2 registers of four blocks each.
+  constexpr size_t kBlocks = 2 * CTR_LANES;
+  __m512i k[11];
+  // the masked broadcast avoids a spurious -Wuninitialized in GCC's headers.
+  for (int r = 0; r < 11; r++)
+    k[r] = _mm512_maskz_broadcast_i32x4(0xFFFF, keys[r]);
+
+  size_t i = 0;
+  for (; i + kBlocks <= nblocks; i += kBlocks) {
+    __m512i m[CTR_LANES / 2];
+    for (int j = 0; j < CTR_LANES / 2; j++) {
+      long c = counter + i + 4 * j;
+      m[j] = _mm512_xor_si512(
+          _mm512_set_epi64(PRG_NONCE, c + 3, PRG_NONCE, c + 2, PRG_NONCE,
+                           c + 1, PRG_NONCE, c),
+          k[0]);
+    }
+    for (int r = 1; r < 10; r++)
+      for (int j = 0; j < CTR_LANES / 2; j++)
+        m[j] = _mm512_aesenc_epi128(m[j], k[r]);
+    for (int j = 0; j < CTR_LANES / 2; j++) {
+      m[j] = _mm512_aesenclast_epi128(m[j], k[10]);
+      _mm512_storeu_si512((void*)(out + (i + 4 * j) * sizeof(block_t)), m[j]);
+    }
+  }
+  ctr_aesni(keys, counter + i, out + i * sizeof(block_t), nblocks - i);
+}
+
+static ctr_kernel select_ctr_kernel(frn::lib::cpu::Level level) {
+  // the VAES variants also need VAES, which is not implied by the level.
+  if (!frn::lib::cpu::HasVaes()) return ctr_aesni;
+  return frn::lib::cpu::Select<ctr_kernel>(level, ctr_aesni, ctr_aesni,
+                                           ctr_vaes256, ctr_vaes512);
+}
+
+static void check_aes_support() {
+  static const bool supported = frn::lib::cpu::HasAes();
+  // LCOV_EXCL_START
+  if (!supported) throw std::runtime_error("PRG requires AES-NI.");
+  // LCOV_EXCL_STOP
 }
 
 frn::lib::primitives::PRG::PRG() { Init(); }
@@ -68,39 +158,31 @@ frn::lib::primitives::PRG::PRG(const unsigned char* seed) {
 
 void frn::lib::primitives::PRG::Update() { mCounter += 1; }
 
-void frn::lib::primitives::PRG::Init() { aes128_load_key(mSeed, mState); }
+void frn::lib::primitives::PRG::Init() {
+  check_aes_support();
+  aes128_load_key(mSeed, mState);
+}
 
 void frn::lib::primitives::PRG::Reset() {
   Init();
   mCounter = PRG_INITIAL_COUNTER;
 }
 
-static inline auto create_mask(const long counter) {
-  return _mm_set_epi64x(PRG_NONCE, counter);
-}
-
 void frn::lib::primitives::PRG::Next(byte_t* dest, size_t nbytes) {
   if (!nbytes) return;
 
-  size_t nblocks = nbytes / BlockSize();
-
-  if (nbytes % BlockSize()) nblocks++;
-
-  block_t mask = create_mask(mCounter);
-  byte_t* out = (byte_t*)malloc(nblocks * BlockSize());
-  byte_t* p = out;
+  const auto kernel = select_ctr_kernel(frn::lib::cpu::Current());
 
-  // LCOV_EXCL_START
-  if (!out) throw std::runtime_error("Could not allocate memory for PRG.");
-  // LCOV_EXCL_STOP
+  // whole blocks go directly to dest, and a partial last block through a
+  // temporary.
+  size_t nblocks = nbytes / BlockSize();
+  kernel(mState, mCounter, dest, nblocks);
+  mCounter += nblocks;
 
-  for (size_t i = 0; i < nblocks; i++) {
-    aes128_enc(mState, (byte_t*)(&mask), p);
+  if (nbytes % BlockSize()) {
+    byte_t last[sizeof(BlockType)];
+    kernel(mState, mCounter, last, 1);
     Update();
-    mask = create_mask(mCounter);
-    p += BlockSize();
+    memcpy(dest + nblocks * BlockSize(), last, nbytes % BlockSize());
   }
-
-  memcpy(dest, out, nbytes);
-  free(out);
 }
@@ -3,7 +3,10 @@
 
 #include <wmmintrin.h>
 
+#include <algorithm>
+#include <array>
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 /**
@@ -23,6 +26,30 @@
 namespace frn::lib {
 namespace primitives {
 
+namespace details {
+
+/**
+ * @brief Whether T is a prime field, i.e., has a <code>Modulus()</code>.
+ */
+template <typename T, typename = void>
+struct HasModulus : std::false_type {};
+
+template <typename T>
+struct HasModulus<T, std::void_t<decltype(T::Modulus())>> : std::true_type {};
+
+/**
+ * @brief Whether T is a prime field or an extension of one.
+ */
+template <typename T, typename = void>
+struct OverPrimeField : HasModulus<T> {};
+
+template <typename T>
+struct OverPrimeField<T, std::void_t<typename T::BaseType>>
+    : std::bool_constant<HasModulus<T>::value ||
+                         HasModulus<typename T::BaseType>::value> {};
+
+}  // namespace details
+
 /**
  * @brief Pseudorandom generator.
  *
@@ -39,6 +66,12 @@ namespace primitives {
  *
  * where each half is 64 bits. The value of PRG_NONCE can be set by defining it
  * as a macro. It defaults to <code>0x0123456789ABCDEF</code>.
+ *
+ * Blocks are encrypted with AES-NI, or with VAES using 256 or 512 bit
+ * registers if the host supports it (see frn::lib::cpu). All variants produce
+ * the same output.
+ *
+ * @throws std::runtime_error on construction if the host lacks AES-NI.
  */
 class PRG {
  public:
@@ -80,9 +113,6 @@ class PRG {
    *
    * @pre <code>dest</code> must point to <code>nbytes</code> of allocated
    * space.
-   *
-   * @throws std::runtime_error if allocation of roughly <code>nbytes</code>
-   * bytes of memory fails.
    */
   void Next(unsigned char *dest, std::size_t nbytes);
 
@@ -91,9 +121,6 @@ class PRG {
    * <code>std::vector</code>.
    *
    * @param dest the destination vector.
-   *
-   * @throws std::runtime_error if allocation of roughly
-   * <code>dest.size()</code> bytes of memory fails.
    */
   void Next(std::vector<unsigned char> &dest) {
     Next(dest.data(), dest.size());
@@ -108,8 +135,6 @@ class PRG {
    *
    * @throws std::runtime_error if <code>dest</code> does not have sufficient
    * space.
-   * @throws std::runtime_error if allocation of roughly <code>nbytes</code>
-   * of memory fails.
    */
   void Next(std::vector<unsigned char> &dest, std::size_t nbytes) {
     if (dest.size() < nbytes)
@@ -117,6 +142,148 @@ class PRG {
     Next(dest.data(), nbytes);
   };
 
+  /**
+   * @brief Generate uniformly random field elements.
+   *
+   * Each element takes <code>sizeof(T)</code> bytes of output, so a block
+   * gives two elements of Mp61, rather than one as when calling Next per
+   * element. The bytes are masked to <code>T::PackedBitSize()</code> bits and
+   * values which are not less than <code>T::Modulus()</code> are rejected and
+   * drawn again, which for a Mersenne prime only happens to the all ones
+   * value. Unlike reducing the bytes modulo the prime, this gives uniform
+   * elements.
+   *
+   * @tparam T the field. Its elements must be stored as a single
+   * <code>T::ValueType</code>.
+   * @param dest the destination of the elements.
+   * @param n how many elements to generate.
+   *
+   * @pre <code>dest</code> must point to <code>n</code> elements of allocated
+   * space.
+   */
+  template <typename T>
+  void NextFields(T *dest, std::size_t n) {
+    using V = typename T::ValueType;
+    static_assert(sizeof(T) == sizeof(V), "T must be stored as a ValueType.");
+    constexpr auto kBits = T::PackedBitSize();
+    constexpr V kMask = kBits == 8 * sizeof(V) ? ~V(0) : (V(1) << kBits) - 1;
+    constexpr V kModulus = T::Modulus();
+
+    // the mask and the count of rejected values are computed without
+    // branches, so the compiler can vectorize them.
+    V *values = reinterpret_cast<V *>(dest);
+    Next(reinterpret_cast<unsigned char *>(values), n * sizeof(V));
+    std::size_t rejected = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      values[i] &= kMask;
+      rejected += values[i] >= kModulus;
+    }
+    for (std::size_t i = 0; rejected && i < n; i++) {
+      if (values[i] < kModulus) continue;
+      do {
+        Next(reinterpret_cast<unsigned char *>(values + i), sizeof(V));
+        values[i] &= kMask;
+      } while (values[i] >= kModulus);
+      rejected--;
+    }
+  }
+
+  /**
+   * @brief Generate uniformly random field elements and store them in a
+   * supplied <code>std::vector</code>.
+   *
+   * @param dest the destination vector.
+   */
+  template <typename T>
+  void NextFields(std::vector<T> &dest) {
+    NextFields(dest.data(), dest.size());
+  }
+
+  /**
+   * @brief Generate uniformly random elements of a ring in which every
+   * string of <code>T::ByteSize()</code> bytes encodes an element, and every
+   * element is encoded by the same number of strings.
+   *
+   * This holds for Z2kElement and GaloisRingElement, whose FromBytes keeps the
+   * low bits of each coefficient. Prime fields must use NextFields, and
+   * their extensions are rejected too, since reducing bytes modulo a prime is
+   * not uniform.
+   *
+   * @tparam T the ring.
+   * @param dest the destination of the elements.
+   * @param n how many elements to generate.
+   *
+   * @pre <code>dest</code> must point to <code>n</code> elements of allocated
+   * space.
+   */
+  template <typename T>
+  void NextElements(T *dest, std::size_t n) {
+    static_assert(!details::OverPrimeField<T>::value,
+                  "bytes do not map uniformly to elements of a prime field.");
+    std::vector<unsigned char> buffer(n * T::ByteSize());
+    Next(buffer);
+    for (std::size_t i = 0; i < n; i++)
+      dest[i] = T::FromBytes(buffer.data() + i * T::ByteSize());
+  }
+
+  /**
+   * @brief Generate uniformly random ring elements and store them in a
+   * supplied <code>std::vector</code>.
+   *
+   * @param dest the destination vector.
+   * @see NextElements(T *, std::size_t).
+   */
+  template <typename T>
+  void NextElements(std::vector<T> &dest) {
+    NextElements(dest.data(), dest.size());
+  }
+
+  /**
+   * @brief Generate uniformly random elements of a prime field, an
+   * extension of a prime field, or a ring accepted by NextElements.
+   *
+   * An extension is drawn as <code>T::Degree()</code> uniform coefficients
+   * from NextFields, so the protocols can sample shares and challenges
+   * without knowing which kind of ring they run over.
+   *
+   * @tparam T the ring.
+   * @param dest the destination of the elements.
+   * @param n how many elements to generate.
+   *
+   * @pre <code>dest</code> must point to <code>n</code> elements of allocated
+   * space.
+   */
+  template <typename T>
+  void NextUniform(T *dest, std::size_t n) {
+    if constexpr (details::HasModulus<T>::value) {
+      NextFields(dest, n);
+    } else if constexpr (details::OverPrimeField<T>::value) {
+      using B = typename T::BaseType;
+      constexpr auto kDegree = T::Degree();
+      std::vector<B> coefficients(n * kDegree);
+      NextFields(coefficients);
+      for (std::size_t i = 0; i < n; i++) {
+        std::array<B, kDegree> c;
+        std::copy_n(coefficients.begin() + i * kDegree, kDegree, c.begin());
+        dest[i] = T(c);
+      }
+    } else {
+      NextElements(dest, n);
+    }
+  }
+
+  /**
+   * @brief Generate uniformly random ring elements and store them in a
+   * supplied <code>std::vector</code>.
+   *
+   * @param dest the destination vector.
+   * @see NextUniform(T *, std::size_t).
+   */
+  template <typename T>
+  void NextUniform(std::vector<T> &dest) {
+    NextUniform(dest.data(), dest.size());
+  }
+
   /**
    * @brief The seed of the PRG.
    */
@@ -224,7 +224,9 @@ class Replicator {
    * @param idx the index to query
    * @return (sorted) combination corresponding to this index
    */
-  std::vector<int> Combination(std::size_t idx) const { return mCombinations[idx]; };
+  const std::vector<int> &Combination(std::size_t idx) const {
+    return mCombinations[idx];
+  };
 
   /**
    * @brief Returns the index corresponding to the given combination
@@ -245,7 +247,7 @@ class Replicator {
    * @param id the replicated share index.
    * @return the index set for a replicated share.
    */
-  IndexSet IndexSetFor(std::size_t id) const { return mLookup[id]; };
+  const IndexSet &IndexSetFor(std::size_t id) const { return mLookup[id]; };
 
   /**
    * @brief Number of elements which differ between two shares.
@@ -347,7 +349,7 @@ class Replicator {
    */
   ValueType Reconstruct(const std::vector<ShareType> &shares) const {
     std::vector<std::vector<ValueType>> redundant = ComputeRedundantAddShares(shares);
-    ValueType secret(0);
+    ValueType secret;
     std::vector<ValueType> additive_shares;
     additive_shares.reserve(mAdditiveShareSize);
 
@@ -366,7 +368,7 @@ class Replicator {
    */
   ValueType ErrorDetection(const std::vector<ShareType> &shares) const {
     std::vector<std::vector<ValueType>> redundant = ComputeRedundantAddShares(shares);
-    ValueType secret(0);
+    ValueType secret;
     std::vector<ValueType> additive_shares;
     additive_shares.reserve(mAdditiveShareSize);
 
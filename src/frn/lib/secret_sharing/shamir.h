@@ -0,0 +1,175 @@
+#ifndef _FRN_LIB_SECRET_SHARING_SHAMIR_H
+#define _FRN_LIB_SECRET_SHARING_SHAMIR_H
+
+#include <stdexcept>
+#include <vector>
+
+#include "frn/lib/math/vec.h"
+#include "frn/lib/primitives/prg.h"
+
+namespace frn::lib {
+namespace secret_sharing {
+
+/**
+ * @brief Lagrange coefficients for interpolating a polynomial at a point.
+ *
+ * Given distinct points \f$x_0, \dots, x_k\f$, returns \f$\ell_j(x)\f$ for each
+ * \f$j\f$, such that \f$f(x) = \sum_j \ell_j(x) f(x_j)\f$ for every polynomial
+ * \f$f\f$ of degree at most \f$k\f$.
+ *
+ * @tparam T the type of the field.
+ * @param points the interpolation points.
+ * @param x the point to interpolate at.
+ * @return the coefficients.
+ */
+template <typename T>
+std::vector<T> LagrangeCoefficients(const std::vector<T> &points, const T &x) {
+  std::vector<T> nums, dens;
+  nums.reserve(points.size());
+  dens.reserve(points.size());
+  for (std::size_t j = 0; j < points.size(); ++j) {
+    T num = T::kOne;
+    T den = T::kOne;
+    for (std::size_t k = 0; k < points.size(); ++k) {
+      if (k == j) continue;
+      num *= x - points[k];
+      den *= points[j] - points[k];
+    }
+    nums.emplace_back(num);
+    dens.emplace_back(den);
+  }
+  return math::vector::MultiplyInto(math::vector::BatchInvertInto(dens), nums);
+}
+
+/**
+ * @brief A factory for working with Shamir shares.
+ *
+ * The share of party \f$i\f$ is \f$f(i + 1)\f$ for a random polynomial \f$f\f$
+ * of degree t with \f$f(0)\f$ the secret. A share is a single element
+ * regardless of the number of parties.
+ *
+ * @tparam T the type of the field over which shares are defined.
+ */
+template <typename T>
+class Shamir {
+ public:
+  //! Type of a Shamir share.
+  using ShareType = T;
+
+  /**
+   * @brief Create a new Shamir factory.
+   * @param n the number of shares that can be created
+   * @param t the degree of the sharing polynomial
+   */
+  Shamir(std::size_t n, std::size_t t) : mSize(n), mThreshold(t) {
+    if (mSize <= mThreshold)
+      throw std::invalid_argument("privacy threshold cannot be larger than n");
+    Init();
+  };
+
+  /**
+   * @brief Returns the number of shares this factory can create.
+   */
+  std::size_t Size() const { return mSize; };
+
+  /**
+   * @brief Returns the degree of sharings.
+   */
+  std::size_t Threshold() const { return mThreshold; };
+
+  /**
+   * @brief The evaluation point of a party.
+   * @param id the ID of the party
+   * @return the point at which the share of the party is evaluated.
+   */
+  static T Point(std::size_t id) { return T(id + 1); };
+
+  /**
+   * @brief Create a Shamir sharing of a secret.
+   * @param secret the secret to share
+   * @param prg where to get random coefficients from
+   * @return a list of shares.
+   */
+  std::vector<ShareType> Share(const T &secret, primitives::PRG &prg) const {
+    std::vector<unsigned char> buf(T::ByteSize() * mThreshold);
+    prg.Next(buf);
+    std::vector<ShareType> shares;
+    shares.reserve(mSize);
+    for (std::size_t i = 0; i < mSize; ++i) {
+      // Horner's rule, starting from the highest coefficient.
+      const auto x = Point(i);
+      T y = T::kZero;
+      for (std::size_t k = mThreshold; k > 0; --k)
+        y = y * x + T::FromBytes(buf.data() + (k - 1) * T::ByteSize());
+      shares.emplace_back(y * x + secret);
+    }
+    return shares;
+  };
+
+  /**
+   * @brief Reconstructs a secret from the first t + 1 shares, assuming shares
+   * are consistent.
+   *
+   * @param shares at least t + 1 shares, ordered by party
+   * @return secret
+   */
+  T Reconstruct(const std::vector<ShareType> &shares) const {
+    T secret = T::kZero;
+    for (std::size_t j = 0; j <= mThreshold; ++j)
+      secret += mReconstruction[j] * shares[j];
+    return secret;
+  };
+
+  /**
+   * @brief Reconstructs a secret from all n shares, aborting if they do not
+   * lie on a polynomial of degree t. Requires t < n/2.
+   *
+   * @param shares the shares of all parties
+   * @return secret
+   */
+  T ErrorDetection(const std::vector<ShareType> &shares) const {
+    for (std::size_t i = mThreshold + 1; i < mSize; ++i) {
+      T expected = T::kZero;
+      for (std::size_t j = 0; j <= mThreshold; ++j)
+        expected += mConsistency[i - mThreshold - 1][j] * shares[j];
+      if (expected != shares[i])
+        throw std::runtime_error("Inconsistent shares");
+    }
+    return Reconstruct(shares);
+  };
+
+ private:
+  void Init() {
+    std::vector<T> points;
+    for (std::size_t j = 0; j <= mThreshold; ++j) points.emplace_back(Point(j));
+    mReconstruction = LagrangeCoefficients(points, T::kZero);
+    for (std::size_t i = mThreshold + 1; i < mSize; ++i)
+      mConsistency.emplace_back(LagrangeCoefficients(points, Point(i)));
+  };
+
+  /**
+   * @brief Number of shares.
+   */
+  std::size_t mSize;
+
+  /**
+   * @brief Degree of the sharing polynomial.
+   */
+  std::size_t mThreshold;
+
+  /**
+   * @brief Coefficients of the first t + 1 shares for interpolating at 0.
+   */
+  std::vector<T> mReconstruction;
+
+  /**
+   * @brief Coefficients of the first t + 1 shares for interpolating the share
+   * of each party after them.
+   */
+  std::vector<std::vector<T>> mConsistency;
+};
+
+}  // namespace secret_sharing
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_SECRET_SHARING_SHAMIR_H
@@ -13,6 +13,16 @@ namespace utils {
 using std::string;
 using std::stringstream;
 
+/**
+ * @brief Specialization of to_string for unsigned 32-bit ints.
+ */
+template <>
+string to_string(const std::uint32_t& v) {
+  stringstream ss;
+  ss << v;
+  return ss.str();
+}
+
 /**
  * @brief Specialization of to_string for unsinged 64-bit ints.
  */
@@ -0,0 +1,35 @@
+#ifndef _FRN_LIB_TRACING_H
+#define _FRN_LIB_TRACING_H
+
+#include "frn/lib/tracing/clock.h"
+#include "frn/lib/tracing/export.h"
+#include "frn/lib/tracing/tracer.h"
+
+// frn::lib
+namespace frn::lib {
+
+/**
+ * @brief Tracing.
+ *
+ * Code is instrumented with spans, which time the rest of the enclosing scope,
+ * and counters, which are attached to the innermost open span:
+ *
+ * <code>
+ *  void Mult::SendStep() { <br>
+ *    TRACE_SPAN("Mult::SendStep"); <br>
+ *    TRACE_COUNT(eBytesSent, n); <br>
+ *    ... <br>
+ *  }
+ * </code>
+ *
+ * Spans are recorded into per-thread buffers with cycle counter timestamps,
+ * so tracing is cheap enough to leave on in hot code. Recorded spans can be
+ * obtained with Collect, or written to Chrome trace JSON and CSV files with
+ * Export. Defining <code>FRN_DISABLE_TRACING</code> compiles all
+ * instrumentation out.
+ */
+namespace tracing {}  // namespace tracing
+
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_TRACING_H
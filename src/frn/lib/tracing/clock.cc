@@ -0,0 +1,39 @@
+#include "frn/lib/tracing/clock.h"
+
+#include <thread>
+
+using SteadyClock = std::chrono::steady_clock;
+
+namespace {
+
+struct Origin {
+  SteadyClock::time_point time;
+  std::uint64_t ticks;
+};
+
+const Origin& GetOrigin() {
+  static const Origin origin{SteadyClock::now(), frn::lib::tracing::Ticks()};
+  return origin;
+}
+
+// take the reference point at startup, so that calibration rarely has to
+// wait.
+[[maybe_unused]] const Origin& gOrigin = GetOrigin();
+
+}  // namespace
+
+double frn::lib::tracing::TicksPerMicrosecond() {
+  using namespace std::chrono_literals;
+
+  static const double ratio = []() {
+    const auto& origin = GetOrigin();
+    auto elapsed = SteadyClock::now() - origin.time;
+    if (elapsed < 10ms) std::this_thread::sleep_for(10ms - elapsed);
+    auto ticks = Ticks();
+    auto us = std::chrono::duration<double, std::micro>(SteadyClock::now() -
+                                                        origin.time);
+    return (ticks - origin.ticks) / us.count();
+  }();
+
+  return ratio;
+}
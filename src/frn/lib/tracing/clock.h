@@ -0,0 +1,49 @@
+#ifndef _FRN_LIB_TRACING_CLOCK_H
+#define _FRN_LIB_TRACING_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace frn::lib {
+namespace tracing {
+
+/**
+ * @brief Read the cycle counter.
+ *
+ * Uses <code>rdtsc</code> where available and falls back to a steady clock
+ * in nanoseconds elsewhere. Ticks are converted to time with
+ * TicksToMicroseconds.
+ */
+inline std::uint64_t Ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+/**
+ * @brief The number of ticks per microsecond.
+ *
+ * Measured against a steady clock the first time it is needed after some
+ * time has passed since startup, and cached afterwards.
+ */
+double TicksPerMicrosecond();
+
+/**
+ * @brief Convert a tick count into microseconds.
+ */
+inline double TicksToMicroseconds(std::uint64_t ticks) {
+  return ticks / TicksPerMicrosecond();
+}
+
+}  // namespace tracing
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_TRACING_CLOCK_H
@@ -0,0 +1,85 @@
+#include "frn/lib/tracing/export.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+using Counter = frn::lib::tracing::Counter;
+using Record = frn::lib::tracing::Record;
+
+static inline std::uint64_t first_begin(const std::vector<Record>& records) {
+  std::uint64_t first = records.empty() ? 0 : records[0].begin;
+  for (const auto& r : records) first = std::min(first, r.begin);
+  return first;
+}
+
+static inline void write_json_string(std::ostream& os, const char* str) {
+  os << '"';
+  for (; *str; ++str) {
+    if (*str == '"' || *str == '\\') os << '\\';
+    os << *str;
+  }
+  os << '"';
+}
+
+void frn::lib::tracing::WriteChromeTrace(std::ostream& os,
+                                         const std::vector<Record>& records,
+                                         int pid) {
+  const auto origin = first_begin(records);
+  os << std::fixed << std::setprecision(3);
+  os << "{\"traceEvents\":[";
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    const auto& r = records[i];
+    if (i) os << ",";
+    os << "\n{\"name\":";
+    write_json_string(os, r.name);
+    os << ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << r.thread
+       << ",\"ts\":" << TicksToMicroseconds(r.begin - origin)
+       << ",\"dur\":" << TicksToMicroseconds(r.end - r.begin) << ",\"args\":{";
+    for (std::size_t c = 0; c < (std::size_t)Counter::eCount; ++c) {
+      if (c) os << ",";
+      os << "\"" << CounterName((Counter)c) << "\":" << r.counters[c];
+    }
+    os << "}}";
+  }
+  os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+void frn::lib::tracing::WriteCsv(std::ostream& os,
+                                 const std::vector<Record>& records) {
+  const auto origin = first_begin(records);
+  os << "thread,depth,name,start_us,duration_us";
+  for (std::size_t c = 0; c < (std::size_t)Counter::eCount; ++c)
+    os << "," << CounterName((Counter)c);
+  os << "\n";
+
+  os << std::fixed << std::setprecision(3);
+  for (const auto& r : records) {
+    os << r.thread << "," << r.depth << "," << r.name << ","
+       << TicksToMicroseconds(r.begin - origin) << ","
+       << TicksToMicroseconds(r.end - r.begin);
+    for (auto v : r.counters) os << "," << v;
+    os << "\n";
+  }
+}
+
+void frn::lib::tracing::Export(const std::string& prefix, int pid) {
+  auto records = Collect();
+
+  std::ofstream json(prefix + ".json");
+  if (!json.is_open()) throw std::runtime_error("could not open trace file");
+  WriteChromeTrace(json, records, pid);
+
+  std::ofstream csv(prefix + ".csv");
+  if (!csv.is_open()) throw std::runtime_error("could not open trace file");
+  WriteCsv(csv, records);
+}
+
+bool frn::lib::tracing::ExportFromEnvironment(const std::string& suffix,
+                                              int pid) {
+  const char* prefix = std::getenv(TRACE_ENV_VARIABLE);
+  if (!prefix || !*prefix) return false;
+  Export(prefix + suffix, pid);
+  return true;
+}
@@ -0,0 +1,70 @@
+#ifndef _FRN_LIB_TRACING_EXPORT_H
+#define _FRN_LIB_TRACING_EXPORT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "frn/lib/tracing/tracer.h"
+
+/**
+ * @brief Environment variable holding the path prefix used by
+ * ExportFromEnvironment.
+ */
+#ifndef TRACE_ENV_VARIABLE
+#define TRACE_ENV_VARIABLE "FRN_TRACE"
+#endif
+
+namespace frn::lib {
+namespace tracing {
+
+/**
+ * @brief Write spans in the Chrome trace event format.
+ *
+ * The output can be loaded in <code>chrome://tracing</code> or Perfetto.
+ * Timestamps are in microseconds relative to the first span, and counters are
+ * attached to each span as arguments.
+ *
+ * @param os where to write the trace
+ * @param records the spans, e.g., as returned by Collect
+ * @param pid process ID to put in the trace, e.g., the ID of the party
+ */
+void WriteChromeTrace(std::ostream &os, const std::vector<Record> &records,
+                      int pid = 0);
+
+/**
+ * @brief Write spans as CSV with one line per span.
+ *
+ * Columns are <code>thread,depth,name,start_us,duration_us</code> followed by
+ * one column per counter.
+ *
+ * @param os where to write the spans
+ * @param records the spans, e.g., as returned by Collect
+ */
+void WriteCsv(std::ostream &os, const std::vector<Record> &records);
+
+/**
+ * @brief Write all spans recorded so far to <code>prefix.json</code> and
+ * <code>prefix.csv</code>.
+ * @param prefix path prefix of the output files
+ * @param pid process ID to put in the Chrome trace
+ * @throws std::runtime_error if a file could not be opened.
+ */
+void Export(const std::string &prefix, int pid = 0);
+
+/**
+ * @brief Export spans if the TRACE_ENV_VARIABLE environment variable is set.
+ *
+ * The value of the variable is used as path prefix, followed by
+ * <code>suffix</code>.
+ *
+ * @param suffix appended to the prefix, e.g., to tell parties apart
+ * @param pid process ID to put in the Chrome trace
+ * @return true if spans were exported.
+ */
+bool ExportFromEnvironment(const std::string &suffix, int pid = 0);
+
+}  // namespace tracing
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_TRACING_EXPORT_H
@@ -0,0 +1,188 @@
+#include "frn/lib/tracing/tracer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+using Counter = frn::lib::tracing::Counter;
+using Record = frn::lib::tracing::Record;
+
+namespace {
+
+constexpr std::size_t kChunkSize = 1024;
+
+// Spans nested deeper than this are not recorded, but still counted towards
+// their ancestors.
+constexpr std::size_t kMaxDepth = 64;
+
+struct Chunk {
+  Record records[kChunkSize];
+  std::atomic<Chunk*> next{nullptr};
+};
+
+// Append-only list of records which is written by a single thread and can be
+// read concurrently by others.
+class ThreadBuffer {
+ public:
+  ThreadBuffer() = default;
+  ThreadBuffer(const ThreadBuffer&) = delete;
+  ThreadBuffer& operator=(const ThreadBuffer&) = delete;
+
+  ~ThreadBuffer() {
+    auto chunk = mHead.load(std::memory_order_acquire);
+    while (chunk) {
+      auto next = chunk->next.load(std::memory_order_acquire);
+      delete chunk;
+      chunk = next;
+    }
+  }
+
+  // Only called by the owning thread.
+  void Append(const Record& record) {
+    if (!mTail || mTailSize == kChunkSize) {
+      auto chunk = new Chunk;
+      if (mTail)
+        mTail->next.store(chunk, std::memory_order_release);
+      else
+        mHead.store(chunk, std::memory_order_release);
+      mTail = chunk;
+      mTailSize = 0;
+    }
+    mTail->records[mTailSize++] = record;
+    // publish the record.
+    mSize.store(mSize.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  void CopyTo(std::vector<Record>& out) const {
+    auto n = mSize.load(std::memory_order_acquire);
+    auto chunk = mHead.load(std::memory_order_acquire);
+    while (n > 0 && chunk) {
+      auto m = std::min(n, kChunkSize);
+      out.insert(out.end(), chunk->records, chunk->records + m);
+      n -= m;
+      chunk = chunk->next.load(std::memory_order_acquire);
+    }
+  }
+
+ private:
+  std::atomic<Chunk*> mHead{nullptr};
+  Chunk* mTail = nullptr;
+  std::size_t mTailSize = 0;
+  std::atomic<std::size_t> mSize{0};
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  // bumped by Reset, which makes threads start on a new buffer.
+  std::atomic<std::uint64_t> epoch{1};
+  std::atomic<std::uint32_t> next_thread{0};
+};
+
+Registry& GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+struct Frame {
+  const char* name;
+  std::uint64_t begin;
+  std::array<std::uint64_t, (std::size_t)Counter::eCount> counters;
+};
+
+struct ThreadState {
+  std::shared_ptr<ThreadBuffer> buffer;
+  std::uint64_t epoch = 0;
+  std::uint32_t thread = GetRegistry().next_thread.fetch_add(1);
+  std::uint32_t depth = 0;
+  Frame frames[kMaxDepth];
+};
+
+thread_local ThreadState tState;
+
+ThreadBuffer& GetBuffer(ThreadState& state) {
+  auto& registry = GetRegistry();
+  auto epoch = registry.epoch.load(std::memory_order_acquire);
+  if (state.epoch != epoch) {
+    state.buffer = std::make_shared<ThreadBuffer>();
+    state.epoch = epoch;
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.buffers.emplace_back(state.buffer);
+  }
+  return *state.buffer;
+}
+
+}  // namespace
+
+const char* frn::lib::tracing::CounterName(Counter counter) {
+  switch (counter) {
+    case Counter::eBytesSent:
+      return "bytes_sent";
+    case Counter::eBytesReceived:
+      return "bytes_received";
+    case Counter::eElements:
+      return "elements";
+    case Counter::eRounds:
+      return "rounds";
+    default:
+      return "???";
+  }
+}
+
+frn::lib::tracing::Span::Span(const char* name) {
+  auto& state = tState;
+  if (state.depth < kMaxDepth) {
+    auto& frame = state.frames[state.depth];
+    frame.name = name;
+    frame.counters.fill(0);
+    frame.begin = Ticks();
+  }
+  state.depth++;
+}
+
+frn::lib::tracing::Span::~Span() {
+  auto end = Ticks();
+  auto& state = tState;
+  state.depth--;
+  if (state.depth >= kMaxDepth) return;
+
+  const auto& frame = state.frames[state.depth];
+  GetBuffer(state).Append(
+      {frame.name, state.thread, state.depth, frame.begin, end, frame.counters});
+
+  if (state.depth > 0) {
+    auto& parent = state.frames[state.depth - 1];
+    for (std::size_t i = 0; i < frame.counters.size(); ++i)
+      parent.counters[i] += frame.counters[i];
+  }
+}
+
+void frn::lib::tracing::Count(Counter counter, std::uint64_t n) {
+  auto& state = tState;
+  if (!state.depth) return;
+  auto top = std::min<std::size_t>(state.depth, kMaxDepth) - 1;
+  state.frames[top].counters[(std::size_t)counter] += n;
+}
+
+std::vector<Record> frn::lib::tracing::Collect() {
+  auto& registry = GetRegistry();
+  std::vector<Record> records;
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& buffer : registry.buffers) buffer->CopyTo(records);
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const Record& a, const Record& b) {
+                     return a.begin < b.begin;
+                   });
+  return records;
+}
+
+void frn::lib::tracing::Reset() {
+  auto& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.buffers.clear();
+  registry.epoch.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,131 @@
+#ifndef _FRN_LIB_TRACING_TRACER_H
+#define _FRN_LIB_TRACING_TRACER_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "frn/lib/tracing/clock.h"
+
+#ifndef FRN_DISABLE_TRACING
+#define FRN_TRACE_CONCAT_(a, b) a##b
+#define FRN_TRACE_CONCAT(a, b) FRN_TRACE_CONCAT_(a, b)
+//! Trace the rest of the enclosing scope as a span called name.
+#define TRACE_SPAN(name) \
+  frn::lib::tracing::Span FRN_TRACE_CONCAT(__trace_span_, __LINE__)(name)
+//! Add n to a counter of the innermost open span.
+#define TRACE_COUNT(counter, n) \
+  frn::lib::tracing::Count(frn::lib::tracing::Counter::counter, (n))
+#else
+#define TRACE_SPAN(name)
+#define TRACE_COUNT(counter, n)
+#endif
+
+namespace frn::lib {
+namespace tracing {
+
+/**
+ * @brief Quantities which can be counted per span.
+ */
+enum class Counter {
+  //! Bytes sent to other parties.
+  eBytesSent,
+  //! Bytes received from other parties.
+  eBytesReceived,
+  //! Number of elements (e.g., multiplications or inputs) processed.
+  eElements,
+  //! Number of communication rounds.
+  eRounds,
+  //! Dummy. The number of counters.
+  eCount
+};
+
+/**
+ * @brief Name of a counter, as used in exported traces.
+ */
+const char *CounterName(Counter counter);
+
+/**
+ * @brief A finished span.
+ */
+struct Record {
+  //! Name of the span. Points to a string literal.
+  const char *name;
+  //! Identifier of the thread which recorded the span.
+  std::uint32_t thread;
+  //! Number of spans which were open when this span started.
+  std::uint32_t depth;
+  //! Tick count at the start of the span.
+  std::uint64_t begin;
+  //! Tick count at the end of the span.
+  std::uint64_t end;
+  //! Counters, including those of nested spans.
+  std::array<std::uint64_t, (std::size_t)Counter::eCount> counters;
+
+  /**
+   * @brief Read a counter.
+   */
+  std::uint64_t Get(Counter counter) const {
+    return counters[(std::size_t)counter];
+  };
+};
+
+/**
+ * @brief Scoped span.
+ *
+ * A span starts when constructed and ends when destroyed. Spans opened on the
+ * same thread while another span is open are nested inside it, and their
+ * counters are added to the enclosing span when they end.
+ *
+ * Finished spans are appended to a buffer owned by the current thread, so
+ * recording a span takes two reads of the cycle counter and involves no
+ * locks. Use the TRACE_SPAN macro rather than this class directly, so that
+ * tracing can be compiled out by defining FRN_DISABLE_TRACING.
+ */
+class Span {
+ public:
+  /**
+   * @brief Open a span.
+   * @param name the name of the span. Must outlive the tracer, e.g., a string
+   * literal.
+   */
+  explicit Span(const char *name);
+
+  Span(const Span &) = delete;
+  Span &operator=(const Span &) = delete;
+
+  /**
+   * @brief Close the span.
+   */
+  ~Span();
+};
+
+/**
+ * @brief Add to a counter of the innermost open span on this thread.
+ *
+ * Does nothing if no span is open.
+ *
+ * @param counter the counter
+ * @param n the amount to add
+ */
+void Count(Counter counter, std::uint64_t n);
+
+/**
+ * @brief Get all spans recorded so far by all threads, ordered by start time.
+ *
+ * Spans that are recorded while Collect runs may or may not be included.
+ */
+std::vector<Record> Collect();
+
+/**
+ * @brief Forget all spans recorded so far.
+ *
+ * Threads must not have any spans open when Reset is called.
+ */
+void Reset();
+
+}  // namespace tracing
+}  // namespace frn::lib
+
+#endif  // _FRN_LIB_TRACING_TRACER_H
@@ -2,40 +2,73 @@
 #define MULT_H
 
 #include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 #include "frn/corr.h"
+#include "frn/fixed.h"
 #include "frn/network.h"
 #include "frn/shr.h"
 
 namespace frn {
 
-struct AddAndMsgs {
-  Field add_share;
-  std::vector<Shr> msgs;
+template <typename T>
+struct BasicAddAndMsgs {
+  T add_share;
+  std::vector<std::vector<T>> msgs;
 };
 
-struct CheckData {
+using AddAndMsgs = BasicAddAndMsgs<Field>;
+
+// An inner product prepared with Mult::PrepareDotProduct is a single entry,
+// like one multiplication.
+template <typename T>
+struct BasicCheckData {
   // The shares the given party sent to P1 across the
   // multiplications
-  std::vector<Field> shares_sent_to_p1;
+  std::vector<T> shares_sent_to_p1;
   // For each party, the shares P1 received across all
   // multiplications
-  std::vector<std::vector<Field>> shares_recv_by_p1;
+  std::vector<std::vector<T>> shares_recv_by_p1;
   // Reconstructions received from P1
-  std::vector<Field> values_recv_from_p1;
+  std::vector<T> values_recv_from_p1;
   // For each mult and for each party in U, rep share of msg^i
-  std::vector<std::vector<Shr>> msgs;
+  std::vector<std::vector<std::vector<T>>> msgs;
+  // Messages of the entries of a matrix product, which are left empty in
+  // msgs. Share i of a batch holds the messages of mult offset + i, laid out
+  // as by ShrManipulator::MultiplyToMsgs.
+  struct MsgBatch {
+    std::size_t offset;
+    BasicShareBatch<T> msgs;
+  };
+  std::vector<MsgBatch> msg_batches;
   // Counter
   std::size_t counter = 0;
 
-  CheckData(unsigned threshold) { shares_recv_by_p1.resize(2 * threshold + 1); }
+  BasicCheckData(unsigned threshold) {
+    shares_recv_by_p1.resize(2 * threshold + 1);
+  }
 };
 
+using CheckData = BasicCheckData<Field>;
+
 /**
  * @brief The inteface of the Mult protocol.
+ *
+ * @tparam T the ring of the shares. Over Field, multiplications use the
+ * generated kernel of the configuration when there is one.
  */
-class Mult {
+template <typename T>
+class BasicMult {
  public:
+  //! Type of a replicated share.
+  using ShareType = std::vector<T>;
+  using BatchType = BasicShareBatch<T>;
+  using RandomShare = BasicRandomShare<T>;
+  using AddAndMsgs = BasicAddAndMsgs<T>;
+  using CheckData = BasicCheckData<T>;
+
   /**
    * @brief Create a new mult protocol instance.
    * @param network: an object for talking with other parties
@@ -43,10 +76,10 @@ class Mult {
    * @param manipulator: a manipulator to compute on shares
    * @param correlator: object for obtaining correlated data
    */
-  Mult(std::shared_ptr<Network> network,
-       const frn::lib::secret_sharing::Replicator<Field>& replicator,
-       const ShrManipulator& manipulator, const Correlator& correlator,
-       CheckData& cd)
+  BasicMult(std::shared_ptr<Network> network,
+            const frn::lib::secret_sharing::Replicator<T>& replicator,
+            const BasicShrManipulator<T>& manipulator,
+            const BasicCorrelator<T>& correlator, CheckData& cd)
       : mNetwork(network),
         mReplicator(replicator),
         mId(network->Id()),
@@ -57,7 +90,8 @@ class Mult {
         mManipulator(manipulator),
         mCorrelator(correlator),
         mCount(0),
-        mCheckData(&cd) {
+        mCheckData(&cd),
+        mFixedKernel(FindKernel(mSize, mThreshold, mId)) {
     mSharesRecvByP1.resize(2 * mThreshold + 1);
     // TODO Provide a default size for internal containers.
   };
@@ -67,32 +101,128 @@ class Mult {
    * @param ShareX replicated share of first factor
    * @param ShareX replicated share of second factor
    */
-  void Prepare(const Shr shares_x, const Shr shares_y) {
+  void Prepare(const ShareType shares_x, const ShareType shares_y) {
     RandomShare randomShares = mCorrelator.GenRandomShare();
-    mRandomShares.emplace_back(randomShares);
-    AddAndMsgs output = MultiplyToAddAndMsgs(shares_x, shares_y, randomShares);
+    Append(randomShares,
+           MultiplyToAddAndMsgs(shares_x, shares_y, randomShares));
+  };
 
-    mSharesToSendP1.emplace_back(output.add_share);
+  void Prepare(const std::vector<ShareType>& xs,
+               const std::vector<ShareType>& ys) {
+    TRACE_SPAN("Mult::Prepare");
+    TRACE_COUNT(eElements, xs.size());
+    // assumes xs and ys have the same size.
+    auto randoms = mCorrelator.GenRandomShares(xs.size());
+    if (mFixedKernel || xs.size() < 2) {
+      for (std::size_t i = 0; i < xs.size(); i++)
+        Append(randoms[i], MultiplyToAddAndMsgs(xs[i], ys[i], randoms[i]));
+      return;
+    }
 
-    // Append check data
-    mCheckData->shares_sent_to_p1.emplace_back(output.add_share);
-    mCheckData->msgs.emplace_back(output.msgs);
+    // without a kernel for this configuration, the messages of all the
+    // multiplications are computed at once by the batched table.
+    const auto size = mManipulator.ShareSize();
+    AppendBatch(randoms, mManipulator.MultiplyToMsgs(BatchType(size, xs),
+                                                     BatchType(size, ys)));
+  };
 
-    ++mCount;
+  /**
+   * @brief Indicates that we wish to square a list of shared values.
+   *
+   * Equivalent to <code>Prepare(xs, xs)</code>, but the local products are
+   * computed with the symmetric table of ShrManipulator::SquareToMsgs, which
+   * evaluates about half as many products.
+   *
+   * @param xs replicated shares of the values to square
+   */
+  void PrepareSquares(const std::vector<ShareType>& xs) {
+    TRACE_SPAN("Mult::PrepareSquares");
+    TRACE_COUNT(eElements, xs.size());
+    auto randoms = mCorrelator.GenRandomShares(xs.size());
+    AppendBatch(randoms, mManipulator.SquareToMsgs(
+                             BatchType(mManipulator.ShareSize(), xs)));
   };
 
-  void Prepare(const std::vector<Shr>& xs, const std::vector<Shr>& ys) {
-    START_TIMER(prepare);
-    // assumes xs and ys have the same size.
-    for (std::size_t i = 0; i < xs.size(); i++) Prepare(xs[i], ys[i]);
-    STOP_TIMER(prepare);
+  /**
+   * @brief Indicates that we wish to compute the inner product of two vectors
+   * of shared values.
+   *
+   * The products are summed before they are masked, so the inner product is
+   * reconstructed, and checked, as a single multiplication regardless of the
+   * length of the vectors. Run returns one share for it.
+   *
+   * @param xs replicated shares of the first vector
+   * @param ys replicated shares of the second vector
+   * @throws std::invalid_argument if the vectors differ in length.
+   */
+  void PrepareDotProduct(const std::vector<ShareType>& xs,
+                         const std::vector<ShareType>& ys) {
+    TRACE_SPAN("Mult::PrepareDotProduct");
+    TRACE_COUNT(eElements, xs.size());
+    if (xs.size() != ys.size())
+      throw std::invalid_argument("cannot take the inner product of vectors "
+                                  "with different lengths");
+
+    const auto random = mCorrelator.GenRandomShare();
+    const auto size = mManipulator.ShareSize();
+    AddAndMsgs output;
+    output.add_share = T();
+    output.msgs = mManipulator.DotProductToMsgs(BatchType(size, xs),
+                                                BatchType(size, ys));
+    if (mId < 2 * mThreshold + 1)
+      for (const auto& v : output.msgs[mId]) output.add_share += v;
+    output.add_share -= random.add_share;
+    Append(random, std::move(output));
+  };
+
+  /**
+   * @brief Indicates that we wish to multiply two matrices of shared values.
+   *
+   * Each entry of the product is an inner product, which is reconstructed
+   * and checked as a single multiplication, so an N x P by P x M product
+   * costs N * M multiplications. Run returns the shares of the entries in
+   * row-major order.
+   *
+   * @param xs replicated shares of an N x P matrix, in row-major order
+   * @param ys replicated shares of a P x M matrix, in row-major order
+   * @param rows N
+   * @param inner P
+   * @param cols M
+   * @throws std::invalid_argument if the number of shares does not match the
+   * dimensions.
+   */
+  void PrepareMatMul(const std::vector<ShareType>& xs,
+                     const std::vector<ShareType>& ys, std::size_t rows,
+                     std::size_t inner, std::size_t cols) {
+    TRACE_SPAN("Mult::PrepareMatMul");
+    TRACE_COUNT(eElements, rows * cols);
+    const auto size = mManipulator.ShareSize();
+    auto msgs = mManipulator.MatMulToMsgs(
+        BatchType(size, xs), BatchType(size, ys), rows, inner, cols);
+    auto randoms = mCorrelator.GenRandomShares(rows * cols);
+
+    // the messages are kept as a batch, which Check compresses directly.
+    const auto double_size = mManipulator.GetDoubleReplicator().ShareSize();
+    const auto offset = mCheckData->msgs.size();
+    for (std::size_t i = 0; i < rows * cols; i++) {
+      AddAndMsgs output;
+      output.add_share = T();
+      if (mId < 2 * mThreshold + 1)
+        for (std::size_t c = 0; c < double_size; c++)
+          output.add_share += msgs.Column(mId * double_size + c)[i];
+      output.add_share -= randoms[i].add_share;
+      Append(randoms[i], std::move(output));
+    }
+    mCheckData->msg_batches.push_back({offset, std::move(msgs)});
   };
 
   /**
    * @brief Run the multiplication protocol.
    * @return secret shares of each party's input
    */
-  std::vector<Shr> Run() {
+  std::vector<ShareType> Run() {
+    TRACE_SPAN("Mult::Run");
+    TRACE_COUNT(eElements, mCount);
     mCheckData->counter += mCount;
     SendStep();
     if (mId == 0) ReconstructionStep();
@@ -112,56 +242,97 @@ class Mult {
   /**
    * @brief Parties adjust their local shares to get a share of the output
    */
-  std::vector<Shr> OutputStep();
+  std::vector<ShareType> OutputStep();
 
  private:
   std::shared_ptr<Network> mNetwork;
-  frn::lib::secret_sharing::Replicator<Field> mReplicator;
+  frn::lib::secret_sharing::Replicator<T> mReplicator;
   unsigned mId;
   std::size_t mThreshold;
   std::size_t mSize;
-  ShrManipulator mManipulator;
-  Correlator mCorrelator;
+  BasicShrManipulator<T> mManipulator;
+  BasicCorrelator<T> mCorrelator;
   std::size_t mCount;
 
   // vector with the random shares used for the multiplications
   std::vector<RandomShare> mRandomShares;
   // vector with additive shares sent to P1
-  std::vector<Field> mSharesToSendP1;
+  std::vector<T> mSharesToSendP1;
   // vector of length 2d+1 where each entry is the vector of additive
   // shares that P1 receives from each party
-  std::vector<std::vector<Field>> mSharesRecvByP1;
+  std::vector<std::vector<T>> mSharesRecvByP1;
   // vector of the reconstructed values received from P1
-  std::vector<Field> mValuesRecvFromP1;
+  std::vector<T> mValuesRecvFromP1;
   // vector of the reconstructed values that P1 sent
-  std::vector<Field> mValuesSentFromP1;
+  std::vector<T> mValuesSentFromP1;
 
   CheckData * mCheckData;
 
-  AddAndMsgs MultiplyToAddAndMsgs(const Shr& a, const Shr& b,
-                                  const RandomShare& randomShares) {
+  // specialized MultiplyToAddAndMsgs for this configuration, if there is one.
+  // Kernels are only generated for Field.
+  FixedMultiplyKernel mFixedKernel;
+
+  static FixedMultiplyKernel FindKernel(std::size_t n, std::size_t t,
+                                        std::size_t id) {
+    if constexpr (std::is_same_v<T, Field>)
+      return FindMultiplyKernel(n, t, id);
+    else
+      return nullptr;
+  }
+
+  void Append(const RandomShare& randomShares, AddAndMsgs output) {
     mRandomShares.emplace_back(randomShares);
+    mSharesToSendP1.emplace_back(output.add_share);
+
+    // Append check data
+    mCheckData->shares_sent_to_p1.emplace_back(output.add_share);
+    mCheckData->msgs.emplace_back(std::move(output.msgs));
+
+    ++mCount;
+  }
 
+  // append the multiplications of a batch of messages laid out as by
+  // ShrManipulator::MultiplyToMsgs.
+  void AppendBatch(const std::vector<RandomShare>& randoms,
+                   const BatchType& msgs) {
+    const auto double_size = mManipulator.GetDoubleReplicator().ShareSize();
+    for (std::size_t i = 0; i < msgs.Size(); i++) {
+      AddAndMsgs output;
+      output.add_share = T();
+      output.msgs =
+          std::vector<ShareType>(2 * mThreshold + 1, ShareType(double_size));
+      for (std::size_t p = 0; p < 2 * mThreshold + 1; p++) {
+        for (std::size_t c = 0; c < double_size; c++) {
+          output.msgs[p][c] = msgs.Column(p * double_size + c)[i];
+          if (p == mId) output.add_share += output.msgs[p][c];
+        }
+      }
+      output.add_share -= randoms[i].add_share;
+      Append(randoms[i], std::move(output));
+    }
+  }
+
+  AddAndMsgs MultiplyToAddAndMsgs(const ShareType& a, const ShareType& b,
+                                  const RandomShare& randomShares) {
     // Initialize output
     AddAndMsgs output;
-    output.add_share = Field(0);
-    output.msgs = std::vector<Shr>(
-        2 * mThreshold + 1,
-        Shr(mManipulator.GetDoubleReplicator().ShareSize(), Field(0)));
-
-    Field prod;
-
-    for (MultEntry tuple : mManipulator.GetTableMult()) {
-      unsigned src_a = tuple.src_a;
-      unsigned src_b = tuple.src_b;
-      unsigned dest = tuple.dest_c;
-      unsigned first_party = tuple.first_party;
-
-      prod = a[src_a] * b[src_b];
-      output.msgs[first_party][dest] += prod;
-      if (mId == first_party) output.add_share += prod;
+    output.add_share = T();
+
+    if constexpr (std::is_same_v<T, Field>) {
+      if (mFixedKernel) {
+        output.msgs = std::vector<ShareType>(
+            2 * mThreshold + 1,
+            ShareType(mManipulator.GetDoubleReplicator().ShareSize()));
+        mFixedKernel(a, b, output.add_share, output.msgs);
+        output.add_share -= randomShares.add_share;
+        return output;
+      }
     }
 
+    output.msgs = mManipulator.MultiplyToMsgs(a, b);
+    if (mId < 2 * mThreshold + 1)
+      for (const auto& v : output.msgs[mId]) output.add_share += v;
+
     // Subtract random keys
     output.add_share -= randomShares.add_share;
 
@@ -170,6 +341,89 @@ class Mult {
   }
 };
 
+/**
+ * @brief The Mult protocol over Field.
+ */
+using Mult = BasicMult<Field>;
+
+extern template class BasicMult<Field>;
+
+template <typename T>
+void BasicMult<T>::SendStep() {
+  TRACE_SPAN("Mult::SendStep");
+  {
+    TRACE_SPAN("send");
+    // Send shares to P1
+    if (mId < 2 * mThreshold + 1) {
+      mNetwork->SendValues(0, mSharesToSendP1);
+    }
+  }
+  TRACE_SPAN("receive");
+  // P1 receives the shares
+  if (mId == 0) {
+    for (std::size_t i = 0; i < 2 * mThreshold + 1; ++i) {
+      mSharesRecvByP1[i] = mNetwork->RecvValues<T>(i, mCount);
+
+      // Append these shares to shares_recv_by_p1[i]
+      mCheckData->shares_recv_by_p1[i].insert(mCheckData->shares_recv_by_p1[i].end(),
+					     mSharesRecvByP1[i].begin(),
+					     mSharesRecvByP1[i].end());
+
+      // mCheckData.insert_shares_recv_by_P1(i, mSharesRecvByP1)
+    }
+  }
+}
+
+template <typename T>
+void BasicMult<T>::ReconstructionStep() {
+  TRACE_SPAN("Mult::ReconstructionStep");
+  // P1 reconstructs the xy-r's
+  mValuesSentFromP1.resize(mCount);
+  for (std::size_t mult_id = 0; mult_id < mCount; ++mult_id) {
+    mValuesSentFromP1[mult_id] = T();
+    for (std::size_t party_id = 0; party_id < 2 * mThreshold + 1; ++party_id) {
+      mValuesSentFromP1[mult_id] += mSharesRecvByP1[party_id][mult_id];
+    }
+  }
+
+  // P1 sends the reconstructions to parties in T=1...n-d
+  for (std::size_t party_id = 0; party_id < mSize - mThreshold; ++party_id) {
+    mNetwork->SendValues(party_id, mValuesSentFromP1);
+  }
+}
+
+template <typename T>
+auto BasicMult<T>::OutputStep() -> std::vector<ShareType> {
+  TRACE_SPAN("Mult::OutputStep");
+  {
+    TRACE_SPAN("receive");
+    // Parties in T receive the message from P1
+    if (mId < mSize - mThreshold) {
+      mValuesRecvFromP1 = mNetwork->RecvValues<T>(0, mCount);
+
+      // Append this to CheckData
+      mCheckData->values_recv_from_p1.insert(
+          mCheckData->values_recv_from_p1.end(), mValuesRecvFromP1.begin(),
+          mValuesRecvFromP1.end());
+    } else {
+      // Other parties can pretend they received 0 from P1
+      // This doesn't matter as they don't do anything when adding the
+      // constant
+      mValuesRecvFromP1 = std::vector<T>(mCount);
+    }
+  }
+
+  TRACE_SPAN("add_constant");
+  // All parties compute the resulting shares
+  std::vector<ShareType> output;
+  output.resize(mCount);
+  for (std::size_t mult_id = 0; mult_id < mCount; ++mult_id) {
+    output[mult_id] = mManipulator.AddConstant(mRandomShares[mult_id].rep_share,
+                                               mValuesRecvFromP1[mult_id]);
+  }
+  return output;
+}
+
 }  // namespace frn
 
 #endif  // INPUT_H
@@ -2,6 +2,7 @@
 #define NETWORK_H
 
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "frn/shr.h"
@@ -70,6 +71,59 @@ class Network {
    */
   virtual std::vector<unsigned char> RecvBytes(unsigned id, std::size_t n) = 0;
 
+  /**
+   * @brief Make sure everything sent so far is on its way.
+   *
+   * Networks may hold back small messages to combine them. Receiving flushes
+   * implicitly, so this is only needed when a party is done sending but does
+   * not receive anything afterwards.
+   */
+  virtual void Flush(){};
+
+  /**
+   * @brief Send a vector of ring elements to another party.
+   *
+   * Field elements go through Send, and elements of any other ring are sent
+   * as <code>T::ByteSize()</code> bytes each.
+   *
+   * @tparam T the ring
+   * @param id the ID of the remote party
+   * @param values the elements to send
+   */
+  template <typename T>
+  void SendValues(unsigned id, const std::vector<T>& values) {
+    if constexpr (std::is_same_v<T, Field>) {
+      Send(id, values);
+    } else {
+      std::vector<unsigned char> data(values.size() * T::ByteSize());
+      for (std::size_t i = 0; i < values.size(); i++)
+        values[i].ToBytes(data.data() + i * T::ByteSize());
+      SendBytes(id, data);
+    }
+  }
+
+  /**
+   * @brief Receive a vector of ring elements from a remote party.
+   * @tparam T the ring
+   * @param id the ID of the sender
+   * @param n the number of elements to receive
+   * @return the received elements.
+   * @see SendValues.
+   */
+  template <typename T>
+  std::vector<T> RecvValues(unsigned id, std::size_t n) {
+    if constexpr (std::is_same_v<T, Field>) {
+      return Recv(id, n);
+    } else {
+      const auto data = RecvBytes(id, n * T::ByteSize());
+      std::vector<T> values;
+      values.reserve(n);
+      for (std::size_t i = 0; i < n; i++)
+        values.emplace_back(T::FromBytes(data.data() + i * T::ByteSize()));
+      return values;
+    }
+  }
+
  protected:
   /**
    * @brief Construct a new network
@@ -0,0 +1,179 @@
+#ifndef _FRN_ROWS_H
+#define _FRN_ROWS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "frn/lib/math/fp.h"
+#include "frn/lib/math/kernels.h"
+#include "frn/lib/math/p.h"
+#include "frn/lib/math/vec.h"
+
+namespace frn {
+
+/**
+ * @brief Products of a multiplication table grouped into rows.
+ *
+ * The table is stored in compressed sparse row form: row \f$r\f$ is the sum
+ * of <code>a[src_a[k]] * b[src_b[k]]</code> for
+ * \f$\mathtt{offsets}[r] \leq k < \mathtt{offsets}[r + 1]\f$. Within a row,
+ * products are sorted by <code>src_a</code>.
+ */
+struct MultRows {
+  std::vector<unsigned> offsets;
+  std::vector<unsigned> src_a;
+  std::vector<unsigned> src_b;
+
+  /**
+   * @brief The number of rows.
+   */
+  std::size_t Rows() const { return offsets.size() - 1; };
+};
+
+namespace details {
+
+/**
+ * @brief Whether rows over T are evaluated by the fused
+ * <code>sum_of_products</code> kernel and reduced lazily, which only Mp61
+ * supports.
+ */
+template <typename T>
+inline constexpr bool kUsesSumOfProducts =
+    std::is_same_v<T, frn::lib::math::FpElement<frn::lib::math::Mp61>>;
+
+/**
+ * @brief Whether operations on arrays of T use the batch kernels.
+ */
+template <typename T>
+inline constexpr bool kUsesKernels =
+    frn::lib::math::vector::details::kUsesKernels<T>;
+
+/**
+ * @brief The underlying values of an array of <code>FpElement</code>.
+ */
+template <typename T>
+typename T::ValueType* Values(T* x) {
+  static_assert(sizeof(T) == sizeof(typename T::ValueType));
+  return reinterpret_cast<typename T::ValueType*>(x);
+}
+
+template <typename T>
+const typename T::ValueType* Values(const T* x) {
+  static_assert(sizeof(T) == sizeof(typename T::ValueType));
+  return reinterpret_cast<const typename T::ValueType*>(x);
+}
+
+/**
+ * @brief \f$x_i = x_i + y_i\f$ for \f$i < n\f$.
+ */
+template <typename T>
+void AddInto(T* x, const T* y, std::size_t n) {
+  if constexpr (kUsesKernels<T>) {
+    frn::lib::math::vector::details::Kernels<T>().add_into(Values(x),
+                                                           Values(y), n);
+  } else {
+    for (std::size_t i = 0; i < n; i++) x[i] += y[i];
+  }
+}
+
+/**
+ * @brief \f$\sum_{i < n} x_i\f$.
+ */
+template <typename T>
+T Sum(const T* x, std::size_t n) {
+  if constexpr (kUsesSumOfProducts<T>) {
+    // reduced values are below 2^61, so this overflows only for n >= 2^67.
+    __uint128_t sum = 0;
+    for (std::size_t i = 0; i < n; i++) sum += x[i].Value();
+    return T((std::uint64_t)(sum & T::Modulus()) +
+             (std::uint64_t)(sum >> T::PackedBitSize()));
+  } else {
+    T sum;
+    for (std::size_t i = 0; i < n; i++) sum += x[i];
+    return sum;
+  }
+}
+
+/**
+ * @brief Row <code>row</code> of a table evaluated over two shares.
+ */
+template <typename T>
+T RowSum(const MultRows& rows, std::size_t row, const std::vector<T>& a,
+         const std::vector<T>& b) {
+  const auto begin = rows.offsets[row];
+  const auto end = rows.offsets[row + 1];
+  if constexpr (kUsesSumOfProducts<T>) {
+    // products are folded modulo the Mersenne prime up to a multiple of it,
+    // and the row is reduced once at the end.
+    using u64 = std::uint64_t;
+    using u128 = __uint128_t;
+    constexpr u64 p = T::Modulus();
+    constexpr unsigned bits = T::PackedBitSize();
+    u128 acc = 0;
+    for (auto k = begin; k < end; k++) {
+      const u128 z = (u128)a[rows.src_a[k]].Value() * b[rows.src_b[k]].Value();
+      acc += (u64)(z & p) + (u64)(z >> bits);
+    }
+    return T((u64)(acc & p) + (u64)(acc >> bits));
+  } else {
+    T acc;
+    for (auto k = begin; k < end; k++)
+      acc += a[rows.src_a[k]] * b[rows.src_b[k]];
+    return acc;
+  }
+}
+
+/**
+ * @brief Every row of a table evaluated over n shares stored element by
+ * element.
+ *
+ * Element \f$s\f$ of share \f$i\f$ is <code>a[s * stride + i]</code>, and
+ * likewise for b. Row \f$r\f$ of share \f$i\f$ is written to
+ * <code>out[r * out_stride + i]</code>.
+ */
+template <typename T>
+void EvaluateRows(const MultRows& rows, const T* a, const T* b,
+                  std::size_t stride, std::size_t n, T* out,
+                  std::size_t out_stride) {
+  if constexpr (kUsesSumOfProducts<T>) {
+    const auto& kernels = frn::lib::math::vector::details::Kernels<T>();
+    for (std::size_t r = 0; r < rows.Rows(); r++) {
+      const auto first = rows.offsets[r];
+      kernels.sum_of_products(Values(out + r * out_stride), Values(a),
+                              Values(b), stride, rows.src_a.data() + first,
+                              rows.src_b.data() + first,
+                              rows.offsets[r + 1] - first, n);
+    }
+  } else if constexpr (kUsesKernels<T>) {
+    // each product is computed into a temporary and added to its row.
+    const auto& kernels = frn::lib::math::vector::details::Kernels<T>();
+    std::vector<T> product(n);
+    for (std::size_t r = 0; r < rows.Rows(); r++) {
+      T* row = out + r * out_stride;
+      std::fill_n(row, n, T());
+      for (auto k = rows.offsets[r]; k < rows.offsets[r + 1]; k++) {
+        std::copy_n(a + rows.src_a[k] * stride, n, product.begin());
+        kernels.multiply_into(Values(product.data()),
+                              Values(b + rows.src_b[k] * stride), n);
+        kernels.add_into(Values(row), Values(product.data()), n);
+      }
+    }
+  } else {
+    for (std::size_t r = 0; r < rows.Rows(); r++) {
+      T* row = out + r * out_stride;
+      std::fill_n(row, n, T());
+      for (auto k = rows.offsets[r]; k < rows.offsets[r + 1]; k++) {
+        const T* x = a + rows.src_a[k] * stride;
+        const T* y = b + rows.src_b[k] * stride;
+        for (std::size_t i = 0; i < n; i++) row[i] += x[i] * y[i];
+      }
+    }
+  }
+}
+
+}  // namespace details
+}  // namespace frn
+
+#endif  // _FRN_ROWS_H
@@ -0,0 +1,71 @@
+#include "frn/shamir.h"
+
+#include <algorithm>
+
+frn::ShamirManipulator::ShamirManipulator(
+    std::size_t id,
+    const frn::lib::secret_sharing::Replicator<Field>& replicator) {
+  using Shamir = frn::lib::secret_sharing::Shamir<Field>;
+  const auto x = Shamir::Point(id);
+  const auto& index_set = replicator.IndexSetFor(id);
+  mCoefficients.reserve(index_set.size());
+
+  std::vector<Field> dens;
+  dens.reserve(index_set.size());
+  std::vector<bool> in_set(replicator.Size());
+  for (auto idx : index_set) {
+    // f_S(x) is the product of (x_j - x) / x_j over the parties j not in S.
+    std::fill(in_set.begin(), in_set.end(), false);
+    for (auto party : replicator.Combination(idx)) in_set[party] = true;
+    Field num = Field::kOne;
+    Field den = Field::kOne;
+    for (std::size_t j = 0; j < replicator.Size(); j++) {
+      if (in_set[j]) continue;
+      num *= Shamir::Point(j) - x;
+      den *= Shamir::Point(j);
+    }
+    mCoefficients.emplace_back(num);
+    dens.emplace_back(den);
+  }
+  frn::lib::math::vector::MultiplyInto(
+      mCoefficients, frn::lib::math::vector::BatchInvertInto(dens));
+}
+
+std::vector<frn::ShamirShr> frn::ShamirManipulator::FromReplicated(
+    const std::vector<Shr>& shares) const {
+  std::vector<ShamirShr> output;
+  output.reserve(shares.size());
+  for (const auto& share : shares) output.emplace_back(FromReplicated(share));
+  return output;
+}
+
+std::vector<frn::Field> frn::ShamirOpen::Run() {
+  TRACE_SPAN("ShamirOpen::Run");
+  TRACE_COUNT(eElements, mShares.size());
+  const auto size = mNetwork->Size();
+  for (std::size_t i = 0; i < size; i++) mNetwork->Send(i, mShares);
+
+  std::vector<std::vector<Field>> received(size);
+  for (std::size_t i = 0; i < size; i++)
+    received[i] = mNetwork->Recv(i, mShares.size());
+
+  std::vector<Field> output;
+  output.reserve(mShares.size());
+  std::vector<ShamirShr> shares(size);
+  for (std::size_t k = 0; k < mShares.size(); k++) {
+    for (std::size_t i = 0; i < size; i++) shares[i] = received[i][k];
+    output.emplace_back(mShamir.ErrorDetection(shares));
+  }
+  mShares.clear();
+  return output;
+}
+
+std::vector<frn::Shr> frn::ShamirToReplicated::Run() {
+  TRACE_SPAN("ShamirToReplicated::Run");
+  auto opened = mOpen.Run();
+  std::vector<Shr> output;
+  output.swap(mRandomShares);
+  if (mHoldsConstant)
+    for (std::size_t k = 0; k < output.size(); k++) output[k][0] += opened[k];
+  return output;
+}
@@ -0,0 +1,196 @@
+#ifndef _FRN_SHAMIR_H
+#define _FRN_SHAMIR_H
+
+#include <memory>
+#include <vector>
+
+#include "frn/corr.h"
+#include "frn/lib/secret_sharing/shamir.h"
+#include "frn/network.h"
+#include "frn/shr.h"
+
+namespace frn {
+
+/**
+ * Type of a Shamir share. A single field element.
+ */
+using ShamirShr = frn::lib::secret_sharing::Shamir<Field>::ShareType;
+
+/**
+ * @brief Create a factory for degree (n - 1) / 3 Shamir shares.
+ * @param n the number of parties to support
+ * @return a Shamir factory.
+ */
+inline frn::lib::secret_sharing::Shamir<Field> CreateShamir(int n) {
+  return frn::lib::secret_sharing::Shamir<Field>(n, (n - 1) / 3);
+}
+
+/**
+ * @brief A class for computing on Shamir shares locally, and for converting
+ * replicated shares to Shamir shares.
+ *
+ * A replicated sharing is a sum of additive components \f$r_S\f$, one for
+ * each set \f$S\f$ of n - t parties, where \f$r_S\f$ is known by the parties
+ * in \f$S\f$. Let \f$f_S\f$ be the polynomial of degree t with
+ * \f$f_S(0) = 1\f$ and \f$f_S(j + 1) = 0\f$ for the t parties \f$j \notin
+ * S\f$. Then party i obtains a share of a degree t Shamir sharing of the same
+ * secret as \f$\sum_{S \ni i} r_S \cdot f_S(i + 1)\f$, without any
+ * interaction.
+ */
+class ShamirManipulator {
+ public:
+  /**
+   * @brief Create a new manipulator for Shamir shares.
+   * @param id the ID of this party
+   * @param replicator the replicator whose shares are converted
+   */
+  ShamirManipulator(
+      std::size_t id,
+      const frn::lib::secret_sharing::Replicator<Field>& replicator);
+
+  /**
+   * @brief Add two shares.
+   */
+  ShamirShr Add(const ShamirShr& a, const ShamirShr& b) const { return a + b; };
+
+  /**
+   * @brief Subtract two shares.
+   */
+  ShamirShr Subtract(const ShamirShr& a, const ShamirShr& b) const {
+    return a - b;
+  };
+
+  /**
+   * @brief Add a constant to a share. Every party adds the constant.
+   */
+  ShamirShr AddConstant(const ShamirShr& a, const Field& c) const {
+    return a + c;
+  };
+
+  /**
+   * @brief Multiply a constant unto a share.
+   */
+  ShamirShr MultiplyConstant(const ShamirShr& a, const Field& c) const {
+    return a * c;
+  };
+
+  /**
+   * @brief Convert a replicated share to a Shamir share of the same secret.
+   * @param share the replicated share
+   * @return a degree t Shamir share.
+   */
+  ShamirShr FromReplicated(const Shr& share) const {
+    return frn::lib::math::vector::Dot(share, mCoefficients);
+  };
+
+  /**
+   * @brief Convert a list of replicated shares to Shamir shares.
+   */
+  std::vector<ShamirShr> FromReplicated(const std::vector<Shr>& shares) const;
+
+ private:
+  // f_S(id + 1) for the set S of each element of a replicated share.
+  std::vector<Field> mCoefficients;
+};
+
+/**
+ * @brief Open degree t Shamir shares to all parties.
+ *
+ * Every party sends its shares to every party, and checks that the n shares of
+ * each value lie on a polynomial of degree t. Requires t < n/2.
+ */
+class ShamirOpen {
+ public:
+  /**
+   * @brief Create a new open protocol instance.
+   * @param network an object for talking with other parties
+   * @param shamir the Shamir factory
+   */
+  ShamirOpen(std::shared_ptr<Network> network,
+             const frn::lib::secret_sharing::Shamir<Field>& shamir)
+      : mNetwork(network), mShamir(shamir){};
+
+  /**
+   * @brief Indicate that we wish to open a share.
+   */
+  void Prepare(const ShamirShr& share) { mShares.emplace_back(share); };
+
+  void Prepare(const std::vector<ShamirShr>& shares) {
+    mShares.insert(mShares.end(), shares.begin(), shares.end());
+  };
+
+  /**
+   * @brief Run the open protocol.
+   * @return the opened values.
+   * @throws std::runtime_error if the shares of some value are inconsistent.
+   */
+  std::vector<Field> Run();
+
+ private:
+  std::shared_ptr<Network> mNetwork;
+  frn::lib::secret_sharing::Shamir<Field> mShamir;
+  std::vector<ShamirShr> mShares;
+};
+
+/**
+ * @brief Convert Shamir shares back to replicated shares.
+ *
+ * For each Shamir share of x, the parties take a random replicated share of r
+ * from the Correlator, convert it locally to a Shamir share, and open x - r.
+ * The output is the replicated share of r plus the opened value, i.e., a fresh
+ * replicated sharing of x.
+ */
+class ShamirToReplicated {
+ public:
+  /**
+   * @brief Create a new conversion protocol instance.
+   * @param network an object for talking with other parties
+   * @param replicator the replicator of the output shares
+   * @param correlator object for obtaining random shares
+   */
+  ShamirToReplicated(
+      std::shared_ptr<Network> network,
+      const frn::lib::secret_sharing::Replicator<Field>& replicator,
+      const Correlator& correlator)
+      : mManipulator(network->Id(), replicator),
+        mCorrelator(correlator),
+        mOpen(network, frn::lib::secret_sharing::Shamir<Field>(
+                           replicator.Size(), replicator.Threshold())),
+        mHoldsConstant(replicator.IndexSetFor(network->Id())[0] == 0){};
+
+  /**
+   * @brief Indicate that we wish to convert a share.
+   */
+  void Prepare(const ShamirShr& share) {
+    Prepare(share, mCorrelator.GenRandomShare().rep_share);
+  };
+
+  void Prepare(const std::vector<ShamirShr>& shares) {
+    auto randoms = mCorrelator.GenRandomShares(shares.size());
+    for (std::size_t i = 0; i < shares.size(); i++)
+      Prepare(shares[i], randoms[i].rep_share);
+  };
+
+  /**
+   * @brief Run the conversion protocol.
+   * @return replicated shares of the values of the prepared shares.
+   */
+  std::vector<Shr> Run();
+
+ private:
+  ShamirManipulator mManipulator;
+  Correlator mCorrelator;
+  ShamirOpen mOpen;
+  // whether this party holds the first element, to which constants are added.
+  bool mHoldsConstant;
+  std::vector<Shr> mRandomShares;
+
+  void Prepare(const ShamirShr& share, const Shr& random) {
+    mOpen.Prepare(share - mManipulator.FromReplicated(random));
+    mRandomShares.emplace_back(random);
+  };
+};
+
+}  // namespace frn
+
+#endif  // _FRN_SHAMIR_H
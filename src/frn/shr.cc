@@ -1,89 +1,45 @@
 #include "frn/shr.h"
 
-frn::Shr frn::ShrManipulator::Add(const frn::Shr& a, const frn::Shr& b) {
-  Shr r;
-  r.reserve(a.size());
-  for (std::size_t i = 0; i < a.size(); i++) {
-    r.emplace_back(a[i] + b[i]);
-  }
-  return r;
-}
-
-frn::Shr frn::ShrManipulator::AddConstant(const frn::Shr& a,
-                                          const frn::Field& c) {
-  if (mIndexForConstantOps == -1) return a;
-  Shr r;
-  r = a;
-  r[mIndexForConstantOps] += c;
-  return r;
-}
-
-frn::Shr frn::ShrManipulator::Subtract(const frn::Shr& a, const frn::Shr& b) {
-  Shr r;
-  r.reserve(a.size());
-  for (std::size_t i = 0; i < a.size(); i++) {
-    r.emplace_back(a[i] - b[i]);
-  }
-  return r;
-}
+#include <algorithm>
 
-frn::Shr frn::ShrManipulator::SubtractConstant(const frn::Shr& a,
-                                               const frn::Field& c) {
-  if (mIndexForConstantOps == -1) return a;
-  Shr r;
-  r = a;
-  r[mIndexForConstantOps] -= c;
-  return r;
-}
-
-frn::Shr frn::ShrManipulator::SubtractConstant(const frn::Field& c,
-                                               const frn::Shr& a) {
-  Shr r;
-  r.reserve(a.size());
-  for (const auto& s : a) r.emplace_back(-s);
-  if (mIndexForConstantOps == -1) return r;
-  r[mIndexForConstantOps] += c;
-  return r;
-}
-
-frn::Shr frn::ShrManipulator::MultiplyConstant(const frn::Shr& a,
-                                               const frn::Field& c) {
-  Shr r;
-  r.reserve(a.size());
-  for (const auto& s : a) r.emplace_back(c * s);
-  return r;
-}
-
-frn::ShrD frn::ShrManipulator::MultiplyToDoubleDegree(const frn::Shr& a,
-                                                      const frn::Shr& b) {
-  std::vector<Field> c((int)mDoubleReplicator.ShareSize(), Field(0));
+#define INDEX_SHARE_FOR_CNST 0
 
-  for (const auto& triple : mTableMult) {
-    int i = triple.src_a;
-    int j = triple.src_b;
-    int idx_in_double_rep_share = triple.dest_c;
-    c[idx_in_double_rep_share] += a[i] * b[j];
+namespace {
+
+using Mask = std::uint64_t;
+
+// group the entries of a multiplication table by a key below size. Entries
+// keep their order within a group.
+template <typename Key>
+frn::MultRows group_by(const std::vector<frn::MultEntry>& table,
+                       std::size_t size, Key key) {
+  frn::MultRows rows;
+  rows.offsets.assign(size + 1, 0);
+  for (const auto& entry : table) rows.offsets[key(entry) + 1]++;
+  for (std::size_t r = 0; r < size; r++)
+    rows.offsets[r + 1] += rows.offsets[r];
+
+  rows.src_a.resize(table.size());
+  rows.src_b.resize(table.size());
+  auto next = rows.offsets;
+  for (const auto& entry : table) {
+    const auto k = next[key(entry)]++;
+    rows.src_a[k] = entry.src_a;
+    rows.src_b[k] = entry.src_b;
   }
-  return c;
+  return rows;
 }
 
-frn::Field frn::ShrManipulator::MultiplyToAdditive(const frn::Shr& a,
-                                                   const frn::Shr& b) {
-  Field c(0);
-
-  for (const auto& tuple : mTableMult) {
-    int i = tuple.src_a;
-    int j = tuple.src_b;
-    if (mPartyId == tuple.first_party) c += a[i] * b[j];
-  }
-  return c;
+Mask to_mask(const std::vector<int>& set) {
+  Mask mask = 0;
+  for (auto i : set) mask |= Mask(1) << i;
+  return mask;
 }
 
-#define INDEX_SHARE_FOR_CNST 0
-
-int frn::ShrManipulator::IndexForConstantOperations() {
-  auto id = mPartyId;
-  auto set = mReplicator.IndexSetFor(id);
+int index_for_constant_operations(
+    const frn::lib::secret_sharing::Replicator<frn::Field>& replicator,
+    std::size_t id) {
+  auto set = replicator.IndexSetFor(id);
 
   // Check if the special index is in set
 
@@ -97,59 +53,103 @@ int frn::ShrManipulator::IndexForConstantOperations() {
   return idx;
 }
 
-void frn::ShrManipulator::Init() {
-  // Precompute mTableMult
-
-  for (unsigned a = 0; a < mReplicator.ShareSize(); ++a) {
-    for (unsigned b = 0; b < mReplicator.ShareSize(); ++b) {
-      // We convert the input indexes from local to global
-      int a_ = mReplicator.IndexSetFor(mPartyId)[a];
-      int b_ = mReplicator.IndexSetFor(mPartyId)[b];
-
-      // We fetch the corresponding input sets
-      std::vector<int> SetA = mReplicator.Combination(a_);
-      std::vector<int> SetB = mReplicator.Combination(b_);
-
-      // Compute the intersection
-      std::vector<int> intersection;
-      frn::lib::secret_sharing::Intersection(SetA, SetB,
-                                        [&intersection, SetA](unsigned i) {
-                                          intersection.emplace_back(SetA[i]);
-                                        });
+}  // namespace
 
-      // Take the first n-2d elements of the intersection
-      intersection.resize(mParties - 2 * mThreshold);
+frn::ShrTables::ShrTables(std::size_t id, std::size_t d, std::size_t n) {
+  // The tables only depend on the sets of parties, so they are computed with
+  // replicators over Field whatever the ring of the shares.
+  const frn::lib::secret_sharing::Replicator<Field> replicator(n, d);
+  const frn::lib::secret_sharing::Replicator<Field> double_replicator(n,
+                                                                       2 * d);
+  mIndexForConstantOps = index_for_constant_operations(replicator, id);
 
-      // Get the index of this set with the replicator of double degree
-      int target_set = mDoubleReplicator.RevComb(intersection);
+  // Precompute mTableMult
+  //
+  // The sets of parties are handled as bit masks, and the set of size n-2d
+  // given by a product is found from its lexicographic rank, which avoids
+  // building and looking up vectors for every pair of indexes.
+  const auto size = replicator.ShareSize();
+  const auto double_size = double_replicator.ShareSize();
+  const std::size_t k = n - 2 * d;
+
+  std::vector<Mask> sets;
+  sets.reserve(size);
+  for (auto idx : replicator.IndexSetFor(id))
+    sets.emplace_back(to_mask(replicator.Combination(idx)));
+
+  // local index of each global index of a degree 2d share, or -1.
+  std::vector<int> double_local(double_replicator.AdditiveShareSize(), -1);
+  const auto& double_index_set = double_replicator.IndexSetFor(id);
+  for (std::size_t i = 0; i < double_index_set.size(); i++)
+    double_local[double_index_set[i]] = i;
+
+  std::vector<std::vector<std::size_t>> binom(
+      n + 1, std::vector<std::size_t>(n + 1, 0));
+  for (std::size_t m = 0; m <= n; m++)
+    for (std::size_t j = 0; j <= m; j++)
+      binom[m][j] = frn::lib::secret_sharing::Binom(m, j);
+
+  for (unsigned a = 0; a < size; ++a) {
+    for (unsigned b = 0; b < size; ++b) {
+      // Take the first n-2d elements of the intersection, and compute the
+      // index of this set with the replicator of double degree.
+      Mask intersection = sets[a] & sets[b];
+      std::size_t rank = 0;
+      std::size_t next = 0;
+      unsigned first_party = __builtin_ctzll(intersection);
+      for (std::size_t i = 0; i < k; i++) {
+        const std::size_t party = __builtin_ctzll(intersection);
+        intersection &= intersection - 1;
+        for (; next < party; next++)
+          rank += binom[n - 1 - next][k - 1 - i];
+        next = party + 1;
+      }
 
       // Check if the current party owns this additive share
-      auto index_set = mDoubleReplicator.IndexSetFor(mPartyId);
-      auto it = find(index_set.begin(), index_set.end(), target_set);
-      int idx = -1;
-      if (it != index_set.end()) {
-        // calculating the desired index
-        idx = it - index_set.begin();
-        if (idx != -1)
-          mTableMult.emplace_back(
-              MultEntry{a, b, (unsigned)idx, (unsigned)intersection[0]});
-      }
+      const int idx = double_local[rank];
+      if (idx != -1)
+        mTableMult.emplace_back(MultEntry{a, b, (unsigned)idx, first_party});
     }
   }
 
+  mRowsByDest = group_by(mTableMult, double_size,
+                         [](const MultEntry& e) { return e.dest_c; });
+  mRowsByParty = group_by(
+      mTableMult, (2 * d + 1) * double_size,
+      [double_size](const MultEntry& e) {
+        return e.first_party * double_size + e.dest_c;
+      });
+
+  // a_i * a_j and a_j * a_i have the same dest_c and first_party, so a
+  // square keeps the products with i <= j and doubles those with i < j.
+  std::vector<MultEntry> square_table;
+  for (const auto& entry : mTableMult) {
+    if (entry.src_a > entry.src_b) continue;
+    auto square_entry = entry;
+    if (entry.src_a < entry.src_b) square_entry.src_b += size;
+    square_table.emplace_back(square_entry);
+  }
+  mSquareRowsByDest = group_by(square_table, double_size,
+                               [](const MultEntry& e) { return e.dest_c; });
+  mSquareRowsByParty = group_by(
+      square_table, (2 * d + 1) * double_size,
+      [double_size](const MultEntry& e) {
+        return e.first_party * double_size + e.dest_c;
+      });
+
   // precompute mTableRec
   // We use the double-replicator since this will be used to reconstruct a degree-2d sharing
-  RecEntry entry;
+  for (unsigned shr_id = 0; shr_id < double_replicator.ShareSize(); shr_id++) {
+    RecEntry entry;
 
-  for (unsigned shr_id = 0; shr_id < mDoubleReplicator.ShareSize(); shr_id++) {
     // We convert the input index from local to global
-    int shr_id_ = mDoubleReplicator.IndexSetFor(mPartyId)[shr_id];
+    int shr_id_ = double_index_set[shr_id];
 
     // We fetch the corresponding set of parties
-    std::vector<int> Set = mDoubleReplicator.Combination(shr_id_);
+    const auto& Set = double_replicator.Combination(shr_id_);
 
     // We let party_set to be these parties NOT in Set
-    for (int party_id = 0; (unsigned)party_id < mParties; party_id++) {
+    for (int party_id = 0; (unsigned)party_id < n; party_id++) {
       auto it = find(Set.begin(), Set.end(), party_id);
       // If party_id is NOT in Set
       if (it == Set.end()) {
@@ -159,7 +159,7 @@ void frn::ShrManipulator::Init() {
 
     // We determine if we send full value or hash .This is done by
     // checking if the given party is the first in the set
-    if (mPartyId == (unsigned)Set[0]) {
+    if (id == (unsigned)Set[0]) {
       entry.value_or_hash = VALUE;
     } else {
       entry.value_or_hash = HASH;
@@ -168,41 +168,4 @@ void frn::ShrManipulator::Init() {
   }
 }
 
-int frn::ShrManipulator::ComputeIndexForDoubleMultiplication(std::size_t a,
-                                                             std::size_t b) {
-  // We convert the input indexes from local to global
-  int a_ = mReplicator.IndexSetFor(mPartyId)[a];
-  int b_ = mReplicator.IndexSetFor(mPartyId)[b];
-
-  // We fetch the corresponding input sets
-  std::vector<int> SetA = mReplicator.Combination(a_);
-  std::vector<int> SetB = mReplicator.Combination(b_);
-
-  // Compute the intersection
-  std::vector<int> intersection;
-  frn::lib::secret_sharing::Intersection(SetA, SetB, [&intersection, SetA](int i) {
-    intersection.emplace_back(SetA[i]);
-  });
-
-  // Take the first n-2d elements of the intersection
-  intersection.resize(mParties - 2 * mThreshold);
-
-  // Get the index of this set with the replicator of double degree
-  int target_set = mDoubleReplicator.RevComb(intersection);
-
-  // Check if the current party owns this additive share
-  auto index_set = mDoubleReplicator.IndexSetFor(mPartyId);
-  auto it = find(index_set.begin(), index_set.end(), target_set);
-  int idx;
-
-  // If element was found
-  if (it != index_set.end()) {
-    // calculating the desired index
-    idx = it - index_set.begin();
-  } else {
-    // If the element is not
-    // present in the vector
-    idx = -1;
-  }
-  return idx;
-}
+template class frn::BasicShrManipulator<frn::Field>;
@@ -1,10 +1,14 @@
 #ifndef SHR_H
 #define SHR_H
 
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 
+#include "frn/lib/math/mat.h"
 #include "frn/lib/primitives/prg.h"
 #include "frn/lib/secret_sharing/rep.h"
+#include "frn/rows.h"
 #include "frn/util.h"
 
 namespace frn {
@@ -29,6 +33,105 @@ struct MultEntry {
   unsigned first_party;
 };
 
+namespace details {
+
+// Number of shares in a block of a batched multiplication. A block of every
+// element of the inputs should fit in L2 for the configurations we run.
+constexpr std::size_t kBatchBlock = 64;
+
+}  // namespace details
+
+/**
+ * @brief A batch of replicated shares stored element by element.
+ *
+ * Element \f$i\f$ of all the shares in the batch is stored contiguously, so an
+ * operation applied to the same element of every share is an operation on an
+ * array, which the kernels in frn::lib::math::kernels vectorize.
+ *
+ * @tparam T the ring the shares are over.
+ */
+template <typename T>
+class BasicShareBatch {
+ public:
+  //! Type of a share in the batch.
+  using ShareType = std::vector<T>;
+
+  /**
+   * @brief Create a batch of zero shares.
+   * @param share_size the number of elements in each share
+   * @param size the number of shares
+   */
+  BasicShareBatch(std::size_t share_size, std::size_t size)
+      : mShareSize(share_size), mSize(size), mValues(share_size * size){};
+
+  /**
+   * @brief Create a batch from a list of shares.
+   * @param share_size the number of elements in each share
+   * @param shares the shares
+   */
+  BasicShareBatch(std::size_t share_size, const std::vector<ShareType>& shares)
+      : BasicShareBatch(share_size, shares.size()) {
+    for (std::size_t k = 0; k < mSize; k++)
+      for (std::size_t i = 0; i < mShareSize; i++)
+        Column(i)[k] = shares[k][i];
+  };
+
+  /**
+   * @brief The number of shares in the batch.
+   */
+  std::size_t Size() const { return mSize; };
+
+  /**
+   * @brief The number of elements in each share.
+   */
+  std::size_t ShareSize() const { return mShareSize; };
+
+  /**
+   * @brief Element <code>element</code> of every share in the batch.
+   */
+  T* Column(std::size_t element) { return mValues.data() + element * mSize; };
+
+  /**
+   * @brief Element <code>element</code> of every share in the batch.
+   */
+  const T* Column(std::size_t element) const {
+    return mValues.data() + element * mSize;
+  };
+
+  /**
+   * @brief Get one share of the batch.
+   * @param idx the index of the share
+   * @return the share.
+   */
+  ShareType At(std::size_t idx) const {
+    ShareType share;
+    share.reserve(mShareSize);
+    for (std::size_t i = 0; i < mShareSize; i++)
+      share.emplace_back(Column(i)[idx]);
+    return share;
+  };
+
+  /**
+   * @brief Convert the batch to a list of shares.
+   */
+  std::vector<ShareType> ToShares() const {
+    std::vector<ShareType> shares;
+    shares.reserve(mSize);
+    for (std::size_t k = 0; k < mSize; k++) shares.emplace_back(At(k));
+    return shares;
+  };
+
+ private:
+  std::size_t mShareSize;
+  std::size_t mSize;
+  std::vector<T> mValues;
+};
+
+/**
+ * @brief A batch of replicated shares over Field.
+ */
+using ShareBatch = BasicShareBatch<Field>;
+
 enum RecType {
   VALUE,
   HASH,
@@ -50,26 +153,115 @@ inline frn::lib::secret_sharing::Replicator<Field> CreateReplicator(int n) {
   return frn::lib::secret_sharing::Replicator<Field>(n, (n - 1) / 3);
 }
 
+/**
+ * @brief The tables a party uses to compute on its replicated shares.
+ *
+ * The tables only depend on which sets of parties hold each element of a
+ * share, so they are the same for shares over any ring.
+ */
+class ShrTables {
+ public:
+  /**
+   * @brief Compute the tables of a party.
+   * @param id the ID of this party
+   * @param d the threshold
+   * @param n the number of parties
+   */
+  ShrTables(std::size_t id, std::size_t d, std::size_t n);
+
+  const std::vector<MultEntry>& GetTableMult() const { return mTableMult; }
+
+  /**
+   * @brief The multiplication table with one row per element of a degree 2d
+   * share.
+   */
+  const MultRows& GetRowsByDest() const { return mRowsByDest; }
+
+  /**
+   * @brief The multiplication table with one row per element of a message,
+   * ordered as the output of MultiplyToMsgs.
+   */
+  const MultRows& GetRowsByParty() const { return mRowsByParty; }
+
+  /**
+   * @brief The table of GetRowsByDest for squares.
+   *
+   * The products \f$a_i a_j\f$ and \f$a_j a_i\f$ of a square end up in the
+   * same row, so only \f$i \leq j\f$ is kept. <code>src_b</code> indexes the
+   * share followed by its double, so that an entry with \f$i < j\f$ is the
+   * product \f$a_i \cdot 2a_j\f$.
+   */
+  const MultRows& GetSquareRowsByDest() const { return mSquareRowsByDest; }
+
+  /**
+   * @brief The table of GetRowsByParty for squares.
+   * @see GetSquareRowsByDest.
+   */
+  const MultRows& GetSquareRowsByParty() const { return mSquareRowsByParty; }
+
+  const std::vector<RecEntry>& GetTableRec() const { return mTableRec; }
+
+ protected:
+  /**
+   * @brief Determines if this party should perform an action during operations
+   * on constants.
+   *
+   * @return An index representing the share element to which a constant should
+   * be added or subtracted. -1 is returned if this party does nothing during
+   * constant operations.
+   */
+  int IndexForConstantOperations() const { return mIndexForConstantOps; };
+
+ private:
+  // Tables used by the party to determine which shares to multiply
+  // (and for the case of 2d-shares, where to store them)
+  std::vector<MultEntry> mTableMult;
+
+  // mTableMult grouped by dest_c, and by (first_party, dest_c).
+  MultRows mRowsByDest;
+  MultRows mRowsByParty;
+
+  // the same for squares, with mirrored products combined.
+  MultRows mSquareRowsByDest;
+  MultRows mSquareRowsByParty;
+
+  // Table used to determine which shares must be sent to which
+  // parties when reconstructing, and when do we send full values or
+  // hashes.
+  std::vector<RecEntry> mTableRec;
+
+  int mIndexForConstantOps;
+};
+
 /**
  * @brief A class for performing arithmetic manipulations of shares locally.
+ *
+ * @tparam T the ring the shares are over. Shares over Field, Mp31 and Mp127
+ * are computed on with the batch kernels, and shares over any other ring,
+ * e.g., Z2kElement, with scalar arithmetic.
  */
-class ShrManipulator {
+template <typename T>
+class BasicShrManipulator : public ShrTables {
  public:
+  //! Type of a replicated share.
+  using ShareType = std::vector<T>;
+
+  //! Type of a batch of replicated shares.
+  using BatchType = BasicShareBatch<T>;
+
   /**
    * @brief Create a new manipulator for replicated shares.
    * @param id the ID of this party
    * @param d the threshold
    * @param n the number of parties
    */
-  ShrManipulator(std::size_t id, std::size_t d, std::size_t n)
-      : mPartyId(id),
+  BasicShrManipulator(std::size_t id, std::size_t d, std::size_t n)
+      : ShrTables(id, d, n),
+        mPartyId(id),
         mParties(n),
         mThreshold(d),
         mReplicator(n, d),
-        mDoubleReplicator(n, 2 * d),
-        mIndexForConstantOps(IndexForConstantOperations()) {
-    Init();
-  }
+        mDoubleReplicator(n, 2 * d) {}
 
   /**
    * @brief Add two shares.
@@ -77,7 +269,9 @@ class ShrManipulator {
    * @param b the second share
    * @return a sharing of the sum of the inputs.
    */
-  Shr Add(const Shr& a, const Shr& b);
+  ShareType Add(const ShareType& a, const ShareType& b) const {
+    return frn::lib::math::vector::Add(a, b);
+  };
 
   /**
    * @brief Add a constant to share.
@@ -85,7 +279,7 @@ class ShrManipulator {
    * @param c the constant
    * @return a share of a + c.
    */
-  Shr AddConstant(const Shr& a, const Field& c);
+  ShareType AddConstant(const ShareType& a, const T& c) const;
 
   /**
    * @brief Add a constant to share.
@@ -93,7 +287,9 @@ class ShrManipulator {
    * @param c the constant
    * @return a share of a + c.
    */
-  Shr AddConstant(const Field& c, const Shr& a) { return AddConstant(a, c); };
+  ShareType AddConstant(const T& c, const ShareType& a) const {
+    return AddConstant(a, c);
+  };
 
   /**
    * @brief Subtract two shares.
@@ -101,7 +297,9 @@ class ShrManipulator {
    * @param b the second share
    * @return a sharing of the difference of the inputs.
    */
-  Shr Subtract(const Shr& a, const Shr& b);
+  ShareType Subtract(const ShareType& a, const ShareType& b) const {
+    return frn::lib::math::vector::Subtract(a, b);
+  };
 
   /**
    * @brief Subtract a constant from a share.
@@ -109,7 +307,7 @@ class ShrManipulator {
    * @param c the constant
    * @return a sharing of a - c.
    */
-  Shr SubtractConstant(const Shr& a, const Field& c);
+  ShareType SubtractConstant(const ShareType& a, const T& c) const;
 
   /**
    * @brief Subtract a constant from a share.
@@ -117,7 +315,7 @@ class ShrManipulator {
    * @param c the constant
    * @return a sharing of c - a.
    */
-  Shr SubtractConstant(const Field& c, const Shr& a);
+  ShareType SubtractConstant(const T& c, const ShareType& a) const;
 
   /**
    * @brief Multiply a constant unto a share.
@@ -125,7 +323,7 @@ class ShrManipulator {
    * @param c the constant
    * @return a sharing of a * c.
    */
-  Shr MultiplyConstant(const Shr& a, const Field& c);
+  ShareType MultiplyConstant(const ShareType& a, const T& c) const;
 
   /**
    * @brief Multiply a constant unto a share.
@@ -133,7 +331,7 @@ class ShrManipulator {
    * @param c the constant
    * @return a sharing of a * c.
    */
-  Shr MultiplyConstant(const Field& c, const Shr& a) {
+  ShareType MultiplyConstant(const T& c, const ShareType& a) const {
     return MultiplyConstant(a, c);
   };
 
@@ -143,7 +341,44 @@ class ShrManipulator {
    * @param b the second share
    * @return a degree 2d share of the product a * b.
    */
-  ShrD MultiplyToDoubleDegree(const Shr& a, const Shr& b);
+  ShareType MultiplyToDoubleDegree(const ShareType& a,
+                                   const ShareType& b) const;
+
+  /**
+   * @brief Locally multiply a batch of pairs of degree d shares.
+   * @param a the first shares
+   * @param b the second shares
+   * @return a batch with degree 2d shares of the products.
+   */
+  BatchType MultiplyToDoubleDegree(const BatchType& a,
+                                   const BatchType& b) const;
+
+  /**
+   * @brief Locally square a degree d share and output a degree 2d share.
+   *
+   * Uses the symmetric table of GetSquareRowsByDest, which evaluates about
+   * half as many products as MultiplyToDoubleDegree(a, a).
+   *
+   * @param a the share
+   * @return a degree 2d share of a * a.
+   */
+  ShareType Square(const ShareType& a) const;
+
+  /**
+   * @brief Locally square a degree d share, and split the square by the party
+   * which is first in the intersection of the factors.
+   * @param a the share
+   * @return the \f$2d + 1\f$ messages of MultiplyToMsgs(a, a).
+   */
+  std::vector<ShareType> SquareToMsgs(const ShareType& a) const;
+
+  /**
+   * @brief Locally square a batch of degree d shares, and split each square
+   * by the party which is first in the intersection of the factors.
+   * @param a the shares
+   * @return a batch of messages laid out as by MultiplyToMsgs(a, a).
+   */
+  BatchType SquareToMsgs(const BatchType& a) const;
 
   /**
    * @brief Locally mulitply two degree d shares to obtain an additive share.
@@ -151,7 +386,72 @@ class ShrManipulator {
    * @param b the second share
    * @return an additive share of the product a * b.
    */
-  Field MultiplyToAdditive(const Shr& a, const Shr& b);
+  T MultiplyToAdditive(const ShareType& a, const ShareType& b) const;
+
+  /**
+   * @brief Locally multiply a batch of pairs of degree d shares, and split
+   * each product by the party which is first in the intersection of the
+   * factors.
+   *
+   * The result has \f$(2d + 1) \cdot s\f$ elements per share, where \f$s\f$
+   * is the size of a degree 2d share. Element \f$p \cdot s + c\f$ is element
+   * \f$c\f$ of the message of party \f$p\f$ used by Mult, and the additive
+   * share of this party is the sum of its own message.
+   *
+   * @param a the first shares
+   * @param b the second shares
+   * @return a batch of messages.
+   */
+  BatchType MultiplyToMsgs(const BatchType& a, const BatchType& b) const;
+
+  /**
+   * @brief Locally multiply two degree d shares, and split the product by the
+   * party which is first in the intersection of the factors.
+   * @param a the first share
+   * @param b the second share
+   * @return the \f$2d + 1\f$ messages used by Mult.
+   */
+  std::vector<ShareType> MultiplyToMsgs(const ShareType& a,
+                                        const ShareType& b) const;
+
+  /**
+   * @brief Locally compute the messages of the inner product of two batches
+   * of degree d shares.
+   *
+   * The messages are the sums over the batch of the messages of MultiplyToMsgs
+   * for each pair of shares, so Mult can reconstruct the inner product as a
+   * single value.
+   *
+   * @param a the first shares
+   * @param b the second shares
+   * @return the \f$2d + 1\f$ messages of \f$\sum_i a_i \cdot b_i\f$.
+   */
+  std::vector<ShareType> DotProductToMsgs(const BatchType& a,
+                                          const BatchType& b) const;
+
+  /**
+   * @brief Locally multiply two matrices of degree d shares, and split each
+   * entry of the product by the party which is first in the intersection of
+   * the factors.
+   *
+   * The shares of an N x P matrix are a batch of N * P shares in row-major
+   * order, so element \f$s\f$ of every share is itself an N x P matrix. Each
+   * message of an entry of the product is a sum of products of such matrices,
+   * which are computed with math::MatMulInto.
+   *
+   * @param a the shares of an N x P matrix
+   * @param b the shares of a P x M matrix
+   * @param rows N
+   * @param inner P
+   * @param cols M
+   * @return the messages of the N * M entries of the product in row-major
+   * order, laid out as the result of MultiplyToMsgs.
+   * @throws std::invalid_argument if the sizes of the batches do not match
+   * the dimensions.
+   */
+  BatchType MatMulToMsgs(const BatchType& a, const BatchType& b,
+                         std::size_t rows, std::size_t inner,
+                         std::size_t cols) const;
 
   /**
    * s whether the current party is among the first n-2d parties in the
@@ -164,17 +464,13 @@ class ShrManipulator {
    * @return index of the set of size n-2d (within this party's replicated
    * share).
    */
-  int ComputeIndexForDoubleMultiplication(std::size_t a, std::size_t b);
-
-  std::vector<MultEntry> GetTableMult() { return mTableMult; }
-
-  std::vector<RecEntry> GetTableRec() { return mTableRec; }
+  int ComputeIndexForDoubleMultiplication(std::size_t a, std::size_t b) const;
 
-  frn::lib::secret_sharing::Replicator<Field> GetReplicator() {
+  const frn::lib::secret_sharing::Replicator<T>& GetReplicator() const {
     return mReplicator;
   }
 
-  frn::lib::secret_sharing::Replicator<Field> GetDoubleReplicator() {
+  const frn::lib::secret_sharing::Replicator<T>& GetDoubleReplicator() const {
     return mDoubleReplicator;
   }
 
@@ -184,37 +480,292 @@ class ShrManipulator {
   std::size_t ShareSize() const { return mReplicator.ShareSize(); };
 
  private:
-  void Init();
+  // evaluate every row of a table over a batch. The batch is processed in
+  // blocks so that the inputs of a block stay in cache across rows.
+  static void EvaluateRows(const MultRows& rows, const BatchType& a,
+                           const BatchType& b, BatchType& out);
 
-  /**
-   * @brief Determines if this party should perform an action during operations
-   * on constants.
-   *
-   * @return An index representing the share element to which a constant should
-   * be added or subtracted. -1 is returned if this party does nothing during
-   * constant operations.
-   */
-  int IndexForConstantOperations();
+  // a share followed by its double, which the tables for squares multiply by.
+  static ShareType WithDouble(const ShareType& a);
 
   std::size_t mPartyId;
   std::size_t mParties;
   std::size_t mThreshold;
 
-  // Tables used by the party to determine which shares to multiply
-  // (and for the case of 2d-shares, where to store them)
-  std::vector<MultEntry> mTableMult;
+  // Auxiliary replicators
+  frn::lib::secret_sharing::Replicator<T> mReplicator;
+  frn::lib::secret_sharing::Replicator<T> mDoubleReplicator;
+};
 
-  // Table used to determine which shares must be sent to which
-  // parties when reconstructing, and when do we send full values or
-  // hashes.
-  std::vector<RecEntry> mTableRec;
+/**
+ * @brief A manipulator of shares over Field.
+ */
+using ShrManipulator = BasicShrManipulator<Field>;
+
+extern template class BasicShrManipulator<Field>;
+
+template <typename T>
+void BasicShrManipulator<T>::EvaluateRows(const MultRows& rows,
+                                          const BatchType& a,
+                                          const BatchType& b, BatchType& out) {
+  for (std::size_t begin = 0; begin < a.Size();
+       begin += details::kBatchBlock) {
+    const auto len =
+        std::min<std::size_t>(details::kBatchBlock, a.Size() - begin);
+    details::EvaluateRows(rows, a.Column(0) + begin, b.Column(0) + begin,
+                          a.Size(), len, out.Column(0) + begin, out.Size());
+  }
+}
 
-  // Auxiliary replicators
-  frn::lib::secret_sharing::Replicator<Field> mReplicator;
-  frn::lib::secret_sharing::Replicator<Field> mDoubleReplicator;
+template <typename T>
+auto BasicShrManipulator<T>::WithDouble(const ShareType& a) -> ShareType {
+  ShareType r(a);
+  r.reserve(2 * a.size());
+  for (const auto& v : a) r.emplace_back(v + v);
+  return r;
+}
 
-  int mIndexForConstantOps;
-};
+template <typename T>
+auto BasicShrManipulator<T>::AddConstant(const ShareType& a, const T& c) const
+    -> ShareType {
+  const auto idx = IndexForConstantOperations();
+  if (idx == -1) return a;
+  ShareType r(a);
+  r[idx] += c;
+  return r;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::SubtractConstant(const ShareType& a,
+                                              const T& c) const -> ShareType {
+  const auto idx = IndexForConstantOperations();
+  if (idx == -1) return a;
+  ShareType r(a);
+  r[idx] -= c;
+  return r;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::SubtractConstant(const T& c,
+                                              const ShareType& a) const
+    -> ShareType {
+  ShareType r;
+  r.reserve(a.size());
+  for (const auto& s : a) r.emplace_back(-s);
+  const auto idx = IndexForConstantOperations();
+  if (idx == -1) return r;
+  r[idx] += c;
+  return r;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::MultiplyConstant(const ShareType& a,
+                                              const T& c) const -> ShareType {
+  ShareType r;
+  r.reserve(a.size());
+  for (const auto& s : a) r.emplace_back(c * s);
+  return r;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::MultiplyToDoubleDegree(const ShareType& a,
+                                                    const ShareType& b) const
+    -> ShareType {
+  const auto& rows = GetRowsByDest();
+  ShareType c;
+  c.reserve(rows.Rows());
+  for (std::size_t r = 0; r < rows.Rows(); r++)
+    c.emplace_back(details::RowSum(rows, r, a, b));
+  return c;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::MultiplyToDoubleDegree(const BatchType& a,
+                                                    const BatchType& b) const
+    -> BatchType {
+  BatchType c(GetRowsByDest().Rows(), a.Size());
+  EvaluateRows(GetRowsByDest(), a, b, c);
+  return c;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::Square(const ShareType& a) const -> ShareType {
+  const auto& rows = GetSquareRowsByDest();
+  const auto b = WithDouble(a);
+  ShareType c;
+  c.reserve(rows.Rows());
+  for (std::size_t r = 0; r < rows.Rows(); r++)
+    c.emplace_back(details::RowSum(rows, r, a, b));
+  return c;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::SquareToMsgs(const ShareType& a) const
+    -> std::vector<ShareType> {
+  const auto& rows = GetSquareRowsByParty();
+  const auto b = WithDouble(a);
+  const auto size = mDoubleReplicator.ShareSize();
+  std::vector<ShareType> msgs(2 * mThreshold + 1, ShareType(size));
+  for (std::size_t r = 0; r < rows.Rows(); r++)
+    msgs[r / size][r % size] = details::RowSum(rows, r, a, b);
+  return msgs;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::SquareToMsgs(const BatchType& a) const
+    -> BatchType {
+  const auto size = a.ShareSize();
+  BatchType b(2 * size, a.Size());
+  std::copy_n(a.Column(0), size * a.Size(), b.Column(0));
+  std::copy_n(a.Column(0), size * a.Size(), b.Column(size));
+  details::AddInto(b.Column(size), a.Column(0), size * a.Size());
+
+  BatchType msgs(GetSquareRowsByParty().Rows(), a.Size());
+  EvaluateRows(GetSquareRowsByParty(), a, b, msgs);
+  return msgs;
+}
+
+template <typename T>
+T BasicShrManipulator<T>::MultiplyToAdditive(const ShareType& a,
+                                             const ShareType& b) const {
+  T c;
+  // only the rows of the messages of this party are summed.
+  if (mPartyId >= 2 * mThreshold + 1) return c;
+  const auto size = mDoubleReplicator.ShareSize();
+  for (std::size_t r = mPartyId * size; r < (mPartyId + 1) * size; r++)
+    c += details::RowSum(GetRowsByParty(), r, a, b);
+  return c;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::MultiplyToMsgs(const ShareType& a,
+                                            const ShareType& b) const
+    -> std::vector<ShareType> {
+  const auto& rows = GetRowsByParty();
+  const auto size = mDoubleReplicator.ShareSize();
+  std::vector<ShareType> msgs(2 * mThreshold + 1, ShareType(size));
+  for (std::size_t r = 0; r < rows.Rows(); r++)
+    msgs[r / size][r % size] = details::RowSum(rows, r, a, b);
+  return msgs;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::MultiplyToMsgs(const BatchType& a,
+                                            const BatchType& b) const
+    -> BatchType {
+  BatchType msgs(GetRowsByParty().Rows(), a.Size());
+  EvaluateRows(GetRowsByParty(), a, b, msgs);
+  return msgs;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::DotProductToMsgs(const BatchType& a,
+                                              const BatchType& b) const
+    -> std::vector<ShareType> {
+  // the messages of each block are computed as by MultiplyToMsgs and added
+  // to those of the first block, so a message is summed across a block only
+  // once at the end.
+  constexpr auto kBlock = details::kBatchBlock;
+  const auto& table = GetRowsByParty();
+  const auto rows = table.Rows();
+  std::vector<T> acc(rows * kBlock);
+  details::EvaluateRows(table, a.Column(0), b.Column(0), a.Size(),
+                        std::min<std::size_t>(kBlock, a.Size()), acc.data(),
+                        kBlock);
+  std::vector<T> block(a.Size() > kBlock ? rows * kBlock : 0);
+  for (std::size_t begin = kBlock; begin < a.Size(); begin += kBlock) {
+    const auto len = std::min<std::size_t>(kBlock, a.Size() - begin);
+    details::EvaluateRows(table, a.Column(0) + begin, b.Column(0) + begin,
+                          a.Size(), len, block.data(), kBlock);
+    for (std::size_t r = 0; r < rows; r++)
+      details::AddInto(acc.data() + r * kBlock, block.data() + r * kBlock,
+                       len);
+  }
+
+  const auto size = mDoubleReplicator.ShareSize();
+  std::vector<ShareType> msgs(2 * mThreshold + 1, ShareType(size));
+  for (std::size_t r = 0; r < rows; r++)
+    msgs[r / size][r % size] = details::Sum(acc.data() + r * kBlock, kBlock);
+  return msgs;
+}
+
+template <typename T>
+auto BasicShrManipulator<T>::MatMulToMsgs(const BatchType& a,
+                                          const BatchType& b,
+                                          std::size_t rows, std::size_t inner,
+                                          std::size_t cols) const
+    -> BatchType {
+  if (a.Size() != rows * inner || b.Size() != inner * cols)
+    throw std::invalid_argument("shares do not match the dimensions");
+
+  using frn::lib::math::MatrixView;
+  const auto left = [&](unsigned element) {
+    return MatrixView<const T>(a.Column(element), rows, inner, inner);
+  };
+
+  // products in a row are sorted by src_a, so the factors of a run of
+  // products with the same src_a are summed before they are multiplied.
+  const auto& table = GetRowsByParty();
+  BatchType msgs(table.Rows(), rows * cols);
+  std::vector<T> right(inner * cols);
+  std::vector<T> product(rows * cols);
+  for (std::size_t r = 0; r < table.Rows(); r++) {
+    const auto end = table.offsets[r + 1];
+    for (auto k = table.offsets[r]; k < end;) {
+      const auto src_a = table.src_a[k];
+      std::copy_n(b.Column(table.src_b[k++]), right.size(), right.begin());
+      for (; k < end && table.src_a[k] == src_a; k++)
+        details::AddInto(right.data(), b.Column(table.src_b[k]),
+                         right.size());
+
+      frn::lib::math::MatMulInto(
+          MatrixView<T>(product.data(), rows, cols, cols), left(src_a),
+          MatrixView<const T>(right.data(), inner, cols, cols));
+      details::AddInto(msgs.Column(r), product.data(), product.size());
+    }
+  }
+  return msgs;
+}
+
+template <typename T>
+int BasicShrManipulator<T>::ComputeIndexForDoubleMultiplication(
+    std::size_t a, std::size_t b) const {
+  // We convert the input indexes from local to global
+  int a_ = mReplicator.IndexSetFor(mPartyId)[a];
+  int b_ = mReplicator.IndexSetFor(mPartyId)[b];
+
+  // We fetch the corresponding input sets
+  std::vector<int> SetA = mReplicator.Combination(a_);
+  std::vector<int> SetB = mReplicator.Combination(b_);
+
+  // Compute the intersection
+  std::vector<int> intersection;
+  frn::lib::secret_sharing::Intersection(SetA, SetB, [&intersection, SetA](int i) {
+    intersection.emplace_back(SetA[i]);
+  });
+
+  // Take the first n-2d elements of the intersection
+  intersection.resize(mParties - 2 * mThreshold);
+
+  // Get the index of this set with the replicator of double degree
+  int target_set = mDoubleReplicator.RevComb(intersection);
+
+  // Check if the current party owns this additive share
+  auto index_set = mDoubleReplicator.IndexSetFor(mPartyId);
+  auto it = find(index_set.begin(), index_set.end(), target_set);
+  int idx;
+
+  // If element was found
+  if (it != index_set.end()) {
+    // calculating the desired index
+    idx = it - index_set.begin();
+  } else {
+    // If the element is not
+    // present in the vector
+    idx = -1;
+  }
+  return idx;
+}
 
 }  // namespace frn
 
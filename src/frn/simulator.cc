@@ -0,0 +1,45 @@
+#include "frn/simulator.h"
+
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+frn::Simulator::Simulator(std::size_t n, frn::lib::net::LinkModel model)
+    : mHub(frn::lib::net::MemoryHub::Create(n, model)) {
+  mNetworks.reserve(n);
+  for (std::size_t i = 0; i < n; i++)
+    mNetworks.emplace_back(TcpNetwork::CreateInMemory(i, mHub));
+}
+
+void frn::Simulator::Run(Party party) {
+  Run(std::vector<Party>(Size(), party));
+}
+
+void frn::Simulator::Run(const std::vector<Party>& parties) {
+  if (parties.size() != Size())
+    throw std::invalid_argument("need exactly one function per party");
+
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  std::vector<std::thread> threads;
+  threads.reserve(Size());
+
+  for (std::size_t i = 0; i < Size(); i++) {
+    threads.emplace_back([&, i]() {
+      try {
+        mNetworks[i]->Connect();
+        parties[i](mNetworks[i]);
+        mNetworks[i]->Flush();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+    });
+  }
+
+  for (auto& thread : threads) thread.join();
+  for (auto& network : mNetworks) network->Close();
+
+  if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,91 @@
+#ifndef _FRN_SIMULATOR_H
+#define _FRN_SIMULATOR_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "frn/lib/net/memory.h"
+#include "frn/tcp_network.h"
+
+namespace frn {
+
+/**
+ * @brief Runs all parties of a protocol as threads in a single process.
+ *
+ * Parties talk through in-memory links which can optionally delay messages
+ * according to a latency and bandwidth model. This makes it cheap to run a
+ * protocol for many different numbers of parties, and to emulate a WAN
+ * deployment on a single machine.
+ *
+ * <code>
+ * frn::Simulator sim(7);
+ * sim.Run([&](std::shared_ptr<frn::TcpNetwork> network) {
+ *   network->Send(0, {frn::Field(network->Id())});
+ *   ...
+ * });
+ * </code>
+ */
+class Simulator {
+ public:
+  /**
+   * @brief Function executed by each party.
+   */
+  using Party = std::function<void(std::shared_ptr<TcpNetwork> network)>;
+
+  /**
+   * @brief Create a simulation of n parties.
+   * @param n the number of parties
+   * @param model the model used for all links between distinct parties
+   */
+  Simulator(std::size_t n,
+            frn::lib::net::LinkModel model = frn::lib::net::LinkModel());
+
+  /**
+   * @brief Change the model of the link from one party to another.
+   * @param from the sender
+   * @param to the receiver
+   * @param model the new model
+   */
+  void SetLinkModel(unsigned from, unsigned to,
+                    frn::lib::net::LinkModel model) {
+    mHub->SetLinkModel(from, to, model);
+  };
+
+  /**
+   * @brief Run a function for every party, each in its own thread.
+   *
+   * Returns once all parties are done. If any party throws, the first
+   * exception is rethrown here after all threads have been joined. Note that
+   * parties waiting for messages from a party that threw will block forever.
+   *
+   * @param party the function to run
+   */
+  void Run(Party party);
+
+  /**
+   * @brief Run a different function for every party.
+   * @param parties one function per party
+   */
+  void Run(const std::vector<Party>& parties);
+
+  /**
+   * @brief Get the network of a particular party.
+   */
+  std::shared_ptr<TcpNetwork> Network(unsigned id) const {
+    return mNetworks[id];
+  };
+
+  /**
+   * @brief The number of parties in the simulation.
+   */
+  std::size_t Size() const { return mNetworks.size(); };
+
+ private:
+  std::shared_ptr<frn::lib::net::MemoryHub> mHub;
+  std::vector<std::shared_ptr<TcpNetwork>> mNetworks;
+};
+
+}  // namespace frn
+
+#endif  // _FRN_SIMULATOR_H
@@ -1,10 +1,17 @@
 #ifndef _FRN_TCP_NETWORK_H
 #define _FRN_TCP_NETWORK_H
 
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <numeric>
+#include <stdexcept>
 
 #include "frn/lib/logging.h"
+#include "frn/lib/math/vec.h"
 #include "frn/lib/net/builder.h"
+#include "frn/lib/net/multiplexer.h"
 #include "frn/lib/net/network.h"
 #include "frn/network.h"
 
@@ -12,6 +19,18 @@ namespace frn {
 
 class TcpNetwork final : public Network {
  public:
+  /**
+   * @brief Messages to a party are combined until this many bytes are
+   * pending, or until the next receive.
+   */
+  static constexpr std::size_t kWriteBufferSize = 1 << 16;
+
+  /**
+   * @brief Networks created by the factories below use packed encoding if
+   * this environment variable is set to something other than 0.
+   */
+  static constexpr const char* kPackedEnvVariable = "FRN_PACKED";
+
   /**
    * @brief Create a TCP network where all parties run on localhost.
    * @param id the ID of this party
@@ -27,12 +46,47 @@ class TcpNetwork final : public Network {
                   .TransportType(frn::lib::net::Network::TransportType::eTcp)
                   .Size(n)
                   .BasePort(base_port)
-                  .AllPartiesLocal();
+                  .AllPartiesLocal()
+                  .WriteBufferSize(kWriteBufferSize);
     if (with_logger) builder = builder.Logger(logger);
     frn::lib::secret_sharing::Replicator<Field> rep(n, (n - 1) / 3);
     if (with_logger) logger->Info("created network for %", id);
-    return std::shared_ptr<TcpNetwork>(
-        new TcpNetwork(id, n, builder.Build(), logger, rep));
+    auto network = std::make_shared<frn::lib::net::Network>(builder.Build());
+    auto tcp_network = std::shared_ptr<TcpNetwork>(
+        new TcpNetwork(id, n, network, logger, rep));
+    tcp_network->SetPacked(PackedFromEnvironment());
+    return tcp_network;
+  };
+
+  /**
+   * @brief Create a network where all parties run in the same process.
+   *
+   * Instead of sockets, parties talk through the in-memory links of a shared
+   * hub. This is mostly useful for tests and benchmarks.
+   *
+   * @param id the ID of this party
+   * @param hub the links shared by all parties
+   * @param with_logger whether to log stuff for the underlying network
+   */
+  static std::shared_ptr<TcpNetwork> CreateInMemory(
+      unsigned id, std::shared_ptr<frn::lib::net::MemoryHub> hub,
+      bool with_logger = false) {
+    auto n = hub->Size();
+    auto logger =
+        frn::lib::logging::create_logger<frn::lib::logging::StdoutLogger>(true);
+    auto builder = frn::lib::net::Network::Builder();
+    builder = builder.LocalPeerId(id)
+                  .TransportType(frn::lib::net::Network::TransportType::eMemory)
+                  .Size(n)
+                  .Hub(hub)
+                  .WriteBufferSize(kWriteBufferSize);
+    if (with_logger) builder = builder.Logger(logger);
+    frn::lib::secret_sharing::Replicator<Field> rep(n, (n - 1) / 3);
+    auto network = std::make_shared<frn::lib::net::Network>(builder.Build());
+    auto tcp_network = std::shared_ptr<TcpNetwork>(
+        new TcpNetwork(id, n, network, logger, rep));
+    tcp_network->SetPacked(PackedFromEnvironment());
+    return tcp_network;
   };
 
   TcpNetwork() = delete;
@@ -41,11 +95,104 @@ class TcpNetwork final : public Network {
 
   };
 
-  void Connect() { mNetwork.Connect(); };
+  /**
+   * @brief Connect to all parties. Has no effect on a session.
+   */
+  void Connect() {
+    if (!mSession) mNetwork->Connect();
+  };
+
+  /**
+   * @brief Close the network. Has no effect on a session.
+   *
+   * Calls Demultiplex if sessions are still in use.
+   */
+  void Close() {
+    if (mSession) return;
+    Demultiplex();
+    mNetwork->Close();
+  };
+
+  /**
+   * @brief Allow running several sessions over this network concurrently.
+   *
+   * After this call, all messages carry a session ID, including messages sent
+   * through this network which belong to session 0. All parties must call
+   * Multiplex at the same point, after having called Connect.
+   */
+  void Multiplex() {
+    if (mSession) throw std::logic_error("cannot multiplex a session");
+    if (mMultiplexer) return;
+    mNetwork->Flush();
+    mMultiplexer = std::make_shared<frn::lib::net::Multiplexer>(mNetwork);
+    mMultiplexer->Start();
+  };
+
+  /**
+   * @brief Stop using sessions.
+   *
+   * Waits until all parties have called Demultiplex, after which messages are
+   * no longer framed. Session networks must not be used after this call.
+   */
+  void Demultiplex() {
+    if (mSession) throw std::logic_error("cannot demultiplex a session");
+    if (!mMultiplexer) return;
+    mMultiplexer->Stop();
+    mMultiplexer.reset();
+  };
 
-  void Close() { mNetwork.Close(); };
+  /**
+   * @brief Get a network for a particular session.
+   *
+   * Sessions behave like independent networks between the same parties, and
+   * can be used from different threads at the same time. Each session keeps
+   * its own communication summary.
+   *
+   * @param session a session ID. 0 is reserved for this network.
+   * @throws std::logic_error if Multiplex has not been called, or if session
+   *   is 0.
+   */
+  std::shared_ptr<TcpNetwork> Session(std::uint32_t session) {
+    if (!mMultiplexer) throw std::logic_error("network is not multiplexed");
+    if (!session) throw std::logic_error("session 0 is reserved");
+    auto network = std::shared_ptr<TcpNetwork>(
+        new TcpNetwork(Id(), Size(), mNetwork, mLogger, mReplicator));
+    network->mMultiplexer = mMultiplexer;
+    network->mSession = session;
+    network->mPacked = mPacked;
+    return network;
+  };
+
+  /**
+   * @brief Send field elements using only <code>Field::PackedBitSize()</code>
+   * bits each, e.g., 61 instead of 64 bits for Mp61.
+   *
+   * All parties must use the same setting. Sessions created after this call
+   * inherit it.
+   */
+  void SetPacked(bool packed) { mPacked = packed; };
+
+  /**
+   * @brief Whether field elements are sent packed.
+   */
+  bool Packed() const { return mPacked; };
+
+  /**
+   * @brief Whether kPackedEnvVariable asks for packed encoding.
+   */
+  static bool PackedFromEnvironment() {
+    const char* value = std::getenv(kPackedEnvVariable);
+    return value && *value && std::strcmp(value, "0") != 0;
+  };
 
   void Send(unsigned id, const std::vector<Field>& values) override {
+    if (mPacked) {
+      auto n = frn::lib::math::vector::PackedByteSize<Field>(values.size());
+      auto buffer = std::make_unique<unsigned char[]>(n);
+      frn::lib::math::vector::ToPackedBytes(buffer.get(), values);
+      SendRaw(id, buffer.get(), n);
+      return;
+    }
     auto n = values.size() * Field::ByteSize();
     auto buffer = std::make_unique<unsigned char[]>(n);
     auto ptr = buffer.get();
@@ -53,25 +200,42 @@ class TcpNetwork final : public Network {
       v.ToBytes(ptr);
       ptr += Field::ByteSize();
     }
-    mSummary.Send(id, n);
-    mNetwork.SendTo(id, buffer.get(), n);
+    SendRaw(id, buffer.get(), n);
   };
 
   void SendShares(unsigned id, const std::vector<Shr>& shares) override {
-    for (const auto& shr : shares)
-      Send(id, static_cast<const std::vector<Field>>(shr));
+    // shares are packed one at a time, as RecvShares receives them.
+    if (mPacked) {
+      for (const auto& shr : shares) Send(id, shr);
+      return;
+    }
+    std::size_t n = 0;
+    for (const auto& shr : shares) n += shr.size() * Field::ByteSize();
+    auto buffer = std::make_unique<unsigned char[]>(n);
+    auto ptr = buffer.get();
+    for (const auto& shr : shares) {
+      for (const auto& v : shr) {
+        v.ToBytes(ptr);
+        ptr += Field::ByteSize();
+      }
+    }
+    SendRaw(id, buffer.get(), n);
   };
 
   void SendBytes(unsigned id, const std::vector<unsigned char>& data) override {
-    mSummary.Send(id, data.size());
-    mNetwork.SendTo(id, data.data(), data.size());
+    SendRaw(id, data.data(), data.size());
   };
 
   std::vector<Field> Recv(unsigned id, std::size_t n) override {
+    if (mPacked) {
+      auto m = frn::lib::math::vector::PackedByteSize<Field>(n);
+      auto buffer = std::make_unique<unsigned char[]>(m);
+      RecvRaw(id, buffer.get(), m);
+      return frn::lib::math::vector::FromPackedBytes<Field>(buffer.get(), n);
+    }
     auto m = n * Field::ByteSize();
     auto buffer = std::make_unique<unsigned char[]>(m);
-    mSummary.Recv(id, m);
-    mNetwork.RecvFrom(id, buffer.get(), m);
+    RecvRaw(id, buffer.get(), m);
     std::vector<Field> values;
     values.reserve(n);
     auto ptr = buffer.get();
@@ -93,17 +257,55 @@ class TcpNetwork final : public Network {
 
   std::vector<unsigned char> RecvBytes(unsigned id, std::size_t n) override {
     std::vector<unsigned char> r(n);
-    mSummary.Recv(id, n);
-    mNetwork.RecvFrom(id, r.data(), n);
+    RecvRaw(id, r.data(), n);
     return r;
   };
 
+  void Flush() override {
+    // sessions flush every message.
+    if (!mMultiplexer) mNetwork->Flush();
+  };
+
   void PrintCommunicationSummary() const {
     std::cout << "communication summary for " << this->Id() << ":\n";
     mSummary.Print();
     std::cout << "\n";
   };
 
+  /**
+   * @brief Total number of bytes sent to other parties.
+   */
+  std::size_t BytesSent() const { return mSummary.Sent(); };
+
+  /**
+   * @brief Total number of bytes received from other parties.
+   */
+  std::size_t BytesReceived() const { return mSummary.Received(); };
+
+  /**
+   * @brief Number of bytes sent to a particular party.
+   */
+  std::size_t BytesSentTo(unsigned id) const { return mSummary.Sent(id); };
+
+  /**
+   * @brief Number of bytes received from a particular party.
+   */
+  std::size_t BytesReceivedFrom(unsigned id) const {
+    return mSummary.Received(id);
+  };
+
+  /**
+   * @brief Number of communication rounds, i.e., the number of times this
+   * party started receiving after having sent something.
+   */
+  std::size_t Rounds() const { return mSummary.Rounds(); };
+
+  /**
+   * @brief Reset the communication summary, e.g., between repetitions of an
+   * experiment.
+   */
+  void ResetCommunicationSummary() { mSummary = Summary(Size()); };
+
  private:
   class Summary {
    public:
@@ -115,6 +317,22 @@ class TcpNetwork final : public Network {
 
     void Recv(unsigned id, std::size_t n) { mRecv[id] += n; };
 
+    void Round() { mRounds++; };
+
+    std::size_t Sent(unsigned id) const { return mSent[id]; };
+
+    std::size_t Received(unsigned id) const { return mRecv[id]; };
+
+    std::size_t Sent() const {
+      return std::accumulate(mSent.begin(), mSent.end(), std::size_t(0));
+    };
+
+    std::size_t Received() const {
+      return std::accumulate(mRecv.begin(), mRecv.end(), std::size_t(0));
+    };
+
+    std::size_t Rounds() const { return mRounds; };
+
     void Print() const {
       for (std::size_t i = 0; i < mSent.size(); i++) {
         if (mSent[i] && mRecv[i]) {
@@ -133,23 +351,59 @@ class TcpNetwork final : public Network {
    private:
     std::vector<std::size_t> mSent;
     std::vector<std::size_t> mRecv;
+    std::size_t mRounds = 0;
   };
 
-  TcpNetwork(unsigned id, std::size_t n, frn::lib::net::Network&& network,
+  TcpNetwork(unsigned id, std::size_t n,
+             std::shared_ptr<frn::lib::net::Network> network,
              std::shared_ptr<frn::lib::logging::Logger> logger,
-             frn::lib::secret_sharing::Replicator<Field>& replicator)
+             const frn::lib::secret_sharing::Replicator<Field>& replicator)
       : Network(id, n),
-        mNetwork(std::move(network)),
+        mNetwork(network),
         mLogger(logger),
         mReplicator(replicator),
         mSummary(Summary(n)){};
 
-  frn::lib::net::Network mNetwork;
+  void SendRaw(unsigned id, const unsigned char* data, std::size_t n) {
+    mSummary.Send(id, n);
+    TRACE_COUNT(eBytesSent, n);
+    mSentSinceRecv = true;
+    if (mMultiplexer)
+      mMultiplexer->SendTo(mSession, id, data, n);
+    else
+      mNetwork->SendTo(id, data, n);
+  };
+
+  void RecvRaw(unsigned id, unsigned char* buffer, std::size_t n) {
+    mSummary.Recv(id, n);
+    TRACE_COUNT(eBytesReceived, n);
+    // a round is a batch of sends followed by waiting for messages.
+    if (mSentSinceRecv) {
+      mSummary.Round();
+      TRACE_COUNT(eRounds, 1);
+      mSentSinceRecv = false;
+    }
+    if (mMultiplexer) {
+      mMultiplexer->RecvFrom(mSession, id, buffer, n);
+    } else {
+      // a receive ends a round, and the sender may be waiting for us.
+      mNetwork->Flush();
+      mNetwork->RecvFrom(id, buffer, n);
+    }
+  };
+
+  std::shared_ptr<frn::lib::net::Network> mNetwork;
   std::shared_ptr<frn::lib::logging::Logger> mLogger;
   frn::lib::secret_sharing::Replicator<Field> mReplicator;
   Summary mSummary;
+  std::shared_ptr<frn::lib::net::Multiplexer> mMultiplexer;
+  std::uint32_t mSession = 0;
+  bool mSentSinceRecv = false;
+  bool mPacked = false;
 };
 
+constexpr std::size_t TcpNetwork::kWriteBufferSize;
+
 }  // namespace frn
 
 #endif /* _FRN_TCP_NETWORK_H */
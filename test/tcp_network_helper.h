@@ -16,6 +16,25 @@
         __i, __n, __base_port, __i == 0));                           \
   }
 
+/**
+ * @brief Initialize parties which talk through in-memory links.
+ *
+ * Works exactly like CREATE_PARTIES, but without opening any sockets.
+ *
+ * @param __n the number of parties.
+ */
+#define CREATE_SIMULATED_PARTIES(__n)                                  \
+  const std::size_t __nparties = __n;                                  \
+  std::vector<std::shared_ptr<frn::TcpNetwork>> __networks;            \
+  std::vector<unsigned> __ids;                                         \
+  std::vector<std::thread> __parties;                                  \
+  auto __hub = frn::lib::net::MemoryHub::Create(__n);                  \
+  for (std::size_t __i = 0; __i < __n; __i++) {                        \
+    __ids.emplace_back(__i);                                           \
+    __networks.emplace_back(frn::TcpNetwork::CreateInMemory(__i, __hub)); \
+  }                                                                    \
+  __parties.reserve(__n);
+
 /**
  * @brief Define how a particular player should act.
  *
@@ -52,6 +71,7 @@
   auto network = __networks[my_id];             \
   network->Connect();
 #define END_PLAYER_DEF(__id) \
+  network->Flush();          \
   });                        \
   }                          \
   while (0)
@@ -2,6 +2,9 @@
 #include <thread>
 
 #include "frn/check.h"
+#include "frn/lib/math/extension.h"
+#include "frn/lib/math/galois.h"
+#include "frn/lib/math/z2k.h"
 #include "frn/shr.h"
 #include "frn/tcp_network.h"
 #include "frn/util.h"
@@ -120,3 +123,207 @@ TEST_CASE("check-preliminar") {
 
   CLEANUP();
 }
+
+TEST_CASE("check with matrix products") {
+  const std::size_t n = 4;
+  const std::size_t d = (n - 1) / 3;
+  const std::size_t rows = 2, inner = 5, cols = 3;
+  frn::lib::primitives::PRG prg;
+  std::vector<frn::Field> xs, ys;
+  for (std::size_t i = 0; i < rows * inner; i++) xs.emplace_back(i + 1);
+  for (std::size_t i = 0; i < inner * cols; i++) ys.emplace_back(3 * i + 2);
+  auto rep = frn::lib::secret_sharing::Replicator<frn::Field>(n, d);
+  auto shr_xs = rep.Share(xs, prg);
+  auto shr_ys = rep.Share(ys, prg);
+
+  CREATE_PARTIES(n, 13100);
+
+  std::vector<std::vector<frn::Shr>> output_shares(n);
+
+  for (std::size_t i = 0; i < n; i++) {
+    BEGIN_PLAYER_DEF(i) {
+      auto corr = frn::Correlator(my_id, rep);
+      auto mani = frn::ShrManipulator(my_id, d, n);
+      auto checkdata = frn::CheckData(d);
+      frn::Mult multp(network, rep, mani, corr, checkdata);
+
+      // a product of shares next to a matrix product.
+      multp.Prepare(shr_xs[my_id][0], shr_ys[my_id][0]);
+      multp.PrepareMatMul(shr_xs[my_id], shr_ys[my_id], rows, inner, cols);
+      output_shares[my_id] = multp.Run();
+
+      frn::Check checkp(network, rep, mani, checkdata);
+      checkp.ComputeRandomCoefficients();
+      checkp.PrepareLinearCombinations();
+      checkp.PrepareMsgs();
+      checkp.ReconstructMsgs();
+    }
+    END_PLAYER_DEF(i);
+  }
+
+  CLEANUP();
+
+  std::vector<frn::Shr> shares(n);
+  for (std::size_t p = 0; p < n; p++) shares[p] = output_shares[p][0];
+  REQUIRE(rep.Reconstruct(shares) == xs[0] * ys[0]);
+  for (std::size_t i = 0; i < rows; i++) {
+    for (std::size_t j = 0; j < cols; j++) {
+      frn::Field expected(0);
+      for (std::size_t k = 0; k < inner; k++)
+        expected += xs[i * inner + k] * ys[k * cols + j];
+      for (std::size_t p = 0; p < n; p++)
+        shares[p] = output_shares[p][1 + i * cols + j];
+      REQUIRE(rep.Reconstruct(shares) == expected);
+    }
+  }
+}
+
+// runs Mult and Check over T with coefficients in E, and checks both the
+// products and that the compressed messages are a share of the random linear
+// combination of the products.
+template <typename T, typename E>
+void CheckProductsAndCompression(unsigned base_port) {
+  const std::size_t n = 4;
+  const std::size_t d = (n - 1) / 3;
+  const std::size_t m = 5;
+  const std::size_t rows = 2, inner = 3, cols = 2;
+  frn::lib::primitives::PRG prg;
+  std::vector<T> xs, ys;
+  for (std::size_t i = 0; i < rows * inner; i++) xs.emplace_back(-T(i + 1));
+  for (std::size_t i = 0; i < inner * cols; i++) ys.emplace_back(3 * i + 2);
+  frn::lib::secret_sharing::Replicator<T> rep(n, d);
+  auto shr_xs = rep.Share(xs, prg);
+  auto shr_ys = rep.Share(ys, prg);
+
+  CREATE_PARTIES(n, base_port);
+
+  std::vector<std::vector<std::vector<T>>> output_shares(n);
+  std::vector<std::vector<E>> coefficients(n);
+  std::vector<std::vector<std::vector<E>>> compressed_msgs(n);
+
+  for (std::size_t i = 0; i < n; i++) {
+    BEGIN_PLAYER_DEF(i) {
+      frn::BasicCorrelator<T> corr(my_id, rep);
+      frn::BasicShrManipulator<T> mani(my_id, d, n);
+      frn::BasicCheckData<T> checkdata(d);
+      frn::BasicMult<T> multp(network, rep, mani, corr, checkdata);
+
+      // products of single shares next to a matrix product.
+      std::vector<std::vector<T>> as(shr_xs[my_id].begin(),
+                                     shr_xs[my_id].begin() + m);
+      std::vector<std::vector<T>> bs(shr_ys[my_id].begin(),
+                                     shr_ys[my_id].begin() + m);
+      multp.Prepare(as, bs);
+      multp.PrepareMatMul(shr_xs[my_id], shr_ys[my_id], rows, inner, cols);
+      output_shares[my_id] = multp.Run();
+
+      frn::BasicCheck<T, E> checkp(network, rep, mani, checkdata);
+      checkp.ComputeRandomCoefficients();
+      checkp.PrepareLinearCombinations();
+      checkp.PrepareMsgs();
+      checkp.ReconstructMsgs();
+      coefficients[my_id] = checkp.GetRandomCoefficients();
+      compressed_msgs[my_id] = checkp.GetCompressedCheckData().msgs;
+    }
+    END_PLAYER_DEF(i);
+  }
+
+  CLEANUP();
+
+  std::vector<T> products;
+  for (std::size_t i = 0; i < m; i++) products.emplace_back(xs[i] * ys[i]);
+  for (std::size_t i = 0; i < rows; i++) {
+    for (std::size_t j = 0; j < cols; j++) {
+      T entry;
+      for (std::size_t k = 0; k < inner; k++)
+        entry += xs[i * inner + k] * ys[k * cols + j];
+      products.emplace_back(entry);
+    }
+  }
+
+  std::vector<std::vector<T>> shares(n);
+  for (std::size_t i = 0; i < products.size(); i++) {
+    for (std::size_t p = 0; p < n; p++) shares[p] = output_shares[p][i];
+    REQUIRE(rep.Reconstruct(shares) == products[i]);
+  }
+
+  // the messages of all the parties sum to a degree 2d share of each
+  // product, so the compressed messages sum to a share of the combination.
+  REQUIRE(coefficients[0].size() == products.size());
+  E expected;
+  for (std::size_t i = 0; i < products.size(); i++)
+    expected += coefficients[0][i] * E(products[i]);
+
+  frn::lib::secret_sharing::Replicator<E> double_rep(n, 2 * d);
+  std::vector<std::vector<E>> combined(n);
+  for (std::size_t p = 0; p < n; p++) {
+    REQUIRE(coefficients[p] == coefficients[0]);
+    combined[p] = compressed_msgs[p][0];
+    for (std::size_t q = 1; q < 2 * d + 1; q++)
+      for (std::size_t c = 0; c < combined[p].size(); c++)
+        combined[p][c] += compressed_msgs[p][q][c];
+  }
+  REQUIRE(double_rep.Reconstruct(combined) == expected);
+}
+
+TEST_CASE("check over Z2k with Galois ring coefficients") {
+  using Z64 = frn::lib::math::Z2kElement<64>;
+  using GR = frn::lib::math::GaloisRingElement<64, 32>;
+  CheckProductsAndCompression<Z64, GR>(13200);
+}
+
+TEST_CASE("check over Mp31 with extension coefficients") {
+  using Mp31 = frn::lib::math::FpElement<frn::lib::math::Mp31>;
+  using Ext = frn::lib::math::FpExtension<frn::lib::math::Mp31, 3>;
+  CheckProductsAndCompression<Mp31, Ext>(13300);
+}
+
+// the bytes each party sends when multiplying m pairs of shares over T
+// without packing.
+template <typename T>
+std::vector<std::size_t> MultBytesSent(unsigned base_port, std::size_t m) {
+  const std::size_t n = 4;
+  const std::size_t d = (n - 1) / 3;
+  frn::lib::primitives::PRG prg;
+  std::vector<T> xs;
+  for (std::size_t i = 0; i < m; i++) xs.emplace_back(i + 1);
+  frn::lib::secret_sharing::Replicator<T> rep(n, d);
+  auto shr_xs = rep.Share(xs, prg);
+
+  CREATE_PARTIES(n, base_port);
+  for (auto& network : __networks) network->SetPacked(false);
+
+  for (std::size_t i = 0; i < n; i++) {
+    BEGIN_PLAYER_DEF(i) {
+      frn::BasicCorrelator<T> corr(my_id, rep);
+      frn::BasicShrManipulator<T> mani(my_id, d, n);
+      frn::BasicCheckData<T> checkdata(d);
+      frn::BasicMult<T> multp(network, rep, mani, corr, checkdata);
+      multp.Prepare(shr_xs[my_id], shr_xs[my_id]);
+      multp.Run();
+    }
+    END_PLAYER_DEF(i);
+  }
+
+  CLEANUP();
+
+  std::vector<std::size_t> sent;
+  for (const auto& network : __networks) sent.emplace_back(network->BytesSent());
+  return sent;
+}
+
+TEST_CASE("mult over Mp31 sends half the bytes of Mp61") {
+  using Mp31 = frn::lib::math::FpElement<frn::lib::math::Mp31>;
+  const std::size_t n = 4;
+  const std::size_t d = (n - 1) / 3;
+  const std::size_t m = 100;
+  const auto sent_mp61 = MultBytesSent<frn::Field>(13400, m);
+  const auto sent_mp31 = MultBytesSent<Mp31>(13500, m);
+
+  // parties in U send mSharesToSendP1 to P1, which sends mValuesSentFromP1
+  // to the n - d parties in T.
+  REQUIRE(sent_mp61[0] == (1 + n - d) * m * frn::Field::ByteSize());
+  for (std::size_t p = 1; p < n; p++)
+    REQUIRE(sent_mp61[p] == (p < 2 * d + 1 ? m * frn::Field::ByteSize() : 0));
+  for (std::size_t p = 0; p < n; p++) REQUIRE(2 * sent_mp31[p] == sent_mp61[p]);
+}
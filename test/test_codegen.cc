@@ -0,0 +1,88 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+
+#include "frn/codegen.h"
+#include "frn/generated.h"
+
+using namespace frn;
+
+// the additive share and messages as computed by Mult from the table.
+static void reference(ShrManipulator& manipulator, std::size_t id,
+                      const Shr& a, const Shr& b, Field& add_share,
+                      std::vector<Shr>& msgs) {
+  add_share = Field(0);
+  for (const auto& entry : manipulator.GetTableMult()) {
+    const auto prod = a[entry.src_a] * b[entry.src_b];
+    msgs[entry.first_party][entry.dest_c] += prod;
+    if (id == entry.first_party) add_share += prod;
+  }
+}
+
+static std::size_t count(const std::string& haystack,
+                         const std::string& needle) {
+  std::size_t c = 0;
+  for (auto pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + 1))
+    c++;
+  return c;
+}
+
+TEST_CASE("generated kernels match table") {
+  std::size_t configurations = 0;
+  for (std::size_t n = 4; n <= 10; n++) {
+    const std::size_t t = (n - 1) / 3;
+    if (!FindGeneratedMultiplyKernel(n, t, 0)) continue;
+    configurations++;
+
+    frn::lib::primitives::PRG prg;
+    auto replicator = CreateReplicator(n);
+    // values close to the prime make sure the delayed reduction is correct.
+    auto xs = replicator.Share(Field(frn::lib::math::Mp61::kPrime - 1), prg);
+    auto ys = replicator.Share(Field(frn::lib::math::Mp61::kPrime - 3), prg);
+
+    for (std::size_t id = 0; id < n; id++) {
+      INFO("n = " << n << ", party " << id);
+      ShrManipulator manipulator(id, t, n);
+      const auto double_size = manipulator.GetDoubleReplicator().ShareSize();
+
+      std::vector<Shr> expected_msgs(2 * t + 1, Shr(double_size, Field(0)));
+      Field expected_add;
+      reference(manipulator, id, xs[id], ys[id], expected_add, expected_msgs);
+
+      std::vector<Shr> msgs(2 * t + 1, Shr(double_size, Field(0)));
+      Field add;
+      auto kernel = FindGeneratedMultiplyKernel(n, t, id);
+      REQUIRE(kernel != nullptr);
+      kernel(xs[id], ys[id], add, msgs);
+      REQUIRE(msgs == expected_msgs);
+      REQUIRE(add == expected_add);
+      REQUIRE(FindMultiplyKernel(n, t, id) == kernel);
+    }
+  }
+  REQUIRE(configurations > 0);
+  REQUIRE(FindGeneratedMultiplyKernel(7, 1, 0) == nullptr);
+}
+
+TEST_CASE("generated kernels group factors") {
+  std::stringstream ss;
+  WriteMultiplyKernel(ss, 7, 0);
+  const auto code = ss.str();
+  REQUIRE(code.find("static void mult_7_0(") != std::string::npos);
+
+  ShrManipulator manipulator(0, 2, 7);
+  const auto products = manipulator.GetTableMult().size();
+  const auto multiplications = count(code, "MulFold(");
+  // products with a common factor share a multiplication.
+  REQUIRE(multiplications > 0);
+  REQUIRE(multiplications < products);
+}
+
+TEST_CASE("generated translation unit") {
+  std::stringstream ss;
+  WriteMultiplyKernels(ss, {4});
+  const auto code = ss.str();
+  for (std::size_t id = 0; id < 4; id++)
+    REQUIRE(code.find("mult_4_" + std::to_string(id) + "(") !=
+            std::string::npos);
+  REQUIRE(code.find("FindGeneratedMultiplyKernel") != std::string::npos);
+}
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+
+#include "frn/cost.h"
+#include "frn/experiment.h"
+#include "frn/simulator.h"
+
+static void CheckPrediction(frn::ExperimentType type, std::size_t n,
+                            std::size_t size, bool packed = false) {
+  std::vector<frn::Measurement> measurements(n);
+
+  frn::Simulator sim(n);
+  sim.Run([&](std::shared_ptr<frn::TcpNetwork> network) {
+    network->SetPacked(packed);
+    frn::Experiment experiment(type, network);
+    measurements[network->Id()] = experiment.Run(size);
+  });
+
+  frn::CostModel model(n, packed);
+  std::size_t rounds = 0;
+  for (std::size_t id = 0; id < n; id++) {
+    auto cost = frn::PredictCost(type, model, id, size);
+    REQUIRE(cost.sent == measurements[id].sent);
+    REQUIRE(cost.received == measurements[id].received);
+    REQUIRE(cost.BytesSent() == measurements[id].bytes_sent);
+    rounds = std::max(rounds, measurements[id].rounds);
+    REQUIRE(rounds <= cost.rounds);
+  }
+  REQUIRE(rounds == frn::PredictCost(type, model, 0, size).rounds);
+}
+
+TEST_CASE("cost model") {
+  for (std::size_t n : {4, 5, 7}) {
+    CheckPrediction(frn::ExperimentType::eInput, n, 50);
+    CheckPrediction(frn::ExperimentType::eMult, n, 50);
+    CheckPrediction(frn::ExperimentType::eCheck, n, 50);
+  }
+}
+
+TEST_CASE("cost model with packed elements") {
+  for (std::size_t n : {4, 7}) {
+    CheckPrediction(frn::ExperimentType::eInput, n, 50, true);
+    CheckPrediction(frn::ExperimentType::eMult, n, 50, true);
+    CheckPrediction(frn::ExperimentType::eCheck, n, 50, true);
+  }
+
+  // 61 instead of 64 bits per element.
+  frn::CostModel plain(4), packed(4, true);
+  REQUIRE(packed.Mult(0, 1000).BytesSent() * 64 ==
+          plain.Mult(0, 1000).BytesSent() * 61);
+}
+
+TEST_CASE("cost model totals") {
+  // everything sent is received by someone.
+  frn::CostModel model(10);
+  std::size_t sent = 0, received = 0;
+  for (unsigned id = 0; id < model.Size(); id++) {
+    auto cost = model.Mult(id, 1000);
+    cost += model.Check(id);
+    sent += cost.BytesSent();
+    received += cost.BytesReceived();
+    REQUIRE(cost.rounds == 3);
+  }
+  REQUIRE(sent == received);
+}
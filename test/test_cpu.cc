@@ -0,0 +1,271 @@
+#include <catch2/catch.hpp>
+
+#include "frn/lib/cpu.h"
+#include "frn/lib/math/fp.h"
+#include "frn/lib/math/kernels.h"
+#include "frn/lib/math/p.h"
+#include "frn/lib/math/vec.h"
+#include "frn/lib/primitives/hash.h"
+#include "frn/lib/primitives/prg.h"
+
+using Level = frn::lib::cpu::Level;
+using Field = frn::lib::math::FpElement<frn::lib::math::Mp61>;
+using Field31 = frn::lib::math::FpElement<frn::lib::math::Mp31>;
+using Field127 = frn::lib::math::FpElement<frn::lib::math::Mp127>;
+namespace vec = frn::lib::math::vector;
+
+static std::vector<Level> supported_levels() {
+  std::vector<Level> levels;
+  for (auto level :
+       {Level::eGeneric, Level::eSse42, Level::eAvx2, Level::eAvx512})
+    if (level <= frn::lib::cpu::Detect()) levels.emplace_back(level);
+  return levels;
+}
+
+// includes values close to the prime, which exercise the reductions.
+template <typename T = Field>
+static std::vector<T> test_values(std::size_t n, unsigned char seed) {
+  unsigned char key[frn::lib::primitives::PRG::SeedSize()] = {seed};
+  frn::lib::primitives::PRG prg(key);
+  std::vector<T> values;
+  for (std::size_t i = 0; i < n; i++) {
+    typename T::ValueType v;
+    prg.Next((unsigned char*)&v, sizeof(v));
+    if (i % 5 == 0)
+      values.emplace_back(-T(1 + i));
+    else
+      values.emplace_back(T(v));
+  }
+  return values;
+}
+
+TEST_CASE("cpu level names") {
+  for (auto level : supported_levels())
+    REQUIRE(frn::lib::cpu::ParseLevel(frn::lib::cpu::ToString(level)) ==
+            level);
+  REQUIRE_THROWS_AS(frn::lib::cpu::ParseLevel("mmx"), std::invalid_argument);
+}
+
+TEST_CASE("cpu override is capped by host") {
+  const auto before = frn::lib::cpu::Current();
+  REQUIRE(frn::lib::cpu::Override(Level::eAvx512) == frn::lib::cpu::Detect());
+  REQUIRE(frn::lib::cpu::Override(Level::eGeneric) == Level::eGeneric);
+  REQUIRE(frn::lib::cpu::Current() == Level::eGeneric);
+  frn::lib::cpu::Override(before);
+}
+
+TEST_CASE("cpu levels agree on PRG and hash") {
+  const auto before = frn::lib::cpu::Current();
+  std::vector<unsigned char> data(1000, 0x42);
+
+  std::vector<unsigned char> stream;
+  frn::lib::primitives::SHA3_256::DigestType digest;
+  bool first = true;
+  for (auto level : supported_levels()) {
+    frn::lib::cpu::Override(level);
+    frn::lib::primitives::PRG prg;
+    // odd sizes test the partial blocks between calls.
+    std::vector<unsigned char> bytes(13 + 1031);
+    prg.Next(bytes.data(), 13);
+    prg.Next(bytes.data() + 13, 1031);
+
+    frn::lib::primitives::Hash<frn::lib::primitives::SHA3_256> hash;
+    hash.Update(data.data(), data.size());
+    auto d = hash.Finalize();
+
+    if (first) {
+      stream = bytes;
+      digest = d;
+      first = false;
+    }
+    INFO(frn::lib::cpu::ToString(level));
+    REQUIRE(bytes == stream);
+    REQUIRE(d == digest);
+  }
+  frn::lib::cpu::Override(before);
+}
+
+TEST_CASE("cpu levels agree on Mp61 kernels") {
+  // 37 is not a multiple of any vector width, so the tails are tested too.
+  const std::size_t n = 37;
+  const auto x = test_values(n, 1);
+  const auto y = test_values(n, 2);
+
+  std::vector<Field> sum, difference, product;
+  Field dot;
+  for (std::size_t i = 0; i < n; i++) {
+    sum.emplace_back(x[i] + y[i]);
+    difference.emplace_back(x[i] - y[i]);
+    product.emplace_back(x[i] * y[i]);
+    dot += x[i] * y[i];
+  }
+
+  for (auto level : supported_levels()) {
+    INFO(frn::lib::cpu::ToString(level));
+    const auto& kernels = frn::lib::math::kernels::Mp61KernelsFor(level);
+
+    auto z = x;
+    kernels.add_into(vec::details::Values(z), vec::details::Values(y), n);
+    REQUIRE(z == sum);
+
+    z = x;
+    kernels.subtract_into(vec::details::Values(z), vec::details::Values(y),
+                          n);
+    REQUIRE(z == difference);
+
+    z = x;
+    kernels.multiply_into(vec::details::Values(z), vec::details::Values(y),
+                          n);
+    REQUIRE(z == product);
+
+    auto d = kernels.dot(vec::details::Values(x), vec::details::Values(y), n);
+    REQUIRE(Field(d) == dot);
+  }
+
+  REQUIRE(vec::Dot(x, y) == dot);
+  REQUIRE(vec::Multiply(x, y) == product);
+}
+
+TEST_CASE("cpu levels agree on Mp61 matrix products") {
+  // a 70 x 300 by 300 x 37 product spans several tiles in each direction. The
+  // rows of each matrix are padded to test the strides.
+  const std::size_t n = 70, p = 300, m = 37, pad = 3;
+  const auto a = test_values((p + pad) * n, 1);
+  const auto b = test_values((m + pad) * p, 2);
+
+  std::vector<Field> expected(n * m);
+  for (std::size_t i = 0; i < n; i++)
+    for (std::size_t k = 0; k < p; k++)
+      for (std::size_t j = 0; j < m; j++)
+        expected[i * m + j] += a[i * (p + pad) + k] * b[k * (m + pad) + j];
+
+  for (auto level : supported_levels()) {
+    INFO(frn::lib::cpu::ToString(level));
+    const auto& kernels = frn::lib::math::kernels::Mp61KernelsFor(level);
+    std::vector<Field> c(n * m);
+    kernels.matmul(vec::details::Values(c), m, vec::details::Values(a),
+                   p + pad, vec::details::Values(b), m + pad, n, p, m);
+    REQUIRE(c == expected);
+  }
+}
+
+// x * y computed by double-and-add.
+static Field127 reference_multiply(const Field127& x, const Field127& y) {
+  Field127 result, power = x;
+  for (auto v = y.Value(); v; v >>= 1) {
+    if (v & 1) result += power;
+    power += power;
+  }
+  return result;
+}
+
+TEST_CASE("Mp127 multiplication") {
+  auto values = test_values<Field127>(50, 3);
+  values.emplace_back(Field127(1) - Field127(2));
+  values.emplace_back(Field127(__uint128_t(1) << 126));
+  values.emplace_back(Field127(~std::uint64_t(0)));
+  for (const auto& x : values)
+    for (const auto& y : values) REQUIRE(x * y == reference_multiply(x, y));
+}
+
+TEST_CASE("cpu levels agree on Mp127 kernels") {
+  // long enough for the lazy reduction of the dot product, and not a multiple
+  // of the vector width.
+  const std::size_t n = 8 * 300 + 5;
+  const auto x = test_values<Field127>(n, 1);
+  const auto y = test_values<Field127>(n, 2);
+
+  std::vector<Field127> product;
+  Field127 dot;
+  for (std::size_t i = 0; i < n; i++) {
+    product.emplace_back(x[i] * y[i]);
+    dot += x[i] * y[i];
+  }
+
+  for (auto level : supported_levels()) {
+    INFO(frn::lib::cpu::ToString(level));
+    const auto& kernels = frn::lib::math::kernels::Mp127KernelsFor(level);
+
+    auto z = x;
+    kernels.multiply_into(vec::details::Values(z), vec::details::Values(y),
+                          n);
+    REQUIRE(z == product);
+
+    auto d = kernels.dot(vec::details::Values(x), vec::details::Values(y), n);
+    REQUIRE(Field127(d) == dot);
+
+    // all limbs as large as possible.
+    const std::vector<Field127> minus_one(n, -Field127(1));
+    d = kernels.dot(vec::details::Values(minus_one),
+                    vec::details::Values(minus_one), n);
+    REQUIRE(Field127(d) == Field127(n));
+  }
+
+  REQUIRE(vec::Dot(x, y) == dot);
+  REQUIRE(vec::Multiply(x, y) == product);
+}
+
+TEST_CASE("cpu levels agree on Mp31 kernels") {
+  // 37 is not a multiple of any vector width, so the tails are tested too.
+  const std::size_t n = 37;
+  const auto x = test_values<Field31>(n, 1);
+  const auto y = test_values<Field31>(n, 2);
+
+  std::vector<Field31> sum, difference, product;
+  Field31 dot;
+  for (std::size_t i = 0; i < n; i++) {
+    sum.emplace_back(x[i] + y[i]);
+    difference.emplace_back(x[i] - y[i]);
+    product.emplace_back(x[i] * y[i]);
+    dot += x[i] * y[i];
+  }
+
+  for (auto level : supported_levels()) {
+    INFO(frn::lib::cpu::ToString(level));
+    const auto& kernels = frn::lib::math::kernels::Mp31KernelsFor(level);
+
+    auto z = x;
+    kernels.add_into(vec::details::Values(z), vec::details::Values(y), n);
+    REQUIRE(z == sum);
+
+    z = x;
+    kernels.subtract_into(vec::details::Values(z), vec::details::Values(y),
+                          n);
+    REQUIRE(z == difference);
+
+    z = x;
+    kernels.multiply_into(vec::details::Values(z), vec::details::Values(y),
+                          n);
+    REQUIRE(z == product);
+
+    auto d = kernels.dot(vec::details::Values(x), vec::details::Values(y), n);
+    REQUIRE(Field31(d) == dot);
+  }
+
+  REQUIRE(vec::Dot(x, y) == dot);
+  REQUIRE(vec::Add(x, y) == sum);
+}
+
+TEST_CASE("cpu levels agree on sums of products") {
+  // three rows of n values each, with n not a multiple of any vector width.
+  const std::size_t n = 37;
+  const auto a = test_values(3 * n, 4);
+  const auto b = test_values(3 * n, 5);
+  const std::vector<unsigned> src_a = {0, 2, 1, 0, 2};
+  const std::vector<unsigned> src_b = {1, 1, 0, 2, 2};
+
+  std::vector<Field> expected(n);
+  for (std::size_t i = 0; i < n; i++)
+    for (std::size_t k = 0; k < src_a.size(); k++)
+      expected[i] += a[src_a[k] * n + i] * b[src_b[k] * n + i];
+
+  for (auto level : supported_levels()) {
+    INFO(frn::lib::cpu::ToString(level));
+    const auto& kernels = frn::lib::math::kernels::Mp61KernelsFor(level);
+    std::vector<Field> x(n);
+    kernels.sum_of_products(vec::details::Values(x), vec::details::Values(a),
+                            vec::details::Values(b), n, src_a.data(),
+                            src_b.data(), src_a.size(), n);
+    REQUIRE(x == expected);
+  }
+}
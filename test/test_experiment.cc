@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <catch2/catch.hpp>
+
+#include "frn/experiment.h"
+#include "frn/simulator.h"
+
+TEST_CASE("experiment mult") {
+  const std::size_t n = 4;
+  const std::size_t size = 100;
+  std::vector<frn::Measurement> measurements(n);
+
+  frn::Simulator sim(n);
+  sim.Run([&](std::shared_ptr<frn::TcpNetwork> network) {
+    frn::Experiment experiment(frn::ExperimentType::eCheck, network);
+    // running twice should measure the same communication both times.
+    experiment.Run(size);
+    measurements[network->Id()] = experiment.Run(size);
+  });
+
+  std::size_t rounds = 0;
+  for (const auto& m : measurements) {
+    REQUIRE(m.phases.size() == 3);
+    REQUIRE(m.phases[0].first == "prepare");
+    REQUIRE(m.phases[1].first == "mult");
+    REQUIRE(m.phases[2].first == "check");
+    rounds = std::max(rounds, m.rounds);
+  }
+  REQUIRE(rounds == 3);
+
+  // everything sent is received by someone, and every product needs at least
+  // one field element from P0.
+  std::size_t sent = 0, received = 0;
+  for (const auto& m : measurements) {
+    sent += m.bytes_sent;
+    received += m.bytes_received;
+  }
+  REQUIRE(sent == received);
+  REQUIRE(measurements[0].bytes_sent >= size * frn::Field::ByteSize());
+}
+
+TEST_CASE("experiment names") {
+  for (auto type : {frn::ExperimentType::eInput, frn::ExperimentType::eMult,
+                    frn::ExperimentType::eCheck})
+    REQUIRE(frn::ParseExperimentType(frn::ToString(type)) == type);
+  REQUIRE_THROWS_AS(frn::ParseExperimentType("foo"), std::invalid_argument);
+}
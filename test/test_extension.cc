@@ -0,0 +1,142 @@
+#include <catch2/catch.hpp>
+
+#include "frn/lib/math/extension.h"
+#include "frn/lib/math/p.h"
+#include "frn/lib/math/vec.h"
+#include "frn/lib/primitives/prg.h"
+
+using F31 = frn::lib::math::FpElement<frn::lib::math::Mp31>;
+using Ext = frn::lib::math::FpExtension<frn::lib::math::Mp31, 3>;
+
+static_assert(frn::lib::math::details::IsBinomialExtension(
+    frn::lib::math::Mp31::kPrime, 6));
+static_assert(!frn::lib::math::details::IsBinomialExtension(
+    frn::lib::math::Mp31::kPrime, 4));
+static_assert(!frn::lib::math::details::IsBinomialExtension(
+    frn::lib::math::Mp31::kPrime, 5));
+// 3 divides p - 1, but 27 does not, so there is no 27th root of unity.
+static_assert(frn::lib::math::details::IsBinomialExtension(
+    frn::lib::math::Mp31::kPrime, 9));
+static_assert(!frn::lib::math::details::IsBinomialExtension(
+    frn::lib::math::Mp31::kPrime, 27));
+
+template <typename T>
+static T random_element(frn::lib::primitives::PRG& prg) {
+  unsigned char buffer[T::ByteSize()];
+  prg.Next(buffer, T::ByteSize());
+  return T::FromBytes(buffer);
+}
+
+TEST_CASE("Mp31 arithmetic") {
+  const auto p = frn::lib::math::Mp31::kPrime;
+  REQUIRE(F31(p) == F31(0));
+  REQUIRE(F31(p - 1) + F31(2) == F31(1));
+  REQUIRE(F31(p - 1) * F31(p - 1) == F31(1));
+  REQUIRE(F31(1 << 16) * F31(1 << 16) == F31(2));
+
+  frn::lib::primitives::PRG prg;
+  for (int i = 0; i < 100; i++) {
+    auto x = random_element<F31>(prg);
+    if (x == F31(0)) continue;
+    REQUIRE(x * x.Inverse() == F31::kOne);
+  }
+}
+
+template <typename T>
+static void check_inversion() {
+  frn::lib::primitives::PRG prg;
+  std::vector<T> values;
+  for (int i = 0; i < 50; i++) {
+    auto x = random_element<T>(prg);
+    values.emplace_back(x == T(0) ? T(1) : x);
+  }
+  values.emplace_back(T(1));
+  values.emplace_back(-T(1));
+
+  const auto inverses = frn::lib::math::vector::BatchInvert(values);
+  REQUIRE(inverses.size() == values.size());
+  for (std::size_t i = 0; i < values.size(); i++) {
+    REQUIRE(inverses[i] == values[i].Inverse());
+    REQUIRE(values[i].InverseConstantTime() == inverses[i]);
+  }
+
+  auto with_zero = values;
+  with_zero[7] = T(0);
+  const auto before = with_zero;
+  REQUIRE_THROWS_AS(frn::lib::math::vector::BatchInvertInto(with_zero),
+                    std::logic_error);
+  REQUIRE(with_zero == before);
+  REQUIRE_THROWS_AS(T(0).InverseConstantTime(), std::logic_error);
+  REQUIRE(frn::lib::math::vector::BatchInvert(std::vector<T>()).empty());
+}
+
+TEST_CASE("Batched and constant time inversion") {
+  check_inversion<F31>();
+  check_inversion<frn::lib::math::FpElement<frn::lib::math::Mp61>>();
+  check_inversion<frn::lib::math::FpElement<frn::lib::math::Mp127>>();
+
+  // also over the extension.
+  frn::lib::primitives::PRG prg;
+  std::vector<Ext> values;
+  for (int i = 0; i < 10; i++) values.emplace_back(random_element<Ext>(prg));
+  const auto inverses = frn::lib::math::vector::BatchInvert(values);
+  for (std::size_t i = 0; i < values.size(); i++)
+    REQUIRE(values[i] * inverses[i] == Ext::kOne);
+}
+
+TEST_CASE("Mp31 extension arithmetic") {
+  frn::lib::primitives::PRG prg;
+  for (int i = 0; i < 20; i++) {
+    auto a = random_element<Ext>(prg);
+    auto b = random_element<Ext>(prg);
+    auto c = random_element<Ext>(prg);
+    REQUIRE(a * b == b * a);
+    REQUIRE((a * b) * c == a * (b * c));
+    REQUIRE(a * (b + c) == a * b + a * c);
+    REQUIRE(a * Ext::kOne == a);
+    REQUIRE(a * a.Inverse() == Ext::kOne);
+    REQUIRE((a * b) / b == a);
+  }
+  REQUIRE_THROWS_AS(Ext::kZero.Inverse(), std::logic_error);
+
+  // x^3 = 7.
+  const Ext x({F31(0), F31(1), F31(0)});
+  REQUIRE(x * x * x == Ext(F31(7)));
+
+  // the base field is embedded as constants.
+  REQUIRE(Ext(F31(3)) * Ext(F31(5)) == Ext(F31(15)));
+
+  const auto a = random_element<Ext>(prg);
+  unsigned char buffer[Ext::ByteSize()];
+  a.ToBytes(buffer);
+  REQUIRE(Ext::FromBytes(buffer) == a);
+}
+
+TEST_CASE("Mp31 extension Frobenius") {
+  frn::lib::primitives::PRG prg;
+  const auto a = random_element<Ext>(prg);
+  const auto b = random_element<Ext>(prg);
+
+  // the Frobenius map is a field automorphism of order 3, fixing the base
+  // field.
+  REQUIRE((a * b).Frobenius(1) == a.Frobenius(1) * b.Frobenius(1));
+  REQUIRE(a.Frobenius(3) == a);
+  REQUIRE(a.Frobenius(1).Frobenius(1) == a.Frobenius(2));
+  REQUIRE(Ext(F31(11)).Frobenius(1) == Ext(F31(11)));
+
+  // and the norm is in the base field.
+  const auto norm = a * a.Frobenius(1) * a.Frobenius(2);
+  REQUIRE(norm == Ext(norm[0]));
+}
+
+TEST_CASE("Mp31 extension with a repeated prime factor") {
+  // p - 1 = 2 * 3^2 * 7 * 11 * 31 * 151 * 331.
+  using Ext9 = frn::lib::math::FpExtension<frn::lib::math::Mp31, 9>;
+  frn::lib::primitives::PRG prg;
+  for (int i = 0; i < 20; i++) {
+    const auto a = random_element<Ext9>(prg);
+    const auto b = random_element<Ext9>(prg);
+    REQUIRE((a * b).Frobenius(1) == a.Frobenius(1) * b.Frobenius(1));
+    REQUIRE(a * a.Inverse() == Ext9::kOne);
+  }
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#include "frn/fixed.h"
+
+using namespace frn;
+
+namespace frn {
+
+static auto as_tuple(const MultEntry& e) {
+  return std::make_tuple(e.src_a, e.src_b, e.dest_c, e.first_party);
+}
+
+static bool operator<(const MultEntry& a, const MultEntry& b) {
+  return as_tuple(a) < as_tuple(b);
+}
+
+static bool operator==(const MultEntry& a, const MultEntry& b) {
+  return as_tuple(a) == as_tuple(b);
+}
+
+}  // namespace frn
+
+// compares FixedProtocol<N, T, Id> with a ShrManipulator on shares of x and y.
+template <std::size_t N, std::size_t T, std::size_t Id>
+static void compare_party(const std::vector<Shr>& xs,
+                          const std::vector<Shr>& ys) {
+  using Protocol = FixedProtocol<N, T, Id>;
+  ShrManipulator manipulator(Id, T, N);
+  INFO("party " << Id);
+
+  REQUIRE(Protocol::kShareSize == manipulator.ShareSize());
+
+  auto expected_table = manipulator.GetTableMult();
+  auto table = Protocol::TableMult();
+  std::sort(expected_table.begin(), expected_table.end());
+  std::sort(table.begin(), table.end());
+  REQUIRE(table == expected_table);
+
+  const auto x = Protocol::FromShr(xs[Id]);
+  const auto y = Protocol::FromShr(ys[Id]);
+
+  REQUIRE(Protocol::ToShr(Protocol::MultiplyToDoubleDegree(x, y)) ==
+          manipulator.MultiplyToDoubleDegree(xs[Id], ys[Id]));
+  REQUIRE(Protocol::MultiplyToAdditive(x, y) ==
+          manipulator.MultiplyToAdditive(xs[Id], ys[Id]));
+  REQUIRE(Protocol::ToShr(Protocol::AddConstant(x, Field(5))) ==
+          manipulator.AddConstant(xs[Id], Field(5)));
+  REQUIRE(Protocol::ToShr(Protocol::Add(x, y)) ==
+          manipulator.Add(xs[Id], ys[Id]));
+}
+
+template <std::size_t N, std::size_t... Ids>
+static void compare_all(std::index_sequence<Ids...>) {
+  constexpr auto t = (N - 1) / 3;
+  frn::lib::primitives::PRG prg;
+  frn::lib::secret_sharing::Replicator<Field> replicator(N, t);
+  // values close to the prime make sure the delayed reduction is correct.
+  auto xs = replicator.Share(Field(frn::lib::math::Mp61::kPrime - 1), prg);
+  auto ys = replicator.Share(Field(frn::lib::math::Mp61::kPrime - 2), prg);
+  (compare_party<N, t, Ids>(xs, ys), ...);
+}
+
+TEST_CASE("fixed protocol matches manipulator") {
+  compare_all<4>(std::make_index_sequence<4>{});
+  compare_all<7>(std::make_index_sequence<7>{});
+}
+
+TEST_CASE("fixed protocol multiplication") {
+  constexpr std::size_t n = 7;
+  constexpr std::size_t t = 2;
+  using P0 = FixedProtocol<n, t, 0>;
+  using P3 = FixedProtocol<n, t, 3>;
+  using P5 = FixedProtocol<n, t, 5>;
+  frn::lib::primitives::PRG prg;
+  auto replicator = CreateReplicator(n);
+  auto xs = replicator.Share(Field(6), prg);
+  auto ys = replicator.Share(Field(7), prg);
+
+  // parties 0 to 2t hold an additive share of the product, the rest hold 0.
+  auto sum = P0::MultiplyToAdditive(P0::FromShr(xs[0]), P0::FromShr(ys[0]));
+  sum += FixedProtocol<n, t, 1>::MultiplyToAdditive(
+      FixedProtocol<n, t, 1>::FromShr(xs[1]),
+      FixedProtocol<n, t, 1>::FromShr(ys[1]));
+  sum += FixedProtocol<n, t, 2>::MultiplyToAdditive(
+      FixedProtocol<n, t, 2>::FromShr(xs[2]),
+      FixedProtocol<n, t, 2>::FromShr(ys[2]));
+  sum += P3::MultiplyToAdditive(P3::FromShr(xs[3]), P3::FromShr(ys[3]));
+  sum += FixedProtocol<n, t, 4>::MultiplyToAdditive(
+      FixedProtocol<n, t, 4>::FromShr(xs[4]),
+      FixedProtocol<n, t, 4>::FromShr(ys[4]));
+  REQUIRE(sum == Field(42));
+  REQUIRE(P5::MultiplyToAdditive(P5::FromShr(xs[5]), P5::FromShr(ys[5])) ==
+          Field(0));
+}
+
+TEST_CASE("fixed multiply kernels") {
+  for (std::size_t n : {4, 7, 10})
+    for (std::size_t id = 0; id < n; id++)
+      REQUIRE(FindFixedMultiplyKernel(n, (n - 1) / 3, id) != nullptr);
+  REQUIRE(FindFixedMultiplyKernel(5, 1, 0) == nullptr);
+  REQUIRE(FindFixedMultiplyKernel(7, 1, 0) == nullptr);
+  REQUIRE(FindFixedMultiplyKernel(4, 1, 4) == nullptr);
+}
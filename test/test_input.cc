@@ -2,19 +2,22 @@
 
 #include "frn/input.h"
 #include "frn/shr.h"
+#include "frn/simulator.h"
 #include "frn/util.h"
 #include "mock_network.h"
 #include "tcp_network_helper.h"
 
+// send the keys which the other parties deal to party id.
 void Prepare(std::shared_ptr<frn::MockNetwork> network, unsigned id, unsigned n,
              frn::lib::secret_sharing::Replicator<frn::Field> replicator) {
   frn::lib::primitives::PRG prg;
-  for (std::size_t i = 0; i < n; i++) {
-    if (i == id) continue;
-    auto s = frn::GetRandomElement(prg);
-    auto shr = replicator.Share(s, prg);
-    network->SendSharesFrom(i, {shr[id]});
+  std::vector<std::vector<frn::Field>> keys(n);
+  for (auto idx : replicator.IndexSetFor(id)) {
+    auto dealer = frn::InputSetup::KeyDealer(replicator, idx);
+    if (dealer != id) keys[dealer].emplace_back(frn::GetRandomElement(prg));
   }
+  for (std::size_t i = 0; i < n; i++)
+    if (keys[i].size()) network->SendValuesFrom(i, keys[i]);
 }
 
 TEST_CASE("input") {
@@ -103,3 +106,33 @@ TEST_CASE("input real") {
   auto secret0 = rep.Reconstruct(output_shares);
   REQUIRE(secret == secret0);
 }
+
+TEST_CASE("simulated input") {
+  const std::size_t n = GENERATE(4, 5, 7);
+  const std::size_t d = (n - 1) / 3;
+  const unsigned inputter = 2;
+  const std::vector<frn::Field> secrets = {frn::Field(11), frn::Field(22),
+                                           frn::Field(33)};
+  std::vector<std::vector<frn::Shr>> output_shares(n);
+
+  frn::Simulator sim(n);
+  sim.Run([&](std::shared_ptr<frn::TcpNetwork> network) {
+    const auto id = network->Id();
+    auto rep = frn::CreateReplicator(n);
+    frn::InputSetup setup(network, rep, frn::lib::primitives::PRG());
+    frn::Input input(network, frn::ShrManipulator(id, d, n), setup.Run());
+    if (id == inputter)
+      input.Prepare(secrets);
+    else
+      input.PrepareToReceive(inputter, secrets.size());
+    output_shares[id] = input.Run()[inputter];
+  });
+
+  auto rep = frn::CreateReplicator(n);
+  for (std::size_t j = 0; j < secrets.size(); j++) {
+    std::vector<frn::Shr> shares;
+    for (std::size_t i = 0; i < n; i++)
+      shares.emplace_back(output_shares[i][j]);
+    REQUIRE(rep.Reconstruct(shares) == secrets[j]);
+  }
+}
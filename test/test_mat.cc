@@ -0,0 +1,108 @@
+#include <catch2/catch.hpp>
+
+#include "frn/lib/math/fp.h"
+#include "frn/lib/math/mat.h"
+#include "frn/lib/math/p.h"
+#include "frn/lib/primitives/prg.h"
+
+using Field = frn::lib::math::FpElement<frn::lib::math::Mp61>;
+using Field127 = frn::lib::math::FpElement<frn::lib::math::Mp127>;
+template <typename T>
+using Matrix = frn::lib::math::Matrix<T>;
+
+template <typename T>
+static Matrix<T> random_matrix(std::size_t n, std::size_t m,
+                               frn::lib::primitives::PRG& prg) {
+  Matrix<T> matrix(n, m);
+  std::vector<T> values(n * m);
+  prg.NextFields(values);
+  for (std::size_t i = 0; i < n; i++)
+    for (std::size_t j = 0; j < m; j++) matrix(i, j) = values[i * m + j];
+  // values close to the prime exercise the lazy reduction.
+  for (std::size_t i = 0; i < std::min(n, m); i++) matrix(i, i) = -T(1 + i);
+  return matrix;
+}
+
+template <typename T>
+static Matrix<T> reference_product(const Matrix<T>& a, const Matrix<T>& b) {
+  Matrix<T> c(a.RowCount(), b.ColumnCount());
+  for (std::size_t i = 0; i < a.RowCount(); i++)
+    for (std::size_t j = 0; j < b.ColumnCount(); j++)
+      for (std::size_t k = 0; k < a.ColumnCount(); k++)
+        c(i, j) += a(i, k) * b(k, j);
+  return c;
+}
+
+template <typename T>
+static bool equal(const Matrix<T>& a, const Matrix<T>& b) {
+  if (a.RowCount() != b.RowCount() || a.ColumnCount() != b.ColumnCount())
+    return false;
+  for (std::size_t i = 0; i < a.RowCount(); i++)
+    for (std::size_t j = 0; j < a.ColumnCount(); j++)
+      if (a(i, j) != b(i, j)) return false;
+  return true;
+}
+
+TEST_CASE("Matrix views") {
+  Matrix<Field> m(4, 5);
+  for (std::size_t i = 0; i < 4; i++)
+    for (std::size_t j = 0; j < 5; j++) m(i, j) = Field(10 * i + j);
+
+  auto sub = m.extract_submatrix(1, 3, 2, 5);
+  REQUIRE(sub.RowCount() == 2);
+  REQUIRE(sub.ColumnCount() == 3);
+  REQUIRE(sub(0, 0) == Field(12));
+  REQUIRE(sub(1, 2) == Field(24));
+
+  // views share the elements of the matrix.
+  sub(1, 1) = Field(100);
+  REQUIRE(m(2, 3) == Field(100));
+  auto inner = sub.extract_submatrix(1, 2, 1, 3);
+  REQUIRE(inner(0, 0) == Field(100));
+  REQUIRE(inner(0, 1) == Field(24));
+
+  Matrix<Field> copy(sub);
+  REQUIRE(copy(1, 1) == Field(100));
+  copy(1, 1) = Field(0);
+  REQUIRE(m(2, 3) == Field(100));
+
+  const auto& cm = m;
+  REQUIRE(cm.extract_submatrix(0, 4, 0, 5)(3, 4) == Field(34));
+  REQUIRE(m.extract_submatrix(4, 4, 5, 5).RowCount() == 0);
+  REQUIRE_THROWS_AS(m.extract_submatrix(2, 5, 0, 1), std::logic_error);
+  REQUIRE_THROWS_AS(m.extract_submatrix(0, 1, 3, 2), std::logic_error);
+}
+
+TEST_CASE("Matrix multiplication") {
+  frn::lib::primitives::PRG prg;
+
+  // sizes which are not multiples of the tiles or vector widths.
+  auto a = random_matrix<Field>(37, 301, prg);
+  auto b = random_matrix<Field>(301, 45, prg);
+  const auto expected = reference_product(a, b);
+  REQUIRE(equal(a.MatMul(b), expected));
+  REQUIRE(equal(a.MatMul(b, 1), expected));
+
+  // products of views use the strides of the matrices.
+  Matrix<Field> block(10, 12);
+  frn::lib::math::MatMulInto(block.View(), a.extract_submatrix(5, 15, 7, 107),
+                             b.extract_submatrix(7, 107, 30, 42));
+  REQUIRE(equal(block, reference_product(Matrix<Field>(a.extract_submatrix(
+                                             5, 15, 7, 107)),
+                                         Matrix<Field>(b.extract_submatrix(
+                                             7, 107, 30, 42)))));
+
+  // large enough to be split between threads.
+  auto c = random_matrix<Field>(64, 520, prg);
+  auto d = random_matrix<Field>(520, 70, prg);
+  REQUIRE(equal(c.MatMul(d, 3), c.MatMul(d, 1)));
+
+  auto e = random_matrix<Field127>(9, 17, prg);
+  auto f = random_matrix<Field127>(17, 5, prg);
+  REQUIRE(equal(e.MatMul(f), reference_product(e, f)));
+
+  REQUIRE_THROWS_AS(a.MatMul(a), std::invalid_argument);
+  REQUIRE_THROWS_AS(frn::lib::math::MatMulInto(block.View(), a.View(),
+                                               b.View()),
+                    std::invalid_argument);
+}
@@ -19,6 +19,16 @@ struct Helper {
     return manipulator.MultiplyToAdditive(x, y) - r.add_share;
   };
 
+  frn::Field PrepareDotProduct(const std::vector<frn::Shr>& xs,
+                               const std::vector<frn::Shr>& ys) {
+    auto r = corr.GenRandomShare();
+    random_shares.emplace_back(r);
+    frn::Field sum(0);
+    for (std::size_t i = 0; i < xs.size(); i++)
+      sum += manipulator.MultiplyToAdditive(xs[i], ys[i]);
+    return sum - r.add_share;
+  };
+
   frn::Shr AdjustOutput(const frn::Field c) {
     return manipulator.AddConstant(random_shares[0].rep_share, c);
   };
@@ -165,3 +175,107 @@ TEST_CASE("Secure multiplication") {
     REQUIRE(output.size() == 1);
   }
 }
+
+TEST_CASE("Secure dot product") {
+  unsigned n = 7;
+  unsigned d = (n - 1) / 3;
+  const std::size_t length = 100;
+  frn::lib::primitives::PRG prg;
+  std::vector<frn::Field> xs, ys;
+  frn::Field z(0);
+  for (std::size_t i = 0; i < length; i++) {
+    xs.emplace_back(frn::Field(frn::lib::math::Mp61::kPrime - 1 - i));
+    ys.emplace_back(frn::Field(3 * i + 2));
+    z += xs[i] * ys[i];
+  }
+  auto replicator = frn::lib::secret_sharing::Replicator<frn::Field>(n, d);
+  auto sharesx = replicator.Share(xs, prg);
+  auto sharesy = replicator.Share(ys, prg);
+
+  SECTION("p2") {
+    unsigned id = 1;
+    SETUP(id);
+
+    mult_protocol.PrepareDotProduct(sharesx[id], sharesy[id]);
+    mult_protocol.SendStep();
+    // a single value is sent regardless of the length of the vectors.
+    auto x = network->GetValuesReceivedBy(0);
+    REQUIRE(x.size() == 1);
+    REQUIRE(x[0].size() == 1);
+    REQUIRE(checkdata.shares_sent_to_p1.size() == 1);
+    REQUIRE(checkdata.msgs.size() == 1);
+
+    auto re = x[0][0];
+    for (std::size_t i = 0; i < 2 * d + 1; i++)
+      if (i != id)
+        re += helpers[i].PrepareDotProduct(sharesx[i], sharesy[i]);
+
+    network->Clear();
+    network->SendValuesFrom(0, {re});
+
+    auto output = mult_protocol.OutputStep();
+    REQUIRE(output.size() == 1);
+
+    std::vector<frn::Shr> output_shares(n);
+    output_shares[id] = output[0];
+    for (std::size_t i = 2 * d + 1; i < n; i++)
+      helpers[i].PrepareDotProduct(sharesx[i], sharesy[i]);
+    ADJUST_OUTPUT(id);
+
+    REQUIRE(replicator.Reconstruct(output_shares) == z);
+  }
+
+  SECTION("different lengths") {
+    unsigned id = 0;
+    SETUP(id);
+    auto shorter = sharesy[id];
+    shorter.pop_back();
+    REQUIRE_THROWS_AS(mult_protocol.PrepareDotProduct(sharesx[id], shorter),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("Secure squares") {
+  unsigned n = 7;
+  unsigned d = (n - 1) / 3;
+  frn::lib::primitives::PRG prg;
+  std::vector<frn::Field> xs = {frn::Field(10), frn::Field(20)};
+  auto replicator = frn::lib::secret_sharing::Replicator<frn::Field>(n, d);
+  auto sharesx = replicator.Share(xs, prg);
+
+  unsigned id = 1;
+  SETUP(id);
+
+  mult_protocol.PrepareSquares(sharesx[id]);
+  mult_protocol.SendStep();
+  auto sent = network->GetValuesReceivedBy(0);
+  REQUIRE(sent.size() == 1);
+  REQUIRE(sent[0].size() == xs.size());
+
+  // random shares must be drawn in the same batches by every party.
+  std::vector<frn::Field> re = sent[0];
+  for (std::size_t i = 0; i < n; i++) {
+    if (i == id) continue;
+    helpers[i].random_shares = helpers[i].corr.GenRandomShares(xs.size());
+    if (i >= 2 * d + 1) continue;
+    for (std::size_t j = 0; j < xs.size(); j++)
+      re[j] += helpers[i].manipulator.MultiplyToAdditive(sharesx[i][j],
+                                                         sharesx[i][j]) -
+               helpers[i].random_shares[j].add_share;
+  }
+
+  network->Clear();
+  network->SendValuesFrom(0, re);
+  auto output = mult_protocol.OutputStep();
+  REQUIRE(output.size() == xs.size());
+
+  for (std::size_t j = 0; j < xs.size(); j++) {
+    std::vector<frn::Shr> output_shares(n);
+    output_shares[id] = output[j];
+    for (std::size_t i = 0; i < n; i++)
+      if (i != id)
+        output_shares[i] = helpers[i].manipulator.AddConstant(
+            helpers[i].random_shares[j].rep_share, re[j]);
+    REQUIRE(replicator.Reconstruct(output_shares) == xs[j] * xs[j]);
+  }
+}
@@ -0,0 +1,43 @@
+#include <catch2/catch.hpp>
+#include <set>
+
+#include "frn/lib/math/fp.h"
+#include "frn/lib/math/p.h"
+#include "frn/lib/primitives/prg.h"
+
+template <typename T>
+static void check_next_fields() {
+  using V = typename T::ValueType;
+  const std::size_t n = 1001;
+
+  frn::lib::primitives::PRG prg;
+  std::vector<T> elements(n);
+  prg.NextFields(elements);
+
+  // the elements are the masked output of Next, as no value is rejected for
+  // this seed.
+  frn::lib::primitives::PRG reference;
+  std::vector<V> values(n);
+  reference.Next((unsigned char*)values.data(), n * sizeof(V));
+  std::set<V> distinct;
+  for (std::size_t i = 0; i < n; i++) {
+    const auto value = values[i] & ((V(1) << T::PackedBitSize()) - 1);
+    REQUIRE(value < T::Modulus());
+    REQUIRE(elements[i] == T(value));
+    distinct.insert(value);
+  }
+  REQUIRE(distinct.size() == n);
+  REQUIRE(prg.Counter() == reference.Counter());
+
+  // whole blocks are used for the elements.
+  frn::lib::primitives::PRG blocks;
+  blocks.NextFields(elements.data(), 16);
+  REQUIRE(blocks.Counter() ==
+          (long)(16 * sizeof(V) / frn::lib::primitives::PRG::BlockSize()));
+}
+
+TEST_CASE("PRG field elements") {
+  check_next_fields<frn::lib::math::FpElement<frn::lib::math::Mp31>>();
+  check_next_fields<frn::lib::math::FpElement<frn::lib::math::Mp61>>();
+  check_next_fields<frn::lib::math::FpElement<frn::lib::math::Mp127>>();
+}
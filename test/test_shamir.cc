@@ -0,0 +1,104 @@
+#include <catch2/catch.hpp>
+
+#include "frn/shamir.h"
+#include "frn/simulator.h"
+
+using namespace frn;
+
+TEST_CASE("Shamir share and reconstruct") {
+  const std::size_t n = 7;
+  frn::lib::primitives::PRG prg;
+  auto shamir = CreateShamir(n);
+  Field secret(1234);
+
+  auto shares = shamir.Share(secret, prg);
+  REQUIRE(shares.size() == n);
+  REQUIRE(shamir.Reconstruct(shares) == secret);
+  REQUIRE(shamir.ErrorDetection(shares) == secret);
+
+  // any t + 1 shares determine the secret.
+  std::vector<Field> points, subset;
+  for (std::size_t i : {2, 4, 6}) {
+    points.emplace_back(decltype(shamir)::Point(i));
+    subset.emplace_back(shares[i]);
+  }
+  auto coefficients =
+      frn::lib::secret_sharing::LagrangeCoefficients(points, Field(0));
+  REQUIRE(frn::lib::math::vector::Dot(coefficients, subset) == secret);
+
+  shares[5] += Field(1);
+  REQUIRE_THROWS_AS(shamir.ErrorDetection(shares), std::runtime_error);
+}
+
+TEST_CASE("Replicated to Shamir conversion") {
+  const std::size_t n = GENERATE(4, 5, 7, 10);
+  frn::lib::primitives::PRG prg;
+  auto replicator = CreateReplicator(n);
+  auto shamir = CreateShamir(n);
+  Field x(10), y(32);
+  auto sharesx = replicator.Share(x, prg);
+  auto sharesy = replicator.Share(y, prg);
+
+  std::vector<ShamirShr> converted, combined;
+  for (std::size_t id = 0; id < n; id++) {
+    ShamirManipulator manipulator(id, replicator);
+    auto a = manipulator.FromReplicated(sharesx[id]);
+    auto b = manipulator.FromReplicated(sharesy[id]);
+    converted.emplace_back(a);
+    // 3 * x - y + 5
+    combined.emplace_back(manipulator.AddConstant(
+        manipulator.Subtract(manipulator.MultiplyConstant(a, Field(3)), b),
+        Field(5)));
+  }
+
+  INFO("n = " << n);
+  REQUIRE(shamir.ErrorDetection(converted) == x);
+  REQUIRE(shamir.ErrorDetection(combined) == Field(3) * x - y + Field(5));
+}
+
+TEST_CASE("simulated Shamir round trip") {
+  const std::size_t n = GENERATE(4, 7);
+  const std::size_t m = 5;
+  frn::lib::primitives::PRG prg;
+  auto replicator = CreateReplicator(n);
+
+  std::vector<Field> xs;
+  std::vector<std::vector<Shr>> shares(n);
+  for (std::size_t j = 0; j < m; j++) {
+    xs.emplace_back(Field(j + 100));
+    auto s = replicator.Share(xs[j], prg);
+    for (std::size_t i = 0; i < n; i++) shares[i].emplace_back(s[i]);
+  }
+
+  std::vector<std::vector<Field>> opened(n);
+  std::vector<std::vector<Shr>> output_shares(n);
+
+  frn::Simulator sim(n);
+  sim.Run([&](std::shared_ptr<frn::TcpNetwork> network) {
+    const auto id = network->Id();
+    ShamirManipulator manipulator(id, replicator);
+    auto shamir_shares = manipulator.FromReplicated(shares[id]);
+
+    ShamirOpen open(network, CreateShamir(n));
+    open.Prepare(shamir_shares);
+    opened[id] = open.Run();
+
+    ShamirToReplicated convert(network, replicator,
+                               Correlator(id, replicator));
+    convert.Prepare(shamir_shares);
+    output_shares[id] = convert.Run();
+  });
+
+  for (std::size_t j = 0; j < m; j++) {
+    std::vector<Shr> output;
+    for (std::size_t i = 0; i < n; i++) {
+      REQUIRE(opened[i][j] == xs[j]);
+      output.emplace_back(output_shares[i][j]);
+    }
+    REQUIRE(replicator.ErrorDetection(output) == xs[j]);
+    // the output is a fresh sharing.
+    std::vector<Shr> input;
+    for (std::size_t i = 0; i < n; i++) input.emplace_back(shares[i][j]);
+    REQUIRE(output != input);
+  }
+}
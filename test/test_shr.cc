@@ -1,5 +1,6 @@
 #include <catch2/catch.hpp>
 
+#include "frn/lib/math/z2k.h"
 #include "frn/shr.h"
 
 using namespace frn;
@@ -218,3 +219,214 @@ TEST_CASE("Local multiplication to additive sharing") {
   for (int i = 0; i < 2 * d + 1; ++i) prod += addz[i];
   REQUIRE(prod == z);
 }
+
+TEST_CASE("Multiplication rows group the table") {
+  const int m = 7;
+  const int d = (m - 1) / 3;
+  ShrManipulator manipulator(1, d, m);
+  const auto& table = manipulator.GetTableMult();
+  const auto& by_dest = manipulator.GetRowsByDest();
+  const auto& by_party = manipulator.GetRowsByParty();
+  const auto double_size = manipulator.GetDoubleReplicator().ShareSize();
+
+  REQUIRE(by_dest.Rows() == double_size);
+  REQUIRE(by_party.Rows() == (2 * d + 1) * double_size);
+  REQUIRE(by_dest.offsets.back() == table.size());
+  REQUIRE(by_party.offsets.back() == table.size());
+
+  for (const auto& entry : table) {
+    const auto row = entry.first_party * double_size + entry.dest_c;
+    bool found = false;
+    for (auto k = by_party.offsets[row]; k < by_party.offsets[row + 1]; k++)
+      found |= by_party.src_a[k] == entry.src_a &&
+               by_party.src_b[k] == entry.src_b;
+    REQUIRE(found);
+  }
+}
+
+namespace {
+
+// checks EvaluateRows against RowSum for a batch of random shares over T.
+template <typename T>
+void CheckRowsOver(const MultRows& rows, std::size_t share_size) {
+  const std::size_t count = 70;
+  std::vector<T> a, b;
+  for (std::size_t i = 0; i < share_size * count; i++) {
+    a.emplace_back(T(i * 7919 + 13));
+    b.emplace_back(T(i * 104729 + 7));
+  }
+  std::vector<T> out(rows.Rows() * count);
+  frn::details::EvaluateRows(rows, a.data(), b.data(), count, count,
+                             out.data(), count);
+
+  for (std::size_t i = 0; i < count; i++) {
+    std::vector<T> x, y;
+    for (std::size_t s = 0; s < share_size; s++) {
+      x.emplace_back(a[s * count + i]);
+      y.emplace_back(b[s * count + i]);
+    }
+    for (std::size_t r = 0; r < rows.Rows(); r++)
+      REQUIRE(out[r * count + i] == frn::details::RowSum(rows, r, x, y));
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Multiplication rows over other rings") {
+  const int m = 7;
+  const int d = (m - 1) / 3;
+  ShrManipulator manipulator(2, d, m);
+  const auto& rows = manipulator.GetRowsByParty();
+  const auto size = manipulator.ShareSize();
+
+  // Mp31 uses the batch kernels, Z2k the scalar fallback.
+  CheckRowsOver<frn::lib::math::FpElement<frn::lib::math::Mp31>>(rows, size);
+  CheckRowsOver<frn::lib::math::Z2kElement<64>>(rows, size);
+  CheckRowsOver<Field>(rows, size);
+
+  // a row over Z2k is the sum of its products, computed modulo 2^64.
+  using Z = frn::lib::math::Z2kElement<64>;
+  std::vector<Z> x(size), y(size);
+  for (std::size_t i = 0; i < size; i++) {
+    x[i] = Z(~std::uint64_t(0) - i);
+    y[i] = Z(i + 1);
+  }
+  for (std::size_t r = 0; r < rows.Rows(); r++) {
+    std::uint64_t sum = 0;
+    for (auto k = rows.offsets[r]; k < rows.offsets[r + 1]; k++)
+      sum += x[rows.src_a[k]].Value() * y[rows.src_b[k]].Value();
+    REQUIRE(frn::details::RowSum(rows, r, x, y) == Z(sum));
+  }
+}
+
+TEST_CASE("Batched local multiplication") {
+  const int m = 7;
+  const int d = (m - 1) / 3;
+  // more than one block of the batched kernel, and a partial block.
+  const std::size_t count = 300;
+  frn::lib::primitives::PRG prg;
+  auto repl = CreateReplicator(m);
+
+  std::vector<Field> xs, ys;
+  for (std::size_t i = 0; i < count; i++) {
+    xs.emplace_back(Field(frn::lib::math::Mp61::kPrime - 1 - i));
+    ys.emplace_back(Field(i * 7919));
+  }
+  auto sharesx = repl.Share(xs, prg);
+  auto sharesy = repl.Share(ys, prg);
+
+  for (int id = 0; id < m; id++) {
+    INFO("party " << id);
+    ShrManipulator manipulator(id, d, m);
+    const ShareBatch a(manipulator.ShareSize(), sharesx[id]);
+    const ShareBatch b(manipulator.ShareSize(), sharesy[id]);
+    REQUIRE(a.ToShares() == sharesx[id]);
+
+    const auto double_batch = manipulator.MultiplyToDoubleDegree(a, b);
+    const auto msgs_batch = manipulator.MultiplyToMsgs(a, b);
+    for (std::size_t i = 0; i < count; i++) {
+      REQUIRE(double_batch.At(i) ==
+              manipulator.MultiplyToDoubleDegree(sharesx[id][i],
+                                                 sharesy[id][i]));
+
+      const auto msgs =
+          manipulator.MultiplyToMsgs(sharesx[id][i], sharesy[id][i]);
+      Shr flat;
+      for (const auto& msg : msgs)
+        flat.insert(flat.end(), msg.begin(), msg.end());
+      REQUIRE(msgs_batch.At(i) == flat);
+    }
+
+    const auto double_size = manipulator.GetDoubleReplicator().ShareSize();
+    std::vector<Shr> dot_msgs(2 * d + 1, Shr(double_size));
+    for (std::size_t i = 0; i < count; i++) {
+      const auto msgs =
+          manipulator.MultiplyToMsgs(sharesx[id][i], sharesy[id][i]);
+      for (std::size_t p = 0; p < msgs.size(); p++)
+        dot_msgs[p] = manipulator.Add(dot_msgs[p], msgs[p]);
+    }
+    REQUIRE(manipulator.DotProductToMsgs(a, b) == dot_msgs);
+  }
+}
+
+TEST_CASE("Local matrix multiplication") {
+  const int m = 7;
+  const int d = (m - 1) / 3;
+  const std::size_t rows = 3, inner = 70, cols = 4;
+  frn::lib::primitives::PRG prg;
+  auto repl = CreateReplicator(m);
+
+  std::vector<Field> xs, ys;
+  for (std::size_t i = 0; i < rows * inner; i++)
+    xs.emplace_back(Field(frn::lib::math::Mp61::kPrime - 1 - i));
+  for (std::size_t i = 0; i < inner * cols; i++)
+    ys.emplace_back(Field(i * 7919));
+  auto sharesx = repl.Share(xs, prg);
+  auto sharesy = repl.Share(ys, prg);
+
+  for (int id = 0; id < m; id++) {
+    INFO("party " << id);
+    ShrManipulator manipulator(id, d, m);
+    const ShareBatch a(manipulator.ShareSize(), sharesx[id]);
+    const ShareBatch b(manipulator.ShareSize(), sharesy[id]);
+    const auto msgs = manipulator.MatMulToMsgs(a, b, rows, inner, cols);
+    REQUIRE(msgs.Size() == rows * cols);
+
+    for (std::size_t i = 0; i < rows; i++) {
+      for (std::size_t j = 0; j < cols; j++) {
+        Shr expected(msgs.ShareSize());
+        for (std::size_t k = 0; k < inner; k++) {
+          const auto entry = manipulator.MultiplyToMsgs(
+              sharesx[id][i * inner + k], sharesy[id][k * cols + j]);
+          Shr flat;
+          for (const auto& msg : entry)
+            flat.insert(flat.end(), msg.begin(), msg.end());
+          expected = manipulator.Add(expected, flat);
+        }
+        REQUIRE(msgs.At(i * cols + j) == expected);
+      }
+    }
+
+    REQUIRE_THROWS_AS(manipulator.MatMulToMsgs(a, b, rows, inner + 1, cols),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("Local squares") {
+  frn::lib::primitives::PRG prg;
+  for (int m : {4, 7, 10}) {
+    const int d = (m - 1) / 3;
+    auto repl = CreateReplicator(m);
+    std::vector<Field> xs;
+    for (std::size_t i = 0; i < 70; i++)
+      xs.emplace_back(Field(frn::lib::math::Mp61::kPrime - 1 - 3 * i));
+    auto shares = repl.Share(xs, prg);
+
+    for (int id = 0; id < m; id++) {
+      INFO("n = " << m << ", party " << id);
+      ShrManipulator manipulator(id, d, m);
+      // mirrored products are combined.
+      const auto& table = manipulator.GetTableMult();
+      std::size_t diagonal = 0;
+      for (const auto& entry : table) diagonal += entry.src_a == entry.src_b;
+      const auto expected = diagonal + (table.size() - diagonal) / 2;
+      REQUIRE(manipulator.GetSquareRowsByParty().src_a.size() == expected);
+      REQUIRE(manipulator.GetSquareRowsByDest().src_a.size() == expected);
+
+      const auto size = manipulator.ShareSize();
+
+      const auto batch = manipulator.SquareToMsgs(ShareBatch(size, shares[id]));
+      for (std::size_t i = 0; i < xs.size(); i++) {
+        const auto& a = shares[id][i];
+        REQUIRE(manipulator.Square(a) ==
+                manipulator.MultiplyToDoubleDegree(a, a));
+        const auto msgs = manipulator.MultiplyToMsgs(a, a);
+        REQUIRE(manipulator.SquareToMsgs(a) == msgs);
+        Shr flat;
+        for (const auto& msg : msgs)
+          flat.insert(flat.end(), msg.begin(), msg.end());
+        REQUIRE(batch.At(i) == flat);
+      }
+    }
+  }
+}
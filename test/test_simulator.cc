@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <thread>
+
+#include "frn/mult.h"
+#include "frn/shr.h"
+#include "frn/simulator.h"
+#include "frn/util.h"
+#include "tcp_network_helper.h"
+
+TEST_CASE("simulated net") {
+  const std::size_t n = 4;
+
+  CREATE_SIMULATED_PARTIES(n);
+
+  // everyone sends 8 bytes to P0, which reads them in two halves.
+  for (std::size_t i = 1; i < n; i++) {
+    BEGIN_PLAYER_DEF(i) {
+      network->SendBytes(0, {'a', 'b', 'c', 'd', 'e', 'f', 'g',
+                             (unsigned char)my_id});
+    }
+    END_PLAYER_DEF(i);
+  }
+
+  bool received_all = true;
+
+  BEGIN_PLAYER_DEF(0) {
+    for (std::size_t i = 1; i < n; i++) {
+      auto r0 = network->RecvBytes(i, 4);
+      auto r1 = network->RecvBytes(i, 4);
+      received_all &= std::vector<unsigned char>{'a', 'b', 'c', 'd'} == r0;
+      received_all &=
+          std::vector<unsigned char>{'e', 'f', 'g', (unsigned char)i} == r1;
+    }
+  }
+  END_PLAYER_DEF(0);
+
+  CLEANUP();
+
+  REQUIRE(received_all);
+}
+
+TEST_CASE("simulated mult") {
+  // there are no multiplication kernels for 5 parties, so Mult uses the
+  // batched table.
+  const std::size_t n = GENERATE(4, 5, 7);
+  const std::size_t d = (n - 1) / 3;
+  const std::size_t m = 10;
+  frn::lib::primitives::PRG prg;
+  auto rep = frn::lib::secret_sharing::Replicator<frn::Field>(n, d);
+
+  std::vector<frn::Field> xs, ys;
+  std::vector<std::vector<frn::Shr>> shr_xs(n), shr_ys(n);
+  for (std::size_t j = 0; j < m; j++) {
+    xs.emplace_back(frn::Field(j + 10));
+    ys.emplace_back(frn::Field(j + 20));
+    auto sx = rep.Share(xs[j], prg);
+    auto sy = rep.Share(ys[j], prg);
+    for (std::size_t i = 0; i < n; i++) {
+      shr_xs[i].emplace_back(sx[i]);
+      shr_ys[i].emplace_back(sy[i]);
+    }
+  }
+
+  std::vector<std::vector<frn::Shr>> output_shares(n);
+
+  frn::Simulator sim(n);
+  sim.Run([&](std::shared_ptr<frn::TcpNetwork> network) {
+    auto id = network->Id();
+    auto corr = frn::Correlator(id, rep);
+    auto mani = frn::ShrManipulator(id, d, n);
+    auto checkdata = frn::CheckData(d);
+    frn::Mult multp(network, rep, mani, corr, checkdata);
+    multp.Prepare(shr_xs[id], shr_ys[id]);
+    output_shares[id] = multp.Run();
+  });
+
+  for (std::size_t j = 0; j < m; j++) {
+    std::vector<frn::Shr> shares;
+    for (std::size_t i = 0; i < n; i++) shares.emplace_back(output_shares[i][j]);
+    REQUIRE(rep.Reconstruct(shares) == xs[j] * ys[j]);
+  }
+}
+
+TEST_CASE("simulated link model") {
+  using namespace std::chrono_literals;
+  using Clock = std::chrono::steady_clock;
+
+  frn::lib::net::LinkModel model;
+  model.latency = 20ms;
+  // 1 MB/s, so 10000 bytes take 10ms to transmit.
+  model.bandwidth = 1000000;
+
+  frn::Simulator sim(4, model);
+
+  Clock::time_point sent;
+  std::chrono::microseconds elapsed;
+
+  std::vector<frn::Simulator::Party> parties(4, [](auto) {});
+  parties[1] = [&](auto network) {
+    sent = Clock::now();
+    network->SendBytes(0, std::vector<unsigned char>(10000, 1));
+  };
+  parties[0] = [&](auto network) {
+    auto r = network->RecvBytes(1, 10000);
+    elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - sent);
+    // messages to self are never delayed.
+    network->SendBytes(0, {1});
+    network->RecvBytes(0, 1);
+  };
+
+  sim.Run(parties);
+
+  REQUIRE(elapsed >= 30ms);
+}
@@ -81,3 +81,269 @@ TEST_CASE("mult") {
   auto w = rep.Reconstruct(output_shares);
   REQUIRE(w == x * y);
 }
+
+TEST_CASE("net mesh") {
+  const std::size_t n = 7;
+
+  CREATE_PARTIES(n, 14000);
+
+  // parties start in reverse order, so most of them dial peers which are not
+  // listening yet.
+  std::vector<int> received_all(n, 1);
+  for (std::size_t k = 0; k < n; k++) {
+    const std::size_t i = n - 1 - k;
+    BEGIN_PLAYER_DEF(i) {
+      for (std::size_t j = 0; j < n; j++)
+        network->SendBytes(j, {(unsigned char)my_id});
+      for (std::size_t j = 0; j < n; j++)
+        received_all[my_id] &= network->RecvBytes(j, 1)[0] == (unsigned char)j;
+    }
+    END_PLAYER_DEF(i);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  CLEANUP();
+
+  for (std::size_t i = 0; i < n; i++) REQUIRE(received_all[i]);
+}
+
+TEST_CASE("net striped") {
+  const std::size_t n = 3;
+  // not a multiple of the segment size, so the last segment is partial.
+  const std::size_t m = 5 * STRIPE_SEGMENT_SIZE + 123;
+
+  auto message = [m](std::size_t sender) {
+    std::vector<unsigned char> data(m);
+    for (std::size_t j = 0; j < m; j++)
+      data[j] = (unsigned char)(j * 7 + sender);
+    return data;
+  };
+
+  std::vector<int> received_all(n, 1);
+  std::vector<std::thread> parties;
+
+  for (std::size_t i = 0; i < n; i++) {
+    parties.emplace_back([&, i]() {
+      auto network =
+          frn::lib::net::Network::Builder()
+              .LocalPeerId(i)
+              .TransportType(frn::lib::net::Network::TransportType::eTcp)
+              .Size(n)
+              .BasePort(15000)
+              .AllPartiesLocal()
+              .StreamsPerPeer(3)
+              .SocketBufferSize(1 << 16)
+              .NoDelay()
+              .Build();
+      network.Connect();
+
+      // a small message first, so the large one does not start at a segment
+      // boundary.
+      auto data = message(i);
+      for (std::size_t j = 0; j < n; j++) {
+        if (j == i) continue;
+        network.SendTo(j, data.data(), 10);
+        network.SendTo(j, data.data(), m);
+      }
+
+      for (std::size_t j = 0; j < n; j++) {
+        if (j == i) continue;
+        std::vector<unsigned char> r(m + 10);
+        // receive in pieces that do not line up with what was sent.
+        network.RecvFrom(j, r.data(), 1000);
+        network.RecvFrom(j, r.data() + 1000, m - 990);
+        received_all[i] &= std::equal(r.begin(), r.begin() + 10,
+                                      message(j).begin());
+        received_all[i] &= std::equal(r.begin() + 10, r.end(),
+                                      message(j).begin());
+      }
+
+      network.Close();
+    });
+  }
+
+  for (auto& party : parties) party.join();
+
+  for (std::size_t i = 0; i < n; i++) REQUIRE(received_all[i]);
+}
+
+TEST_CASE("net sessions") {
+  const std::size_t n = 4;
+  const std::size_t d = (n - 1) / 3;
+  const std::size_t sessions = 3;
+  frn::lib::primitives::PRG prg;
+  auto rep = frn::lib::secret_sharing::Replicator<frn::Field>(n, d);
+
+  std::vector<frn::Field> xs, ys;
+  std::vector<std::vector<frn::Shr>> shr_xs, shr_ys;
+  for (std::size_t s = 0; s < sessions; s++) {
+    xs.emplace_back(frn::Field(s + 10));
+    ys.emplace_back(frn::Field(s + 20));
+    shr_xs.emplace_back(rep.Share(xs[s], prg));
+    shr_ys.emplace_back(rep.Share(ys[s], prg));
+  }
+
+  CREATE_PARTIES(n, 16000);
+
+  std::vector<std::vector<frn::Shr>> output_shares(
+      sessions, std::vector<frn::Shr>(n));
+  std::vector<int> received_all(n, 1);
+
+  for (std::size_t i = 0; i < n; i++) {
+    BEGIN_PLAYER_DEF(i) {
+      network->Multiplex();
+
+      // run a multiplication in each session at the same time.
+      std::vector<std::thread> instances;
+      for (std::size_t s = 0; s < sessions; s++) {
+        instances.emplace_back([&, s]() {
+          auto session = network->Session(s + 1);
+          auto corr = frn::Correlator(my_id, rep);
+          auto mani = frn::ShrManipulator(my_id, d, n);
+          auto checkdata = frn::CheckData(d);
+          frn::Mult multp(session, rep, mani, corr, checkdata);
+          multp.Prepare(shr_xs[s][my_id], shr_ys[s][my_id]);
+          output_shares[s][my_id] = multp.Run()[0];
+        });
+      }
+
+      // meanwhile, the network itself is still usable as session 0.
+      for (std::size_t j = 0; j < n; j++)
+        network->SendBytes(j, {(unsigned char)my_id});
+      for (std::size_t j = 0; j < n; j++)
+        received_all[my_id] &= network->RecvBytes(j, 1)[0] == (unsigned char)j;
+
+      for (auto& instance : instances) instance.join();
+      network->Demultiplex();
+    }
+    END_PLAYER_DEF(i);
+  }
+
+  CLEANUP();
+
+  for (std::size_t i = 0; i < n; i++) REQUIRE(received_all[i]);
+  for (std::size_t s = 0; s < sessions; s++)
+    REQUIRE(rep.Reconstruct(output_shares[s]) == xs[s] * ys[s]);
+}
+
+TEST_CASE("net coalesced") {
+  const std::size_t n = 2;
+  const std::size_t m = 100;
+
+  std::vector<unsigned char> received(3 * m);
+  std::vector<std::thread> parties;
+
+  for (std::size_t i = 0; i < n; i++) {
+    parties.emplace_back([&, i]() {
+      auto network =
+          frn::lib::net::Network::Builder()
+              .LocalPeerId(i)
+              .TransportType(frn::lib::net::Network::TransportType::eTcp)
+              .Size(n)
+              .BasePort(17000)
+              .AllPartiesLocal()
+              .WriteBufferSize(64)
+              .Cork()
+              .Build();
+      network.Connect();
+
+      if (i == 0) {
+        // many small messages, some of which spill over the write buffer.
+        for (std::size_t j = 0; j < m; j++) {
+          unsigned char msg[3] = {(unsigned char)j, 1, 2};
+          network.SendTo(1, msg, 3);
+        }
+        network.Flush();
+      } else {
+        network.RecvFrom(0, received.data(), received.size());
+      }
+
+      network.Close();
+    });
+  }
+
+  for (auto& party : parties) party.join();
+
+  for (std::size_t j = 0; j < m; j++) {
+    REQUIRE(received[3 * j] == (unsigned char)j);
+    REQUIRE(received[3 * j + 1] == 1);
+    REQUIRE(received[3 * j + 2] == 2);
+  }
+}
+
+template <typename T>
+static void check_packed_round_trip(std::size_t size) {
+  frn::lib::primitives::PRG prg;
+  std::vector<T> values;
+  for (std::size_t i = 0; i < size; i++) {
+    unsigned char buffer[T::ByteSize()];
+    prg.Next(buffer, T::ByteSize());
+    // every third value is close to the prime, which sets all the bits.
+    values.emplace_back(i % 3 ? T::FromBytes(buffer) : -T(1 + i));
+  }
+
+  const auto n = frn::lib::math::vector::PackedByteSize<T>(size);
+  REQUIRE(n == (size * T::PackedBitSize() + 7) / 8);
+  std::vector<unsigned char> buffer(n);
+  frn::lib::math::vector::ToPackedBytes(buffer.data(), values);
+  REQUIRE(frn::lib::math::vector::FromPackedBytes<T>(buffer.data(), size) ==
+          values);
+}
+
+TEST_CASE("packed encoding") {
+  using frn::lib::math::FpElement;
+  STATIC_REQUIRE(FpElement<frn::lib::math::Mp31>::PackedBitSize() == 31);
+  STATIC_REQUIRE(FpElement<frn::lib::math::Mp61>::PackedBitSize() == 61);
+  STATIC_REQUIRE(FpElement<frn::lib::math::Mp127>::PackedBitSize() == 127);
+
+  for (std::size_t size : {0, 1, 7, 64, 101}) {
+    check_packed_round_trip<FpElement<frn::lib::math::Mp31>>(size);
+    check_packed_round_trip<FpElement<frn::lib::math::Mp61>>(size);
+    check_packed_round_trip<FpElement<frn::lib::math::Mp127>>(size);
+  }
+}
+
+TEST_CASE("net packed") {
+  const std::size_t n = 4;
+  const std::size_t m = 100;
+
+  frn::lib::primitives::PRG prg;
+  auto replicator = frn::CreateReplicator(n);
+  std::vector<frn::Field> values;
+  for (std::size_t i = 0; i < m; i++)
+    values.emplace_back(-frn::Field(i));
+  auto shares = replicator.Share(frn::Field(123), prg);
+
+  std::vector<frn::Field> received_values;
+  std::vector<frn::Shr> received_shares;
+
+  CREATE_SIMULATED_PARTIES(n);
+  for (auto& network : __networks) network->SetPacked(true);
+
+  BEGIN_PLAYER_DEF(0) {
+    network->Send(1, values);
+    network->SendShares(1, shares);
+  }
+  END_PLAYER_DEF(0);
+
+  BEGIN_PLAYER_DEF(1) {
+    received_values = network->Recv(0, m);
+    received_shares = network->RecvShares(0, shares.size());
+  }
+  END_PLAYER_DEF(1);
+
+  for (std::size_t i = 2; i < n; i++) {
+    BEGIN_PLAYER_DEF(i) {}
+    END_PLAYER_DEF(i);
+  }
+
+  CLEANUP();
+
+  REQUIRE(received_values == values);
+  REQUIRE(received_shares == shares);
+  // 61 bits per element, with each share padded to a whole byte.
+  const auto share_bytes =
+      frn::lib::math::vector::PackedByteSize<frn::Field>(shares[0].size());
+  REQUIRE(__networks[0]->BytesSent() ==
+          (m * 61 + 7) / 8 + shares.size() * share_bytes);
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <thread>
+
+#include "frn/lib/tracing.h"
+#include "frn/mult.h"
+#include "frn/simulator.h"
+
+using Counter = frn::lib::tracing::Counter;
+using Record = frn::lib::tracing::Record;
+
+static const Record* find_span(const std::vector<Record>& records,
+                               const std::string& name) {
+  for (const auto& r : records)
+    if (name == r.name) return &r;
+  return nullptr;
+}
+
+TEST_CASE("tracing spans") {
+  frn::lib::tracing::Reset();
+
+  {
+    TRACE_SPAN("outer");
+    TRACE_COUNT(eElements, 1);
+    {
+      TRACE_SPAN("inner");
+      TRACE_COUNT(eElements, 2);
+      TRACE_COUNT(eBytesSent, 10);
+    }
+  }
+
+  // spans on other threads end up in the same trace.
+  std::thread([]() { TRACE_SPAN("other"); }).join();
+
+  auto records = frn::lib::tracing::Collect();
+  REQUIRE(records.size() == 3);
+
+  auto outer = find_span(records, "outer");
+  auto inner = find_span(records, "inner");
+  auto other = find_span(records, "other");
+  REQUIRE(outer);
+  REQUIRE(inner);
+  REQUIRE(other);
+
+  REQUIRE(outer->depth == 0);
+  REQUIRE(inner->depth == 1);
+  REQUIRE(outer->begin <= inner->begin);
+  REQUIRE(inner->end <= outer->end);
+  REQUIRE(other->thread != outer->thread);
+
+  // counters of nested spans add up.
+  REQUIRE(inner->Get(Counter::eElements) == 2);
+  REQUIRE(outer->Get(Counter::eElements) == 3);
+  REQUIRE(outer->Get(Counter::eBytesSent) == 10);
+
+  std::stringstream csv;
+  frn::lib::tracing::WriteCsv(csv, records);
+  std::string header;
+  std::getline(csv, header);
+  REQUIRE(header ==
+          "thread,depth,name,start_us,duration_us,bytes_sent,bytes_received,"
+          "elements,rounds");
+
+  std::stringstream json;
+  frn::lib::tracing::WriteChromeTrace(json, records, 3);
+  REQUIRE(json.str().find("\"name\":\"inner\"") != std::string::npos);
+  REQUIRE(json.str().find("\"pid\":3") != std::string::npos);
+
+  frn::lib::tracing::Reset();
+  REQUIRE(frn::lib::tracing::Collect().empty());
+}
+
+TEST_CASE("tracing mult") {
+  const std::size_t n = 4;
+  const std::size_t d = 1;
+  const std::size_t m = 5;
+  frn::lib::primitives::PRG prg;
+  auto rep = frn::lib::secret_sharing::Replicator<frn::Field>(n, d);
+  auto shr_x = rep.Share(frn::Field(2), prg);
+
+  frn::lib::tracing::Reset();
+
+  frn::Simulator sim(n);
+  sim.Run([&](std::shared_ptr<frn::TcpNetwork> network) {
+    auto id = network->Id();
+    auto corr = frn::Correlator(id, rep);
+    auto mani = frn::ShrManipulator(id, d, n);
+    auto checkdata = frn::CheckData(d);
+    frn::Mult multp(network, rep, mani, corr, checkdata);
+    for (std::size_t j = 0; j < m; j++) multp.Prepare(shr_x[id], shr_x[id]);
+    multp.Run();
+  });
+
+  auto records = frn::lib::tracing::Collect();
+  std::size_t runs = 0;
+  for (const auto& r : records) {
+    if (std::string("Mult::Run") != r.name) continue;
+    runs++;
+    REQUIRE(r.Get(Counter::eElements) == m);
+    // everyone but the king sends its share and receives the result.
+    if (r.Get(Counter::eBytesSent) < r.Get(Counter::eBytesReceived))
+      REQUIRE(r.Get(Counter::eRounds) == 1);
+  }
+  REQUIRE(runs == n);
+}
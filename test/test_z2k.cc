@@ -0,0 +1,124 @@
+#include <catch2/catch.hpp>
+
+#include "frn/lib/math/galois.h"
+#include "frn/lib/math/z2k.h"
+#include "frn/shr.h"
+
+using Z64 = frn::lib::math::Z2kElement<64>;
+using Z32 = frn::lib::math::Z2kElement<32>;
+using GR = frn::lib::math::GaloisRingElement<64, 32>;
+
+template <typename T>
+static T random_element(frn::lib::primitives::PRG& prg) {
+  unsigned char buffer[T::ByteSize()];
+  prg.Next(buffer, T::ByteSize());
+  return T::FromBytes(buffer);
+}
+
+TEST_CASE("Z2k arithmetic") {
+  REQUIRE(Z64(~0ULL) + Z64(2) == Z64(1));
+  REQUIRE(Z64(0) - Z64(1) == Z64(~0ULL));
+  REQUIRE(Z32(1ULL << 32) == Z32(0));
+  REQUIRE(Z32(0xFFFFFFFF) * Z32(0xFFFFFFFF) == Z32(1));
+  REQUIRE(-Z32(1) == Z32(0xFFFFFFFF));
+
+  frn::lib::primitives::PRG prg;
+  for (int i = 0; i < 100; i++) {
+    auto x = random_element<Z64>(prg);
+    x += Z64((x.Value() & 1) ^ 1);
+    REQUIRE(x * x.Inverse() == Z64::kOne);
+    auto y = random_element<Z32>(prg);
+    y += Z32((y.Value() & 1) ^ 1);
+    REQUIRE(y * y.Inverse() == Z32::kOne);
+  }
+  REQUIRE_THROWS_AS(Z64(6).Inverse(), std::logic_error);
+}
+
+TEST_CASE("Galois ring arithmetic") {
+  frn::lib::primitives::PRG prg;
+  for (int i = 0; i < 20; i++) {
+    auto a = random_element<GR>(prg);
+    auto b = random_element<GR>(prg);
+    auto c = random_element<GR>(prg);
+    REQUIRE(a * b == b * a);
+    REQUIRE((a * b) * c == a * (b * c));
+    REQUIRE(a * (b + c) == a * b + a * c);
+    REQUIRE(a * GR::kOne == a);
+  }
+
+  // x^32 = -(x^7 + x^3 + x^2 + 1).
+  std::array<Z64, 32> x{};
+  x[1] = Z64(1);
+  GR power = GR::kOne;
+  for (int i = 0; i < 32; i++) power *= GR(x);
+  std::array<Z64, 32> expected{};
+  for (auto j : {0, 2, 3, 7}) expected[j] = -Z64::kOne;
+  REQUIRE(power == GR(expected));
+
+  // constants multiply as in Z_{2^64}.
+  REQUIRE(GR(Z64(3)) * GR(Z64(5)) == GR(Z64(15)));
+}
+
+TEST_CASE("Galois ring coefficients detect errors") {
+  // a random linear combination of errors. Coefficients from Z_{2^64} miss an
+  // error of 2^63 whenever they are even, while coefficients from the Galois
+  // ring miss it with probability 2^-32.
+  frn::lib::primitives::PRG prg;
+  const Z64 error(1ULL << 63);
+  int missed_z2k = 0;
+  int missed_gr = 0;
+  for (int i = 0; i < 64; i++) {
+    missed_z2k += random_element<Z64>(prg) * error == Z64::kZero;
+    missed_gr += random_element<GR>(prg) * GR(error) == GR::kZero;
+  }
+  REQUIRE(missed_z2k > 0);
+  REQUIRE(missed_gr == 0);
+}
+
+TEST_CASE("Replicated multiplication over Z2k") {
+  const int n = 7;
+  const int d = (n - 1) / 3;
+  frn::lib::primitives::PRG prg;
+  frn::lib::secret_sharing::Replicator<Z64> replicator(n, d);
+  frn::lib::secret_sharing::Replicator<Z64> double_replicator(n, 2 * d);
+
+  const Z64 x(~0ULL - 5), y(1ULL << 40);
+  auto sharesx = replicator.Share(x, prg);
+  auto sharesy = replicator.Share(y, prg);
+  REQUIRE(replicator.Reconstruct(sharesx) == x);
+
+  std::vector<std::vector<Z64>> sharesz;
+  for (int i = 0; i < n; i++) {
+    const frn::BasicShrManipulator<Z64> manipulator(i, d, n);
+    sharesz.emplace_back(
+        manipulator.MultiplyToDoubleDegree(sharesx[i], sharesy[i]));
+  }
+  REQUIRE(double_replicator.Reconstruct(sharesz) == x * y);
+}
+
+TEST_CASE("Sampling ring elements") {
+  static_assert(!frn::lib::primitives::details::OverPrimeField<GR>::value);
+  static_assert(frn::lib::primitives::details::OverPrimeField<
+                frn::Field>::value);
+
+  frn::lib::primitives::PRG prg;
+  std::vector<Z32> small(1000);
+  prg.NextElements(small);
+  std::size_t high_bit = 0;
+  for (const auto& x : small) {
+    REQUIRE(x.Value() <= 0xFFFFFFFF);
+    high_bit += x.Value() >> 31;
+  }
+  // about half of the elements have the top bit set.
+  REQUIRE(high_bit > 400);
+  REQUIRE(high_bit < 600);
+
+  // a Galois ring element is as random as its bytes.
+  frn::lib::primitives::PRG a, b;
+  std::vector<GR> challenges(4);
+  a.NextElements(challenges);
+  for (const auto& c : challenges) {
+    REQUIRE(c == random_element<GR>(b));
+    REQUIRE(c.IsUnit());
+  }
+}